@@ -0,0 +1,26 @@
+// Separable blur, one direction per pass, drawn at reduced resolution
+
+uniform sampler2D source;
+
+uniform vec2 texelSize;
+uniform vec2 direction;
+
+// "glsl-fast-gaussian-blur" by "Jam3"
+void main()
+{
+	vec2 uv = gl_TexCoord[0].xy;
+	vec2 off1 = vec2(1.411764705882353) * direction * texelSize;
+	vec2 off2 = vec2(3.2941176470588234) * direction * texelSize;
+	vec2 off3 = vec2(5.176470588235294) * direction * texelSize;
+	
+	vec4 color = vec4(0.0);
+	color += texture2D(source, uv) * 0.1964825501511404;
+	color += texture2D(source, uv + off1) * 0.2969069646728344;
+	color += texture2D(source, uv - off1) * 0.2969069646728344;
+	color += texture2D(source, uv + off2) * 0.09447039785044732;
+	color += texture2D(source, uv - off2) * 0.09447039785044732;
+	color += texture2D(source, uv + off3) * 0.010381362401148057;
+	color += texture2D(source, uv - off3) * 0.010381362401148057;
+	
+	gl_FragColor = color;
+}
\ No newline at end of file
@@ -1,6 +1,5 @@
 uniform mat4 mWorld;
-uniform mat4 mView;
-uniform mat4 mProj;
+uniform mat4 mWorldViewProj;
 
 uniform vec3 lookAt;
 uniform float fadeWhenFar;
@@ -14,6 +13,6 @@ void main()
 	float d = clamp((distance(lookAt, position.xyz) - 20) / 100, 0, 1);
 	dalpha = mix(1.0 - d, d, fadeWhenFar);
 	
-	gl_Position = mProj * mView * position;
+	gl_Position = mWorldViewProj * gl_Vertex;
 	gl_TexCoord[0] = gl_MultiTexCoord0;
 }
@@ -0,0 +1,26 @@
+#define WAVE_VALUE 0.02 // Red
+
+// Post processing mask, at full resolution
+uniform sampler2D source;
+
+float inRange(float x, float y)
+{
+	return step(y - 0.01, x) - step(y + 0.01, x);
+}
+
+// Dilate heat wave mask, so the final pass needs a single sample
+void main()
+{
+	vec2 coord = gl_TexCoord[0].xy;
+	float radius = 0.005;
+	
+	float center = texture2D(source, coord).r;
+	float up = texture2D(source, clamp(coord + vec2(0.0, radius), vec2(0), vec2(1))).r;
+	float down = texture2D(source, clamp(coord - vec2(0.0, radius), vec2(0), vec2(1))).r;
+	float left = texture2D(source, clamp(coord - vec2(radius, 0), vec2(0), vec2(1))).r;
+	float right = texture2D(source, clamp(coord + vec2(radius, 0), vec2(0), vec2(1))).r;
+	
+	float factor = inRange(center, WAVE_VALUE) + inRange(up, WAVE_VALUE) + inRange(down, WAVE_VALUE) + inRange(left, WAVE_VALUE) + inRange(right, WAVE_VALUE);
+	
+	gl_FragColor = vec4(factor / 5.0, 0.0, 0.0, 1.0);
+}
\ No newline at end of file
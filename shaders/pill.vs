@@ -1,8 +1,7 @@
 varying vec4 positionToWorld;
 
 uniform mat4 mWorld;
-uniform mat4 mView;
-uniform mat4 mProj;
+uniform mat4 mWorldViewProj;
 
 void main()
 {
@@ -10,7 +9,7 @@ void main()
 	positionToWorld = mWorld * gl_Vertex;
 	
 	// Compute final vertex position
-	gl_Position = mProj * mView * positionToWorld;
+	gl_Position = mWorldViewProj * gl_Vertex;
 	
 	// Assign texture coordinates
 	gl_TexCoord[0] = gl_MultiTexCoord0;
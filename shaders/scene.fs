@@ -5,12 +5,11 @@
 uniform sampler2D guiRtt;
 uniform sampler2D colorRtt;
 uniform sampler2D ppRtt;
+uniform sampler2D heatRtt;
 
-uniform vec2 resolution;
 uniform float time;
 uniform float waveStrength;
 uniform vec3 ripplePoint;
-uniform float blurFactor;
 
 // Here goes the basic functions
 
@@ -66,40 +65,6 @@ vec2 ripple(vec2 tc, vec3 point, float factor)
 	return clamp(x, 0.001, 0.999);
 }
 
-float getHeatWaveFactor(sampler2D mask, vec2 coord, float radius)
-{
-	float center = texture2D(mask, coord).r;
-	float up = texture2D(mask, clamp(coord + vec2(0.0, radius), vec2(0), vec2(1))).r;
-	float down = texture2D(mask, clamp(coord - vec2(0.0, radius), vec2(0), vec2(1))).r;
-	float left = texture2D(mask, clamp(coord - vec2(radius, 0), vec2(0), vec2(1))).r;
-	float right = texture2D(mask, clamp(coord + vec2(radius, 0), vec2(0), vec2(1))).r;
-	
-	center = inRange(center, WAVE_VALUE);
-	up = inRange(up, WAVE_VALUE);
-	down = inRange(down, WAVE_VALUE);
-	left = inRange(left, WAVE_VALUE);
-	right = inRange(right, WAVE_VALUE);
-	
-	return (center + up + down + left + right) / 5.0;
-}
-
-// "glsl-fast-gaussian-blur" by "Jam3"
-vec4 blur13(sampler2D image, vec2 uv, vec2 direction)
-{
-	vec4 color = vec4(0.0);
-	vec2 off1 = vec2(1.411764705882353) * direction;
-	vec2 off2 = vec2(3.2941176470588234) * direction;
-	vec2 off3 = vec2(5.176470588235294) * direction;
-	color += texture2D(image, uv) * 0.1964825501511404;
-	color += texture2D(image, uv + (off1 / resolution)) * 0.2969069646728344;
-	color += texture2D(image, uv - (off1 / resolution)) * 0.2969069646728344;
-	color += texture2D(image, uv + (off2 / resolution)) * 0.09447039785044732;
-	color += texture2D(image, uv - (off2 / resolution)) * 0.09447039785044732;
-	color += texture2D(image, uv + (off3 / resolution)) * 0.010381362401148057;
-	color += texture2D(image, uv - (off3 / resolution)) * 0.010381362401148057;
-	return color;
-}
-
 // Here goes game-specific functions
 
 float getTimeRippleFactor(float t)
@@ -116,32 +81,29 @@ float getTimeRippleFactor(float t)
 	return cubicBezier(vec3(0), vec3(1, 0.03, 0), vec3(0.38, 0.04, 0), vec3(1), tr).y;
 }
 
-// Here goes the main method
+// Here goes the main method. Effects are enabled by the defines of the program variant,
+// so frames without effects only read the scene color and the GUI.
 
 void main()
 {
+	vec2 coord = gl_TexCoord[0].xy;
+	
 	// Apply wave effect
-	vec2 coord;
-	if (waveStrength < 0.00001)
-	{
-		coord = gl_TexCoord[0].xy;
-	}
-	else
-	{
-		coord = sineWave(gl_TexCoord[0].xy, 1.0, waveStrength, 1.0, time);
-	}
+	#ifdef WAVE
+	coord = sineWave(coord, 1.0, waveStrength, 1.0, time);
+	#endif
 	
 	// Apply ripple
+	#ifdef RIPPLE
 	{
 		float factor = getTimeRippleFactor(ripplePoint.z);
 		coord = ripple(coord, ripplePoint, factor);
 	}
-	
-	// Get post processing mask for the fragment
-	vec4 pp = texture2D(ppRtt, coord);
+	#endif
 	
 	/* Pre-scene processing */
 	
+	#ifdef EFFECT_MASK
 	// Avoid PP if necessary
 	float amplify;
 	{
@@ -151,7 +113,7 @@ void main()
 	
 	// Heat wave
 	{
-		float factor = getHeatWaveFactor(ppRtt, coord, 0.005) * 0.25;
+		float factor = texture2D(heatRtt, coord).r * 0.25;
 		coord = sineWave(coord, 2.0, 0.01, factor * amplify, time);
 	}
 	
@@ -161,16 +123,11 @@ void main()
 		float factor = inRange(color.r, GLASS_VALUE);
 		coord = sineWave(coord, 20.0, 0.01, factor * color.b * amplify, 0);
 	}
+	#endif
 
-	// Apply texture for the fragment
+	// Apply texture for the fragment, which is already blurred while the game is paused
 	vec4 color = texture2D(colorRtt, coord);
 	
-	// Apply pause-screen blur
-	if (blurFactor > 0.0001)
-	{
-		color = blur13(colorRtt, coord, vec2(blurFactor));
-	}
-	
 	// Overlap GUI
 	vec4 gui = texture2D(guiRtt, coord);
 	vec4 finalColor = mix(color, gui, gui.a);
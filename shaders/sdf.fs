@@ -0,0 +1,14 @@
+// Glyphs of the signed distance field font. Alpha holds the distance from the glyph outline, remapped so the outline is at 0.5
+
+uniform sampler2D tex;
+
+void main()
+{
+	float distance = texture2D(tex, gl_TexCoord[0].xy).a;
+
+	// Anti-aliasing width follows the screen space size of the glyph, so the same atlas works at every resolution
+	float width = max(fwidth(distance) * 0.75, 0.001);
+	float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+
+	gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * alpha);
+}
\ No newline at end of file
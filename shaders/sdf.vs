@@ -0,0 +1,8 @@
+// Screen space glyphs of the signed distance field font, whose positions are already in clip space
+
+void main()
+{
+	gl_Position = gl_Vertex;
+	gl_TexCoord[0] = gl_MultiTexCoord0;
+	gl_FrontColor = gl_Color;
+}
\ No newline at end of file
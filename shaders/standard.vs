@@ -1,6 +1,6 @@
 uniform mat4 mWorld;
-uniform mat4 mView;
-uniform mat4 mProj;
+uniform mat4 mWorldView;
+uniform mat4 mWorldViewProj;
 
 uniform bool useNormalMap;
 uniform vec3 eyePos;
@@ -16,9 +16,9 @@ varying float lightDist;
 void main()
 {
 	vec4 modelSpaceVertex = mWorld * gl_Vertex;
-	mat4 modelView = mView * mWorld;
+	mat4 modelView = mWorldView;
 
-	gl_Position = mProj * mView * modelSpaceVertex;
+	gl_Position = mWorldViewProj * gl_Vertex;
 	gl_TexCoord[0] = gl_MultiTexCoord0;	
 	vertexColor = gl_Color;
 	
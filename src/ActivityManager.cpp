@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include "ActivityManager.h"
+#include "GameObject.h"
+
+const f32 ActivityManager::DEFAULT_RADIUS = 400.0f;
+const f32 ActivityManager::SLEEP_FACTOR = 1.25f;
+const f32 ActivityManager::CELL_SIZE = 200.0f;
+
+bool ActivityManager::WakeOrder::operator()(const Wake& a, const Wake& b) const
+{
+	return a.time > b.time || (a.time == b.time && a.sequence > b.sequence);
+}
+
+ActivityManager::ActivityManager()
+{
+	sleepers = std::make_unique<SpatialHash>(CELL_SIZE);
+	radius = DEFAULT_RADIUS;
+	clear();
+}
+
+bool ActivityManager::isOutside(const vector3df& position, const vector3df& center, const f32 radius)
+{
+	return std::abs(position.X - center.X) > radius || std::abs(position.Y - center.Y) > radius;
+}
+
+void ActivityManager::sleep(const std::shared_ptr<GameObject>& gameObject, const f32 wakeDelay, const f32 tickDelta)
+{
+	// Models keep the state of the last draw while sleeping, so bring them up to date
+	gameObject->snapDrawPosition();
+	gameObject->draw();
+
+	// Mark sleeping since the beginning of this tick
+	gameObject->activity.sleeping = true;
+	gameObject->activity.time = time;
+	gameObject->activity.tick = tick;
+
+	// Register its position, to be found when the center comes near
+	const vector3df point(gameObject->position.X, gameObject->position.Y, 0.0f);
+	sleepers->insert(gameObject);
+	sleepers->update(gameObject.get(), aabbox3df(point, point));
+
+	// Schedule wake a tick early, since timers of game objects are rounded differently by their own steps
+	if (wakeDelay >= 0.0f)
+	{
+		Wake wake;
+		wake.time = time + wakeDelay - tickDelta;
+		wake.sequence = gameObject->activity.sequence;
+		wake.gameObject = gameObject;
+		wake.token = gameObject->activity.wakeToken;
+		wakes.push(wake);
+	}
+
+	gameObject->onSleep();
+}
+
+void ActivityManager::wake(const std::shared_ptr<GameObject>& gameObject, const f32 tickDelta)
+{
+	if (!gameObject->activity.sleeping)
+	{
+		return;
+	}
+
+	// Outdate scheduled wakes
+	gameObject->activity.sleeping = false;
+	++gameObject->activity.wakeToken;
+	sleepers->remove(gameObject.get());
+
+	// Catch up on the ticks which have been skipped, each one lasting as the current one
+	gameObject->deltaTime = tickDelta;
+	gameObject->onWake((f32)(time - gameObject->activity.time), tick - gameObject->activity.tick);
+
+	woken.push_back(gameObject);
+	++wakeCount;
+}
+
+void ActivityManager::setRadius(const f32 radius)
+{
+	this->radius = radius;
+}
+
+f32 ActivityManager::getRadius()
+{
+	return radius;
+}
+
+void ActivityManager::add(const std::shared_ptr<GameObject>& gameObject)
+{
+	gameObject->activity.sequence = nextSequence++;
+	gameObject->activity.sleeping = false;
+	awakeGameObjects.push_back(gameObject);
+}
+
+void ActivityManager::update(const vector3df& center, const f32 tickDelta)
+{
+	// Put far game objects to sleep, unless they have to be updated during the next ticks anyway
+	const f32 sleepRadius = radius * SLEEP_FACTOR;
+	size_t kept = 0;
+
+	for (size_t i = 0; i < awakeGameObjects.size(); ++i)
+	{
+		const std::shared_ptr<GameObject> gameObject = awakeGameObjects[i];
+
+		if (!gameObject->destroy && gameObject->canSleep() && isOutside(gameObject->position, center, sleepRadius))
+		{
+			const f32 wakeDelay = gameObject->getWakeDelay();
+			if (wakeDelay < 0.0f || wakeDelay > tickDelta * 2.0f)
+			{
+				sleep(gameObject, wakeDelay, tickDelta);
+				continue;
+			}
+		}
+
+		awakeGameObjects[kept++] = gameObject;
+	}
+	awakeGameObjects.resize(kept);
+
+	// Wake sleeping game objects which came near
+	woken.clear();
+	wakeCount = 0;
+	scheduledWakeCount = 0;
+
+	candidates.clear();
+	sleepers->query(aabbox3df(center.X - radius, center.Y - radius, -1.0f, center.X + radius, center.Y + radius, 1.0f), candidates);
+
+	merged.clear();
+	for (const SpatialHash::Entry* entry : candidates)
+	{
+		merged.push_back(entry->gameObject);
+	}
+	for (const std::shared_ptr<GameObject>& gameObject : merged)
+	{
+		wake(gameObject, tickDelta);
+	}
+
+	// Wake sleeping game objects whose schedule is due before the end of this tick
+	while (wakes.size() > 0 && wakes.top().time <= time + tickDelta)
+	{
+		const Wake wake = wakes.top();
+		wakes.pop();
+
+		const std::shared_ptr<GameObject> gameObject = wake.gameObject.lock();
+		if (gameObject != nullptr && gameObject->activity.sleeping && gameObject->activity.wakeToken == wake.token)
+		{
+			this->wake(gameObject, tickDelta);
+			++scheduledWakeCount;
+		}
+	}
+
+	// Merge woken game objects into the awake ones, following room order
+	if (woken.size() > 0)
+	{
+		const auto& order = [](const std::shared_ptr<GameObject>& a, const std::shared_ptr<GameObject>& b)
+		{
+			return a->activity.sequence < b->activity.sequence;
+		};
+
+		std::sort(woken.begin(), woken.end(), order);
+
+		merged.clear();
+		std::merge(awakeGameObjects.begin(), awakeGameObjects.end(), woken.begin(), woken.end(), std::back_inserter(merged), order);
+		std::swap(awakeGameObjects, merged);
+		merged.clear();
+		woken.clear();
+	}
+
+	// Advance to the next tick
+	time += tickDelta;
+	++tick;
+}
+
+void ActivityManager::remove(GameObject* gameObject)
+{
+	if (gameObject->activity.sleeping)
+	{
+		gameObject->activity.sleeping = false;
+		sleepers->remove(gameObject);
+	}
+}
+
+void ActivityManager::compact()
+{
+	const auto& iterator = std::remove_if(awakeGameObjects.begin(), awakeGameObjects.end(), [](const std::shared_ptr<GameObject>& gameObject)
+	{
+		return gameObject->destroy;
+	});
+	awakeGameObjects.erase(iterator, awakeGameObjects.end());
+}
+
+void ActivityManager::clear()
+{
+	time = 0.0;
+	tick = 0;
+	nextSequence = 0;
+	awakeGameObjects.clear();
+	sleepers->clear();
+	wakes = std::priority_queue<Wake, std::vector<Wake>, WakeOrder>();
+	woken.clear();
+	merged.clear();
+	candidates.clear();
+	wakeCount = 0;
+	scheduledWakeCount = 0;
+}
+
+std::vector<std::shared_ptr<GameObject>>& ActivityManager::getAwakeGameObjects()
+{
+	return awakeGameObjects;
+}
+
+u32 ActivityManager::getAwakeCount()
+{
+	return (u32)awakeGameObjects.size();
+}
+
+u32 ActivityManager::getSleepingCount()
+{
+	return sleepers->getEntryCount();
+}
+
+u32 ActivityManager::getWakeCount()
+{
+	return wakeCount;
+}
+
+u32 ActivityManager::getScheduledWakeCount()
+{
+	return scheduledWakeCount;
+}
\ No newline at end of file
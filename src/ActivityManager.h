@@ -0,0 +1,134 @@
+#ifndef ACTIVITYMANAGER_H
+#define ACTIVITYMANAGER_H
+
+#include <memory>
+#include <queue>
+#include <vector>
+#include <irrlicht.h>
+
+#include "SpatialHash.h"
+
+using namespace irr;
+using namespace core;
+
+class GameObject;
+
+class ActivityManager
+{
+protected:
+
+	// Structure for a scheduled wake of a sleeping game object
+	struct Wake
+	{
+		f64 time;
+		u32 sequence;
+		std::weak_ptr<GameObject> gameObject;
+		u32 token;
+	};
+
+	// Order of scheduled wakes, where the earliest one is on top, following room order on equal times
+	struct WakeOrder
+	{
+		bool operator()(const Wake& a, const Wake& b) const;
+	};
+
+	// Default distance from the camera within which game objects are awake, in world units per axis
+	static const f32 DEFAULT_RADIUS;
+
+	// Awake game objects are put to sleep a bit farther than the radius, so they don't switch at every tick
+	static const f32 SLEEP_FACTOR;
+
+	// Size of the cells of the broadphase for sleeping game objects
+	static const f32 CELL_SIZE;
+
+	// Distance from the camera within which game objects are awake
+	f32 radius;
+
+	// Simulated time and ticks at the beginning of the current tick
+	f64 time;
+	u32 tick;
+
+	// Sequence for the next added game object, which follows room order
+	u32 nextSequence;
+
+	// Awake game objects, in room order
+	std::vector<std::shared_ptr<GameObject>> awakeGameObjects;
+
+	// Sleeping game objects, by their position
+	std::unique_ptr<SpatialHash> sleepers;
+
+	// Scheduled wakes, including outdated ones which are skipped by their token
+	std::priority_queue<Wake, std::vector<Wake>, WakeOrder> wakes;
+
+	// Game objects woken by the running update, the awake ones being merged with them, and the sleepers found near the center
+	std::vector<std::shared_ptr<GameObject>> woken;
+	std::vector<std::shared_ptr<GameObject>> merged;
+	std::vector<const SpatialHash::Entry*> candidates;
+
+	// Counters
+	u32 wakeCount;
+	u32 scheduledWakeCount;
+
+	// Check if a position is outside of the square of the given radius around the center
+	static bool isOutside(const vector3df& position, const vector3df& center, const f32 radius);
+
+	// Put an awake game object to sleep
+	void sleep(const std::shared_ptr<GameObject>& gameObject, const f32 wakeDelay, const f32 tickDelta);
+
+	// Wake a sleeping game object up, letting it catch up, then keep it to be merged into the awake ones
+	void wake(const std::shared_ptr<GameObject>& gameObject, const f32 tickDelta);
+
+public:
+
+	// Constructor
+	ActivityManager();
+
+	// Set the distance from the camera within which game objects are awake, in world units per axis
+	void setRadius(const f32 radius);
+
+	// Get the distance from the camera within which game objects are awake
+	f32 getRadius();
+
+	/**
+		Add an awake game object, which must be the last one of the room.
+
+		@param gameObject the game object.
+	*/
+	void add(const std::shared_ptr<GameObject>& gameObject);
+
+	/**
+		Put the game objects which are far from the center to sleep, then wake the sleeping ones which
+		came near or whose scheduled wake is due during this tick. It must be called once per tick,
+		before any update, so sleeping time is measured in whole ticks.
+
+		@param center the center of the activity region, such as the point the camera looks at.
+		@param tickDelta the duration of the current tick.
+	*/
+	void update(const vector3df& center, const f32 tickDelta);
+
+	// Forget a destroyed game object, if it is sleeping
+	void remove(GameObject* gameObject);
+
+	// Drop the destroyed game objects from the awake ones, keeping their order
+	void compact();
+
+	// Remove all of the game objects, so a new room can be added
+	void clear();
+
+	// Get the awake game objects, in room order. Game objects added during an update are appended
+	std::vector<std::shared_ptr<GameObject>>& getAwakeGameObjects();
+
+	// Amount of awake game objects
+	u32 getAwakeCount();
+
+	// Amount of sleeping game objects
+	u32 getSleepingCount();
+
+	// Amount of game objects woken by the last update
+	u32 getWakeCount();
+
+	// Amount of game objects woken by their schedule during the last update
+	u32 getScheduledWakeCount();
+};
+
+#endif // ACTIVITYMANAGER_H
\ No newline at end of file
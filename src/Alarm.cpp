@@ -15,7 +15,20 @@ void Alarm::stepDecrement(f32 deltaTime)
 	currentTime -= deltaTime;
 }
 
+void Alarm::stepDecrement(f32 deltaTime, u32 steps)
+{
+	for (u32 i = 0; i < steps; ++i)
+	{
+		currentTime -= deltaTime;
+	}
+}
+
 bool Alarm::isTriggered()
 {
 	return currentTime < 0;
+}
+
+f32 Alarm::getTime()
+{
+	return currentTime;
 }
\ No newline at end of file
@@ -21,8 +21,14 @@ public:
 	// Decrement by
 	void stepDecrement(f32 deltaTime);
 
+	// Decrement by the same amount many times, with the same rounding of single steps
+	void stepDecrement(f32 deltaTime, u32 steps);
+
 	// Is triggered
 	bool isTriggered();
+
+	// Time left before triggering
+	f32 getTime();
 };
 
 #endif // ALARM_H
\ No newline at end of file
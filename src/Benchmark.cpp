@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+#include "Benchmark.h"
+#include "Engine.h"
+#include "MaterialCache.h"
+#include "RoomManager.h"
+#include "SharedData.h"
+
+Benchmark::Benchmark()
+{
+	// Default settings
+	frames = 1000;
+	frameTime = 1000.0f / SimulationClock::DEFAULT_TICK_RATE;
+	driverType = EDT_NULL;
+	windowSize = dimension2du(1280, 720);
+	broadphase = false;
+	activityRadius = -1.0f;
+}
+
+bool Benchmark::parseArguments(int argc, char** argv)
+{
+	for (s32 i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--benchmark" && hasValue)
+		{
+			roomName = argv[++i];
+		}
+		else if (arg == "--broadphase")
+		{
+			broadphase = true;
+		}
+		else if (arg == "--frames" && hasValue)
+		{
+			frames = (u32)std::atoi(argv[++i]);
+		}
+		else if (arg == "--delta" && hasValue)
+		{
+			frameTime = (f32)std::atof(argv[++i]);
+		}
+		else if (arg == "--driver" && hasValue)
+		{
+			const std::string driver = argv[++i];
+			driverType = driver == "software" ? EDT_BURNINGSVIDEO : EDT_NULL;
+		}
+		else if (arg == "--size" && hasValue)
+		{
+			u32 width, height;
+			if (std::sscanf(argv[++i], "%ux%u", &width, &height) == 2)
+			{
+				windowSize = dimension2du(width, height);
+			}
+		}
+		else if (arg == "--input" && hasValue)
+		{
+			inputPath = argv[++i];
+		}
+		else if (arg == "--activity-radius" && hasValue)
+		{
+			activityRadius = (f32)std::atof(argv[++i]);
+		}
+	}
+
+	return roomName.length() > 0 || broadphase;
+}
+
+bool Benchmark::loadInput()
+{
+	// Key names accepted in place of codes
+	static const std::unordered_map<std::string, EKEY_CODE> keyNames = {
+		{ "left", KEY_LEFT },
+		{ "right", KEY_RIGHT },
+		{ "up", KEY_UP },
+		{ "down", KEY_DOWN },
+		{ "return", KEY_RETURN },
+		{ "space", KEY_SPACE },
+		{ "escape", KEY_ESCAPE }
+	};
+
+	std::ifstream input(inputPath);
+	if (!input.is_open())
+	{
+		return false;
+	}
+
+	// Parse one event per line
+	std::string line;
+	while (std::getline(input, line))
+	{
+		if (line.length() == 0 || line[0] == '#')
+		{
+			continue;
+		}
+
+		std::istringstream stream(line);
+		InputEvent inputEvent;
+		std::string type;
+		stream >> inputEvent.frame >> type;
+
+		SEvent& event = inputEvent.event;
+		if (type == "key")
+		{
+			std::string code, state;
+			stream >> code >> state;
+
+			const auto& iterator = keyNames.find(code);
+			event.EventType = EET_KEY_INPUT_EVENT;
+			event.KeyInput.Key = iterator != keyNames.end() ? iterator->second : (EKEY_CODE)std::stoi(code, nullptr, 0);
+			event.KeyInput.PressedDown = state == "down";
+			event.KeyInput.Char = 0;
+			event.KeyInput.Shift = false;
+			event.KeyInput.Control = false;
+		}
+		else if (type == "mouse" || type == "lmb" || type == "rmb")
+		{
+			event.EventType = EET_MOUSE_INPUT_EVENT;
+			event.MouseInput.X = 0;
+			event.MouseInput.Y = 0;
+			event.MouseInput.Wheel = 0.0f;
+			event.MouseInput.ButtonStates = 0;
+			event.MouseInput.Shift = false;
+			event.MouseInput.Control = false;
+
+			if (type == "mouse")
+			{
+				event.MouseInput.Event = EMIE_MOUSE_MOVED;
+				stream >> event.MouseInput.X >> event.MouseInput.Y;
+			}
+			else
+			{
+				std::string state;
+				stream >> state;
+
+				const bool down = state == "down";
+				if (type == "lmb")
+				{
+					event.MouseInput.Event = down ? EMIE_LMOUSE_PRESSED_DOWN : EMIE_LMOUSE_LEFT_UP;
+				}
+				else
+				{
+					event.MouseInput.Event = down ? EMIE_RMOUSE_PRESSED_DOWN : EMIE_RMOUSE_LEFT_UP;
+				}
+			}
+		}
+		else
+		{
+			printf("Benchmark - Unknown input event '%s'\n", line.c_str());
+			continue;
+		}
+
+		inputEvents.push_back(inputEvent);
+	}
+
+	// Keep file order for events on the same frame
+	std::stable_sort(inputEvents.begin(), inputEvents.end(), [](const InputEvent& a, const InputEvent& b)
+	{
+		return a.frame < b.frame;
+	});
+
+	return true;
+}
+
+f64 Benchmark::getPercentile(const std::vector<f64>& sorted, const f64 percentile)
+{
+	if (sorted.size() == 0)
+	{
+		return 0.0;
+	}
+
+	const size_t index = (size_t)(percentile / 100.0 * (f64)(sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+int Benchmark::runBroadphase()
+{
+	// Game object without models, which only fills the broadphase
+	class BroadphaseObject : public GameObject
+	{
+	public:
+		void update() {}
+		void draw() {}
+	};
+
+	const u32 roomSizes[] = { 100, 1000, 10000, 100000 };
+	const u32 queries = 100000;
+	const f32 blockSize = 20.0f;
+	const u32 rows = 10;
+
+	printf("Benchmark - Broadphase, %u queries per room, %.0f units per cell\n", queries, RoomManager::BROADPHASE_CELL_SIZE);
+
+	for (const u32 roomSize : roomSizes)
+	{
+		// Lay blocks on a fixed amount of rows, so rooms grow in width like levels do
+		SpatialHash spatialHash(RoomManager::BROADPHASE_CELL_SIZE);
+		std::vector<std::shared_ptr<GameObject>> gameObjects;
+		std::vector<aabbox3df> boxes;
+		gameObjects.reserve(roomSize);
+		boxes.reserve(roomSize);
+
+		for (u32 i = 0; i < roomSize; ++i)
+		{
+			const vector3df position((f32)(i / rows) * blockSize, (f32)(i % rows) * blockSize, 0.0f);
+			const aabbox3df box(position - vector3df(blockSize * 0.5f), position + vector3df(blockSize * 0.5f));
+
+			gameObjects.push_back(std::make_shared<BroadphaseObject>());
+			spatialHash.insert(gameObjects.back());
+			spatialHash.update(gameObjects.back().get(), box);
+			boxes.push_back(box);
+		}
+
+		// Player sized probes, at the same positions for both paths
+		std::mt19937 random(1);
+		std::uniform_real_distribution<f32> x(0.0f, (f32)(roomSize / rows) * blockSize);
+		std::uniform_real_distribution<f32> y(0.0f, (f32)rows * blockSize);
+		std::vector<aabbox3df> probes(queries);
+
+		for (aabbox3df& probe : probes)
+		{
+			const vector3df center(x(random), y(random), 0.0f);
+			probe = aabbox3df(center - vector3df(8.0f), center + vector3df(8.0f));
+		}
+
+		// Broadphase
+		u32 hashHits = 0;
+		f64 hashTime;
+		{
+			std::vector<const SpatialHash::Entry*> candidates;
+			const auto start = std::chrono::steady_clock::now();
+
+			for (const aabbox3df& probe : probes)
+			{
+				candidates.clear();
+				spatialHash.query(probe, candidates);
+
+				for (const SpatialHash::Entry* entry : candidates)
+				{
+					hashHits += probe.intersectsWithBox(entry->box);
+				}
+			}
+
+			hashTime = std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - start).count() / (f64)queries;
+		}
+
+		// Linear scan, on fewer probes for big rooms, so it still ends in a reasonable time
+		const u32 linearQueries = std::max(100u, std::min(queries, 10000000u / roomSize));
+		u32 linearHits = 0;
+		f64 linearTime;
+		{
+			const auto start = std::chrono::steady_clock::now();
+
+			for (u32 i = 0; i < linearQueries; ++i)
+			{
+				for (const aabbox3df& box : boxes)
+				{
+					linearHits += probes[i].intersectsWithBox(box);
+				}
+			}
+
+			linearTime = std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - start).count() / (f64)linearQueries;
+		}
+
+		printf("%6u objects: hash %8.1f ns/query (%.1f cells, %.1f entries visited, %u hits), linear %10.1f ns/query (%u hits over %u queries)\n",
+			roomSize, hashTime, spatialHash.getAverageVisitedCells(), spatialHash.getAverageVisitedEntries(), hashHits, linearTime, linearHits, linearQueries);
+	}
+
+	// Compare the batch kernel with per object transforms, on all of the boxes of a room
+	printf("Benchmark - Batch AABB kernel (%s)\n", BoxArray::getKernelName());
+
+	for (const u32 roomSize : roomSizes)
+	{
+		const aabbox3df localBox(vector3df(blockSize * -0.5f), vector3df(blockSize * 0.5f));
+		std::vector<vector3df> positions;
+		BoxArray boxes;
+
+		for (u32 i = 0; i < roomSize; ++i)
+		{
+			positions.push_back(vector3df((f32)(i / rows) * blockSize, (f32)(i % rows) * blockSize, 0.0f));
+
+			aabbox3df box(localBox);
+			Utility::transformAABBox(box, positions.back());
+			boxes.push(box);
+		}
+
+		std::mt19937 random(1);
+		std::uniform_real_distribution<f32> x(0.0f, (f32)(roomSize / rows) * blockSize);
+		std::uniform_real_distribution<f32> y(0.0f, (f32)rows * blockSize);
+		const u32 probeCount = std::max(10u, 10000000u / roomSize);
+		std::vector<aabbox3df> probes(probeCount);
+
+		for (aabbox3df& probe : probes)
+		{
+			const vector3df center(x(random), y(random), 0.0f);
+			probe = aabbox3df(center - vector3df(8.0f), center + vector3df(8.0f));
+		}
+
+		// Count hits of a mask
+		std::vector<u32> mask;
+		const auto countHits = [&mask]()
+		{
+			u32 hits = 0;
+			for (u32 word : mask)
+			{
+				for (; word != 0; word &= word - 1)
+				{
+					++hits;
+				}
+			}
+			return hits;
+		};
+
+		// Measure nanoseconds per tested box
+		const auto measure = [&](const std::function<u32(const aabbox3df& probe)>& test, u32& hits)
+		{
+			hits = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (const aabbox3df& probe : probes)
+			{
+				hits += test(probe);
+			}
+			return std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - start).count() / ((f64)probeCount * (f64)roomSize);
+		};
+
+		u32 transformHits, scalarHits, kernelHits;
+		const f64 transformTime = measure([&](const aabbox3df& probe)
+		{
+			u32 hits = 0;
+			for (const vector3df& position : positions)
+			{
+				aabbox3df box(localBox);
+				Utility::transformAABBox(box, position);
+				hits += probe.intersectsWithBox(box);
+			}
+			return hits;
+		}, transformHits);
+
+		const f64 scalarTime = measure([&](const aabbox3df& probe)
+		{
+			boxes.intersectScalar(probe, mask);
+			return countHits();
+		}, scalarHits);
+
+		const f64 kernelTime = measure([&](const aabbox3df& probe)
+		{
+			boxes.intersect(probe, mask);
+			return countHits();
+		}, kernelHits);
+
+		printf("%6u boxes: transform and test %6.2f ns/box, scalar arrays %6.2f ns/box, %s arrays %6.2f ns/box (%u, %u and %u hits over %u probes)\n",
+			roomSize, transformTime, scalarTime, BoxArray::getKernelName(), kernelTime, transformHits, scalarHits, kernelHits, probeCount);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int Benchmark::run()
+{
+	// Run collision queries only, when requested
+	if (broadphase)
+	{
+		return runBroadphase();
+	}
+
+	// Load input stream
+	if (inputPath.length() > 0 && !loadInput())
+	{
+		printf("Benchmark - Input file %s could NOT be loaded\n", inputPath.c_str());
+		return EXIT_FAILURE;
+	}
+
+	// Initialize engine components
+	Engine::singleton = std::make_shared<Engine>();
+
+	if (!Engine::singleton->startHeadlessDevice(driverType, windowSize))
+	{
+		printf("Benchmark - Cannot initialize graphic device\n");
+		return EXIT_FAILURE;
+	}
+
+	// Render targets are not supported by the null driver, but the simulation does not need them
+	Engine::singleton->setupComponents();
+
+	// Every frame advances the simulation by the same amount of time
+	Engine::singleton->simulationClock->setFixedFrameTime(frameTime);
+
+	// Change distance within which game objects are updated, if requested
+	if (activityRadius >= 0.0f)
+	{
+		RoomManager::singleton->activityManager->setRadius(activityRadius);
+	}
+
+	// Load room
+	f64 loadTime;
+	{
+		const auto start = std::chrono::steady_clock::now();
+		RoomManager::singleton->loadRoom(roomName);
+		loadTime = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+	const size_t initialObjects = RoomManager::singleton->gameObjects.size();
+
+	// Run frames
+	IrrlichtDevice* device = Engine::singleton->device;
+	std::vector<f64> frameTimes;
+	frameTimes.reserve(frames);
+
+	size_t nextEvent = 0;
+	u32 removals = 0;
+	size_t visibleModels = 0;
+	size_t culledModels = 0;
+	size_t draws = 0;
+	size_t programChanges = 0;
+	size_t textureChanges = 0;
+	size_t unsortedProgramChanges = 0;
+	size_t unsortedTextureChanges = 0;
+	u32 passthroughFrames = 0;
+	size_t spriteDraws = 0;
+	size_t sprites = 0;
+	size_t contactPairs = 0;
+	u32 contactEnters = 0;
+	u32 contactExits = 0;
+	size_t awakeObjects = 0;
+	size_t sleepingObjects = 0;
+	u32 wakes = 0;
+	u32 scheduledWakes = 0;
+
+	Engine::singleton->startLoop();
+	for (u32 i = 0; i < COLLISION_LAYER_COUNT; ++i)
+	{
+		RoomManager::singleton->getCollisionLayer(i)->resetCounters();
+	}
+
+	for (u32 frame = 0; frame < frames; ++frame)
+	{
+		if (!device->run() || !RoomManager::singleton->isProgramRunning)
+		{
+			break;
+		}
+
+		// Feed input events scheduled for this frame
+		while (nextEvent < inputEvents.size() && inputEvents[nextEvent].frame <= frame)
+		{
+			device->postEventFromUser(inputEvents[nextEvent].event);
+			++nextEvent;
+		}
+
+		// Measure frame
+		const auto start = std::chrono::steady_clock::now();
+		Engine::singleton->runFrame();
+		frameTimes.push_back(std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+		removals += RoomManager::singleton->getFrameRemovals();
+		visibleModels += Engine::singleton->getVisibleModelCount();
+		culledModels += Engine::singleton->getCulledModelCount();
+
+		ContactManager* contactManager = RoomManager::singleton->contactManager.get();
+		contactPairs += contactManager->getPairCount();
+		contactEnters += contactManager->getEnterCount();
+		contactExits += contactManager->getExitCount();
+
+		ActivityManager* activityManager = RoomManager::singleton->activityManager.get();
+		awakeObjects += activityManager->getAwakeCount();
+		sleepingObjects += activityManager->getSleepingCount();
+		wakes += activityManager->getWakeCount();
+		scheduledWakes += activityManager->getScheduledWakeCount();
+
+		RenderQueue* renderQueue = Engine::singleton->getRenderQueue();
+		draws += renderQueue->getDrawCount();
+		programChanges += renderQueue->getProgramChanges();
+		textureChanges += renderQueue->getTextureChanges();
+		unsortedProgramChanges += renderQueue->getUnsortedProgramChanges();
+		unsortedTextureChanges += renderQueue->getUnsortedTextureChanges();
+
+		spriteDraws += SharedData::singleton->spriteBatch->getFrameDrawCalls();
+		sprites += SharedData::singleton->spriteBatch->getFrameSprites();
+
+		if (Engine::singleton->getPostProcessingVariant() == 0)
+		{
+			++passthroughFrames;
+		}
+	}
+
+	// Collect object counts before releasing the room
+	const size_t finalObjects = RoomManager::singleton->gameObjects.size();
+	size_t models = 0;
+	for (const std::shared_ptr<GameObject>& go : RoomManager::singleton->gameObjects)
+	{
+		models += go->models.size();
+	}
+	const u32 sceneNodes = Engine::singleton->smgr->getRootSceneNode()->getChildren().size();
+	const u32 rttAllocations = SharedData::singleton->renderTargetPool->getTotalAllocations();
+	StaticBatch* staticBatch = RoomManager::singleton->staticBatch.get();
+
+	// Compute statistics
+	std::vector<f64> sorted(frameTimes);
+	std::sort(sorted.begin(), sorted.end());
+
+	f64 total = 0.0;
+	for (const f64 value : frameTimes)
+	{
+		total += value;
+	}
+	const f64 mean = sorted.size() > 0 ? total / (f64)sorted.size() : 0.0;
+
+	// Average of a counter accumulated over all the frames
+	const auto getAverage = [&sorted](const size_t value)
+	{
+		return sorted.size() > 0 ? (f64)value / (f64)sorted.size() : 0.0;
+	};
+
+	// Print report
+	printf("Benchmark - Room: %s, driver: %s, frames: %u, fixed delta: %.3f ms\n", roomName.c_str(), driverType == EDT_NULL ? "null" : "software", (u32)frameTimes.size(), frameTime);
+	printf("Load time: %.3f ms\n", loadTime);
+	printf("Frame time (ms): mean %.3f, p50 %.3f, p90 %.3f, p95 %.3f, p99 %.3f, max %.3f, total %.3f\n",
+		mean, getPercentile(sorted, 50.0), getPercentile(sorted, 90.0), getPercentile(sorted, 95.0), getPercentile(sorted, 99.0), getPercentile(sorted, 100.0), total);
+	printf("Objects: %u at start, %u at end, %u removed, %u models, %u scene nodes\n", (u32)initialObjects, (u32)finalObjects, removals, (u32)models, sceneNodes);
+	printf("Models per frame: %.1f visible, %.1f culled\n", getAverage(visibleModels), getAverage(culledModels));
+	printf("Draws per frame: %.1f, program changes %.1f (%.1f unsorted), texture changes %.1f (%.1f unsorted)\n",
+		getAverage(draws), getAverage(programChanges), getAverage(unsortedProgramChanges), getAverage(textureChanges), getAverage(unsortedTextureChanges));
+	printf("GUI sprites per frame: %.1f in %.1f draws\n", getAverage(sprites), getAverage(spriteDraws));
+	// Fonts are missing when their file can't be loaded
+	const auto getLayoutCounters = [](SdfFont* font)
+	{
+		if (font == nullptr)
+		{
+			return std::string("n/a");
+		}
+
+		char text[64];
+		std::snprintf(text, sizeof(text), "%u memoized, %u built", font->getLayoutHits(), font->getLayoutMisses());
+		return std::string(text);
+	};
+	printf("Text layouts: title %s; small title %s\n", getLayoutCounters(SharedData::singleton->titleFont).c_str(), getLayoutCounters(SharedData::singleton->smallTitleFont).c_str());
+	printf("Post-processing: %u frames without effects, %u frames with effects\n", passthroughFrames, (u32)frameTimes.size() - passthroughFrames);
+	{
+		static const char* layerNames[] = { "player", "solid", "pickup", "spikes", "exit", "fire", "teleporter" };
+
+		printf("Collision layers (objects, cells, cells and entries visited per query):");
+		for (u32 i = 0; i < COLLISION_LAYER_COUNT; ++i)
+		{
+			SpatialHash* layer = RoomManager::singleton->getCollisionLayer(i);
+			printf("%s %s %u, %u, %.1f, %.1f", i > 0 ? ";" : "", layerNames[i], layer->getEntryCount(), layer->getCellCount(), layer->getAverageVisitedCells(), layer->getAverageVisitedEntries());
+		}
+		printf("\n");
+	}
+	{
+		TileMap* tileMap = RoomManager::singleton->getTileMap();
+		printf("Tilemap: %u solids merged into %u spans, on a grid of %ux%u tiles\n", tileMap->getTileCount(), tileMap->getSpanCount(), tileMap->getWidth(), tileMap->getHeight());
+	}
+	printf("Contact pairs per frame: %.1f, %u started, %u ended\n", getAverage(contactPairs), contactEnters, contactExits);
+	printf("Activity (radius %.0f): %.1f awake and %.1f sleeping objects per frame, %u woken (%u by schedule)\n", RoomManager::singleton->activityManager->getRadius(), getAverage(awakeObjects), getAverage(sleepingObjects), wakes, scheduledWakes);
+	printf("Static batch: %u models merged into %u mesh buffers over %u chunks\n", staticBatch->getModelCount(), staticBatch->getBufferCount(), staticBatch->getChunkCount());
+	printf("Render target allocations: %u\n", rttAllocations);
+	printf("Shader materials: %u compiled, %u served from cache\n", MaterialCache::singleton->getMaterialCount(), MaterialCache::singleton->getHitCount());
+
+	// Release everything
+	Engine::singleton->stopLoop();
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
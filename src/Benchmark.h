@@ -0,0 +1,81 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+class Benchmark
+{
+protected:
+
+	// Structure for a single scripted input event
+	struct InputEvent
+	{
+		u32 frame;
+		SEvent event;
+	};
+
+	// Settings from command line
+	std::string roomName;
+	std::string inputPath;
+	u32 frames;
+	f32 frameTime;
+	E_DRIVER_TYPE driverType;
+	dimension2du windowSize;
+	f32 activityRadius;
+
+	// Run the broadphase benchmark instead of a room
+	bool broadphase;
+
+	// Input events, sorted by frame
+	std::vector<InputEvent> inputEvents;
+
+	/**
+		Load the input stream from a text file. Every line holds the frame index followed by the event:
+			<frame> key <code> down|up
+			<frame> mouse <x> <y>
+			<frame> lmb|rmb down|up
+		where <code> is an "EKEY_CODE" value or one of: left, right, up, down, return, space, escape.
+		Empty lines and lines starting with "#" are ignored.
+
+		@return true if the file has been loaded, false otherwise.
+	*/
+	bool loadInput();
+
+	/**
+		Measure collision queries against synthetic rooms growing from 100 to 100k objects, with the
+		same density of blocks. The broadphase is compared with a linear scan of all the objects, then the
+		batch kernel of "BoxArray" is compared with transforming and testing the boxes one at a time.
+
+		@return the exit code.
+	*/
+	int runBroadphase();
+
+	// Get the value at the given percentile of an already sorted array
+	static f64 getPercentile(const std::vector<f64>& sorted, const f64 percentile);
+
+public:
+
+	// Constructor
+	Benchmark();
+
+	/**
+		Parse command line. Benchmark mode is requested with:
+			--benchmark <room> [--frames N] [--delta ms] [--driver null|software] [--size WxH] [--input file] [--activity-radius units]
+		or, for collision queries only, with:
+			--broadphase
+
+		@return true if benchmark mode has been requested, false otherwise.
+	*/
+	bool parseArguments(int argc, char** argv);
+
+	// Run benchmark and print results
+	int run();
+};
+
+#endif // BENCHMARK_H
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "BoxArray.h"
+
+// Pick the widest instructions enabled for the build. SSE2 is always available on x64
+#if defined(__AVX__)
+#include <immintrin.h>
+#define BOXARRAY_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BOXARRAY_SSE
+#endif
+
+void BoxArray::clear()
+{
+	minX.clear();
+	minY.clear();
+	minZ.clear();
+	maxX.clear();
+	maxY.clear();
+	maxZ.clear();
+}
+
+u32 BoxArray::size() const
+{
+	return (u32)minX.size();
+}
+
+void BoxArray::push(const aabbox3df& box)
+{
+	minX.push_back(box.MinEdge.X);
+	minY.push_back(box.MinEdge.Y);
+	minZ.push_back(box.MinEdge.Z);
+	maxX.push_back(box.MaxEdge.X);
+	maxY.push_back(box.MaxEdge.Y);
+	maxZ.push_back(box.MaxEdge.Z);
+}
+
+void BoxArray::set(const u32 index, const aabbox3df& box)
+{
+	minX[index] = box.MinEdge.X;
+	minY[index] = box.MinEdge.Y;
+	minZ[index] = box.MinEdge.Z;
+	maxX[index] = box.MaxEdge.X;
+	maxY[index] = box.MaxEdge.Y;
+	maxZ[index] = box.MaxEdge.Z;
+}
+
+void BoxArray::swapRemove(const u32 index)
+{
+	const u32 last = size() - 1;
+
+	minX[index] = minX[last];
+	minY[index] = minY[last];
+	minZ[index] = minZ[last];
+	maxX[index] = maxX[last];
+	maxY[index] = maxY[last];
+	maxZ[index] = maxZ[last];
+
+	minX.pop_back();
+	minY.pop_back();
+	minZ.pop_back();
+	maxX.pop_back();
+	maxY.pop_back();
+	maxZ.pop_back();
+}
+
+void BoxArray::intersectRange(const aabbox3df& probe, const u32 first, std::vector<u32>& mask) const
+{
+	const u32 count = size();
+
+	for (u32 i = first; i < count; ++i)
+	{
+		const bool hit = minX[i] <= probe.MaxEdge.X && maxX[i] >= probe.MinEdge.X
+			&& minY[i] <= probe.MaxEdge.Y && maxY[i] >= probe.MinEdge.Y
+			&& minZ[i] <= probe.MaxEdge.Z && maxZ[i] >= probe.MinEdge.Z;
+
+		mask[i >> 5] |= (u32)hit << (i & 31);
+	}
+}
+
+void BoxArray::intersect(const aabbox3df& probe, std::vector<u32>& mask) const
+{
+	const u32 count = size();
+	mask.assign((count + 31) >> 5, 0);
+	u32 i = 0;
+
+#if defined(BOXARRAY_AVX)
+	// Eight boxes per step, whose bits always fall into the same element of the mask
+	const __m256 probeMinX = _mm256_set1_ps(probe.MinEdge.X);
+	const __m256 probeMinY = _mm256_set1_ps(probe.MinEdge.Y);
+	const __m256 probeMinZ = _mm256_set1_ps(probe.MinEdge.Z);
+	const __m256 probeMaxX = _mm256_set1_ps(probe.MaxEdge.X);
+	const __m256 probeMaxY = _mm256_set1_ps(probe.MaxEdge.Y);
+	const __m256 probeMaxZ = _mm256_set1_ps(probe.MaxEdge.Z);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 hit = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&minX[i]), probeMaxX, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_loadu_ps(&maxX[i]), probeMinX, _CMP_GE_OQ));
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&minY[i]), probeMaxY, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_loadu_ps(&maxY[i]), probeMinY, _CMP_GE_OQ)));
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&minZ[i]), probeMaxZ, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_loadu_ps(&maxZ[i]), probeMinZ, _CMP_GE_OQ)));
+
+		mask[i >> 5] |= (u32)_mm256_movemask_ps(hit) << (i & 31);
+	}
+#elif defined(BOXARRAY_SSE)
+	// Four boxes per step, whose bits always fall into the same element of the mask
+	const __m128 probeMinX = _mm_set1_ps(probe.MinEdge.X);
+	const __m128 probeMinY = _mm_set1_ps(probe.MinEdge.Y);
+	const __m128 probeMinZ = _mm_set1_ps(probe.MinEdge.Z);
+	const __m128 probeMaxX = _mm_set1_ps(probe.MaxEdge.X);
+	const __m128 probeMaxY = _mm_set1_ps(probe.MaxEdge.Y);
+	const __m128 probeMaxZ = _mm_set1_ps(probe.MaxEdge.Z);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minX[i]), probeMaxX), _mm_cmpge_ps(_mm_loadu_ps(&maxX[i]), probeMinX));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minY[i]), probeMaxY), _mm_cmpge_ps(_mm_loadu_ps(&maxY[i]), probeMinY)));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minZ[i]), probeMaxZ), _mm_cmpge_ps(_mm_loadu_ps(&maxZ[i]), probeMinZ)));
+
+		mask[i >> 5] |= (u32)_mm_movemask_ps(hit) << (i & 31);
+	}
+#endif
+
+	// Remaining boxes, or all of them without vector instructions
+	intersectRange(probe, i, mask);
+}
+
+void BoxArray::intersectScalar(const aabbox3df& probe, std::vector<u32>& mask) const
+{
+	mask.assign((size() + 31) >> 5, 0);
+	intersectRange(probe, 0, mask);
+}
+
+const char* BoxArray::getKernelName()
+{
+#if defined(BOXARRAY_AVX)
+	return "AVX";
+#elif defined(BOXARRAY_SSE)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef BOXARRAY_H
+#define BOXARRAY_H
+
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+
+class BoxArray
+{
+protected:
+
+	// Extents of the boxes, one array per component, so a probe can be tested against several boxes at once
+	std::vector<f32> minX;
+	std::vector<f32> minY;
+	std::vector<f32> minZ;
+	std::vector<f32> maxX;
+	std::vector<f32> maxY;
+	std::vector<f32> maxZ;
+
+	// Test the boxes from "first" to the end one at a time, setting their bits into an already cleared mask
+	void intersectRange(const aabbox3df& probe, const u32 first, std::vector<u32>& mask) const;
+
+public:
+
+	// Remove all of the boxes
+	void clear();
+
+	// Amount of boxes
+	u32 size() const;
+
+	// Append a box
+	void push(const aabbox3df& box);
+
+	// Replace the box at an index
+	void set(const u32 index, const aabbox3df& box);
+
+	// Remove the box at an index, moving the last one in its place
+	void swapRemove(const u32 index);
+
+	/**
+		Test a probe box against all of the boxes, with the widest vector instructions available at build time.
+		Boxes are intersecting when they overlap or touch, like for "aabbox3df::intersectsWithBox".
+
+		@param probe the box to be tested.
+		@param mask the vector which is filled with one bit per box, 32 boxes per element.
+	*/
+	void intersect(const aabbox3df& probe, std::vector<u32>& mask) const;
+
+	// Same as "intersect", but testing one box at a time
+	void intersectScalar(const aabbox3df& probe, std::vector<u32>& mask) const;
+
+	// Get the name of the instructions used by "intersect"
+	static const char* getKernelName();
+};
+
+#endif // BOXARRAY_H
\ No newline at end of file
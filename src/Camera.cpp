@@ -6,6 +6,7 @@ Camera::Camera()
 {
 	position = vector3df(0, 0, 0);
 	lookAt = vector3df(0, 0, 0);
+	hasViewFrustum = false;
 }
 
 void Camera::updateProperties()
@@ -38,4 +39,50 @@ void Camera::setLookAt(const vector3df & lookAt)
 {
 	this->lookAt = lookAt;
 	updateProperties();
+}
+
+void Camera::updateViewFrustum()
+{
+	// Projection is only known by the camera node
+	ICameraSceneNode* node = smgr->getActiveCamera();
+	hasViewFrustum = node != nullptr;
+
+	if (!hasViewFrustum)
+	{
+		return;
+	}
+
+	// Build view matrix from the current properties, since the node is updated only when drawing
+	matrix4 view;
+	view.buildCameraLookAtMatrixLH(position, lookAt, node->getUpVector());
+
+	// Extract planes and visible range
+	viewFrustum.setFrom(node->getProjectionMatrix() * view);
+	viewFrustum.recalculateBoundingBox();
+}
+
+bool Camera::isVisible(const aabbox3df& box)
+{
+	// Everything is visible until the frustum is known
+	if (!hasViewFrustum)
+	{
+		return true;
+	}
+
+	// Check against visible range
+	if (!viewFrustum.getBoundingBox().intersectsWithBox(box))
+	{
+		return false;
+	}
+
+	// Check against every plane, whose normal points outside
+	for (u32 i = 0; i != SViewFrustum::VF_PLANE_COUNT; ++i)
+	{
+		if (box.classifyPlaneRelation(viewFrustum.planes[i]) == ISREL3D_FRONT)
+		{
+			return false;
+		}
+	}
+
+	return true;
 }
\ No newline at end of file
@@ -16,6 +16,10 @@ protected:
 	vector3df position;
 	vector3df lookAt;
 
+	// Visible volume for the current frame
+	SViewFrustum viewFrustum;
+	bool hasViewFrustum;
+
 	void updateProperties();
 
 public:
@@ -31,6 +35,23 @@ public:
 
 	vector3df getLookAt();
 	void setLookAt(const vector3df & lookAt);
+
+	/**
+		Compute the visible volume from position, look at and the projection of the active camera node.
+		It must be called once per frame, after game objects have moved the camera.
+	*/
+	void updateViewFrustum();
+
+	/**
+		Check if a bounding box can be seen by the camera. The box is tested against the bounding box of the
+		visible volume first, which rejects most of the off-screen objects in a side-scrolling level, then
+		against the planes of the view frustum.
+
+		@param box the bounding box, in world space.
+
+		@return true if the box is at least partially visible, false otherwise.
+	*/
+	bool isVisible(const aabbox3df& box);
 };
 
 #endif // CAMERA_H
\ No newline at end of file
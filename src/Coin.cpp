@@ -52,7 +52,7 @@ void Coin::draw()
 	if (notPicked)
 	{
 		std::shared_ptr<Model> &model = models.at(0);
-		model->position = position;
+		model->position = getDrawPosition();
 		model->rotation = vector3df(0, angle, 0);
 	}
 }
@@ -15,9 +15,16 @@ public:
 	std::shared_ptr<EngineObject> engineObject = nullptr;
 	aabbox3df mainBoundingBox, otherBoundingBox;
 
+	// Fraction of the motion travelled before the impact, and normal of the hit face, for sweeps
+	f32 time = 1.0f;
+	vector3df normal = vector3df(0);
+
+	// Boxes are actually overlapping, for contacts, which are also found when boxes are only close
+	bool overlapping = false;
+
 	// Get casted game object which collided
 	template <typename T>
-	std::shared_ptr<T> getGameObject()
+	std::shared_ptr<T> getGameObject() const
 	{
 		return std::static_pointer_cast<T>(engineObject);
 	}
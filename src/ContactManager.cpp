@@ -0,0 +1,201 @@
+#include <functional>
+#include "ContactManager.h"
+#include "GameObject.h"
+#include "RoomManager.h"
+
+const f32 ContactManager::MARGIN = 2.0f;
+
+size_t ContactManager::PairKeyHash::operator()(const std::pair<GameObject*, GameObject*>& key) const
+{
+	const size_t a = std::hash<GameObject*>()(key.first);
+	const size_t b = std::hash<GameObject*>()(key.second);
+	return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
+}
+
+std::pair<GameObject*, GameObject*> ContactManager::getKey(GameObject* a, GameObject* b)
+{
+	return std::less<GameObject*>()(a, b) ? std::make_pair(a, b) : std::make_pair(b, a);
+}
+
+void ContactManager::addPair(const std::shared_ptr<GameObject>& first, const std::shared_ptr<GameObject>& second, const aabbox3df& firstBox, const aabbox3df& secondBox)
+{
+	// Keep the first occurrence of every pair
+	if (!indices.emplace(getKey(first.get(), second.get()), (u32)pairs.size()).second)
+	{
+		return;
+	}
+
+	Pair pair;
+	pair.first = first;
+	pair.second = second;
+	pair.firstBox = firstBox;
+	pair.secondBox = secondBox;
+	pair.overlapping = firstBox.intersectsWithBox(secondBox);
+	pairs.push_back(pair);
+}
+
+void ContactManager::dispatch(const Pair& pair, const u8 state)
+{
+	// Each game object sees the other one, with both of the boxes. Ended pairs are never overlapping
+	Collision collision;
+	collision.overlapping = state != CONTACT_EXIT && pair.overlapping;
+	collision.engineObject = pair.second;
+	collision.mainBoundingBox = pair.firstBox;
+	collision.otherBoundingBox = pair.secondBox;
+	pair.first->onContact(collision, state);
+
+	collision.engineObject = pair.first;
+	collision.mainBoundingBox = pair.secondBox;
+	collision.otherBoundingBox = pair.firstBox;
+	pair.second->onContact(collision, state);
+}
+
+ContactManager::ContactManager()
+{
+	enterCount = 0;
+	exitCount = 0;
+}
+
+void ContactManager::addLayerPair(const u32 first, const u32 second)
+{
+	layerPairs.push_back(std::make_pair(first, second));
+}
+
+void ContactManager::addTilePair(const u32 layer, const u8 flags)
+{
+	tilePairs.push_back(std::make_pair(layer, flags));
+}
+
+void ContactManager::update()
+{
+	pairs.clear();
+	indices.clear();
+
+	// Find pairs with tiles
+	TileMap* tileMap = RoomManager::singleton->getTileMap();
+
+	for (const std::pair<u32, u8>& tilePair : tilePairs)
+	{
+		sources.clear();
+		RoomManager::singleton->getCollisionLayer(tilePair.first)->getEntries(sources);
+
+		for (const SpatialHash::Entry* source : sources)
+		{
+			GameObject* gameObject = source->gameObject.get();
+			if (gameObject->destroy || gameObject->models.size() == 0)
+			{
+				continue;
+			}
+
+			// Look around the box of the game object
+			aabbox3df area(source->box);
+			area.MinEdge -= vector3df(MARGIN);
+			area.MaxEdge += vector3df(MARGIN);
+
+			tiles.clear();
+			tileMap->queryTiles(area, tilePair.second, tiles);
+
+			for (const TileMap::Tile* tile : tiles)
+			{
+				GameObject* other = tile->gameObject.get();
+				if (other->destroy || other->models.size() == 0)
+				{
+					continue;
+				}
+
+				addPair(source->gameObject, tile->gameObject, source->box, tile->box);
+			}
+		}
+	}
+
+	// Find pairs between layers
+	for (const std::pair<u32, u32>& layerPair : layerPairs)
+	{
+		SpatialHash* target = RoomManager::singleton->getCollisionLayer(layerPair.second);
+
+		sources.clear();
+		RoomManager::singleton->getCollisionLayer(layerPair.first)->getEntries(sources);
+
+		for (const SpatialHash::Entry* source : sources)
+		{
+			GameObject* gameObject = source->gameObject.get();
+			if (gameObject->destroy || gameObject->models.size() == 0)
+			{
+				continue;
+			}
+
+			// Look around the box of the game object
+			aabbox3df area(source->box);
+			area.MinEdge -= vector3df(MARGIN);
+			area.MaxEdge += vector3df(MARGIN);
+
+			candidates.clear();
+			target->query(area, candidates);
+
+			for (const SpatialHash::Entry* candidate : candidates)
+			{
+				GameObject* other = candidate->gameObject.get();
+				if (other == gameObject || other->destroy || other->models.size() == 0)
+				{
+					continue;
+				}
+
+				addPair(source->gameObject, candidate->gameObject, source->box, candidate->box);
+			}
+		}
+	}
+
+	// Notify current pairs
+	enterCount = 0;
+
+	for (const Pair& pair : pairs)
+	{
+		const bool found = previousIndices.count(getKey(pair.first.get(), pair.second.get())) > 0;
+		enterCount += found ? 0 : 1;
+		dispatch(pair, found ? CONTACT_STAY : CONTACT_ENTER);
+	}
+
+	// Notify ended pairs, with the boxes they had when they were last found
+	exitCount = 0;
+
+	for (const Pair& pair : previousPairs)
+	{
+		if (indices.count(getKey(pair.first.get(), pair.second.get())) == 0)
+		{
+			++exitCount;
+			dispatch(pair, CONTACT_EXIT);
+		}
+	}
+
+	// Current pairs are compared against by the next pass
+	std::swap(pairs, previousPairs);
+	std::swap(indices, previousIndices);
+
+	// Release ended pairs, so their game objects can be freed
+	pairs.clear();
+}
+
+void ContactManager::clear()
+{
+	pairs.clear();
+	previousPairs.clear();
+	indices.clear();
+	previousIndices.clear();
+	enterCount = 0;
+	exitCount = 0;
+}
+
+u32 ContactManager::getPairCount()
+{
+	return (u32)previousPairs.size();
+}
+
+u32 ContactManager::getEnterCount()
+{
+	return enterCount;
+}
+
+u32 ContactManager::getExitCount()
+{
+	return exitCount;
+}
\ No newline at end of file
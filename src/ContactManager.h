@@ -0,0 +1,120 @@
+#ifndef CONTACTMANAGER_H
+#define CONTACTMANAGER_H
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <irrlicht.h>
+
+#include "SpatialHash.h"
+#include "TileMap.h"
+
+using namespace irr;
+using namespace core;
+
+class GameObject;
+
+class ContactManager
+{
+protected:
+
+	// Structure for two game objects whose world boxes are within the margin, with the boxes they had and whether they overlap
+	struct Pair
+	{
+		std::shared_ptr<GameObject> first;
+		std::shared_ptr<GameObject> second;
+		aabbox3df firstBox;
+		aabbox3df secondBox;
+		bool overlapping;
+	};
+
+	// Hash for pairs of game objects, which are stored with the lower address first
+	struct PairKeyHash
+	{
+		size_t operator()(const std::pair<GameObject*, GameObject*>& key) const;
+	};
+
+	// Map to hold the index of every pair of a pass, by its key
+	typedef std::unordered_map<std::pair<GameObject*, GameObject*>, u32, PairKeyHash> PairIndices;
+
+	// Distance the world boxes of the first layer are enlarged by, so resting contacts are found despite rounding
+	static const f32 MARGIN;
+
+	// Collision layers whose game objects look for contacts, with the layers they look into
+	std::vector<std::pair<u32, u32>> layerPairs;
+
+	// Collision layers whose game objects look for contacts with tiles, with the flags of those tiles
+	std::vector<std::pair<u32, u8>> tilePairs;
+
+	// Pairs found by the current and by the previous pass, in dispatch order
+	std::vector<Pair> pairs;
+	std::vector<Pair> previousPairs;
+	PairIndices indices;
+	PairIndices previousIndices;
+
+	// Game objects of the layer being scanned, with the entries and tiles found around the current one
+	std::vector<const SpatialHash::Entry*> sources;
+	std::vector<const SpatialHash::Entry*> candidates;
+	std::vector<const TileMap::Tile*> tiles;
+
+	// Counters
+	u32 enterCount;
+	u32 exitCount;
+
+	// Get the key of a pair, which is the same whatever the order of the game objects is
+	static std::pair<GameObject*, GameObject*> getKey(GameObject* a, GameObject* b);
+
+	// Keep a pair, unless it has been already found by the running pass
+	void addPair(const std::shared_ptr<GameObject>& first, const std::shared_ptr<GameObject>& second, const aabbox3df& firstBox, const aabbox3df& secondBox);
+
+	// Notify both game objects of a pair
+	static void dispatch(const Pair& pair, const u8 state);
+
+public:
+
+	// Constructor
+	ContactManager();
+
+	/**
+		Look for contacts between the game objects of two collision layers. Pairs are dispatched in the
+		same order their layers are added, then in room order.
+
+		@param first the layer whose game objects look for contacts.
+		@param second the layer being looked into. It can be the same of "first".
+	*/
+	void addLayerPair(const u32 first, const u32 second);
+
+	/**
+		Look for contacts between the game objects of a collision layer and the tiles of the room.
+		Pairs with tiles are dispatched before the ones between layers.
+
+		@param layer the layer whose game objects look for contacts.
+		@param flags the "TILE_*" flags of the tiles to look for, since plain tiles have no behaviour.
+	*/
+	void addTilePair(const u32 layer, const u8 flags);
+
+	/**
+		Find all of the pairs whose boxes are within the margin, then notify both of their game objects through
+		"onContact", telling whether the boxes actually overlap. Every pair is found once, however many layers
+		both game objects belong to. Pairs which were
+		found by the previous pass too are notified as "CONTACT_STAY", the new ones as "CONTACT_ENTER",
+		while the ones which are not found anymore are notified as "CONTACT_EXIT".
+		It must be called once per tick, when all of the game objects have been updated.
+	*/
+	void update();
+
+	// Forget all of the pairs without notifying them, for instance when a room is loaded
+	void clear();
+
+	// Amount of pairs found by the last pass
+	u32 getPairCount();
+
+	// Amount of pairs which have started by the last pass
+	u32 getEnterCount();
+
+	// Amount of pairs which have ended by the last pass
+	u32 getExitCount();
+};
+
+#endif // CONTACTMANAGER_H
\ No newline at end of file
@@ -178,9 +178,10 @@ void Editor::update()
 		// Set position
 		instance->position = vector3df(snap.X, snap.Y, 0);
 		instance->models.at(0)->scale = vector3df(1);
+		instance->snapDrawPosition();
 
 		// Add to room
-		RoomManager::singleton->gameObjects.push_back(instance);
+		RoomManager::singleton->addGameObject(instance);
 	}
 }
 
@@ -209,34 +210,27 @@ void Editor::postUpdate()
 	}
 }
 
-void Editor::drawHud()
+void Editor::createHud()
 {
-	// Create text to be drawn
-	IGUIStaticText* text = guienv->addStaticText(L"Level Editor", recti(0, 0, hudSize.Width, 128));
-	text->setOverrideFont(font);
-	text->setOverrideColor(SColor(255, 128, 255, 0));
-	text->setTextAlignment(EGUIA_CENTER, EGUIA_CENTER);
+	// Create title
+	titleText = layer->addText(L"Level Editor", recti(0, 0, hudSize.Width, 128), font, EGUIA_CENTER, EGUIA_CENTER);
+	titleText->setOverrideColor(SColor(255, 128, 255, 0));
 
 	// Coordinates
 	for (u8 i = 0; i < 2; ++i)
 	{
-		std::wstring str;
-
-		if (i)
-		{
-			str = L"Y: ";
-			str += std::to_wstring((s32)(snap.Y));
-		}
-		else
-		{
-			str = L"X: ";
-			str += std::to_wstring((s32)(snap.X));
-		}
-
 		s32 h = i * 80;
-		IGUIStaticText* text = guienv->addStaticText(str.c_str(), recti(16, h, 512, 96 + h));
-		text->setOverrideFont(font);
-		text->setOverrideColor(SColor(255, 128, 255, 0));
-		text->setTextAlignment(EGUIA_UPPERLEFT, EGUIA_UPPERLEFT);
+		coordinateTexts[i] = layer->addText(L"", recti(16, h, 512, 96 + h), font, EGUIA_UPPERLEFT, EGUIA_UPPERLEFT);
+		coordinateTexts[i]->setOverrideColor(SColor(255, 128, 255, 0));
 	}
+}
+
+void Editor::drawHud()
+{
+	// Title follows window size
+	layer->setRect(titleText, recti(0, 0, hudSize.Width, 128));
+
+	// Coordinates are formatted only when they change
+	layer->setNumber(coordinateTexts[0], (s32)(snap.X), L"X: ");
+	layer->setNumber(coordinateTexts[1], (s32)(snap.Y), L"Y: ");
 }
\ No newline at end of file
@@ -13,6 +13,10 @@ protected:
 	vector3df zoom;
 	vector2df snap;
 
+	// Retained elements
+	IGUIStaticText* titleText;
+	IGUIStaticText* coordinateTexts[2];
+
 public:
 
 	static std::shared_ptr<GameObject> singleton;
@@ -22,6 +26,7 @@ public:
 
 	// Mandatory methods
 	void update();
+	void createHud();
 	void drawHud();
 	void postUpdate();
 
@@ -1,3 +1,6 @@
+#include <fstream>
+#include <sstream>
+
 #include "Engine.h"
 #include "ScreenQuadSceneNode.h"
 #include "Utility.h"
@@ -6,6 +9,8 @@
 #include "SharedData.h"
 #include "Camera.h"
 #include "Editor.h"
+#include "Profiler.h"
+#include "MaterialCache.h"
 
 // Default values
 const wchar_t* Engine::WINDOW_TITLE = L"SphereBall - Demo";
@@ -19,6 +24,20 @@ Engine::Engine()
 	SoundManager::singleton = std::make_shared<SoundManager>();
 	SharedData::singleton = std::make_shared<SharedData>();
 	Camera::singleton = std::make_shared<Camera>();
+	MaterialCache::singleton = std::make_shared<MaterialCache>();
+
+	// Create clock for fixed-step simulation
+	simulationClock = std::make_unique<SimulationClock>();
+
+	// Create threads for parallel updates
+	workerPool = std::make_unique<WorkerPool>();
+
+	// Render queue is created with the scene
+	renderQueue = nullptr;
+
+	#ifdef SPHEREBALL_PROFILER
+	Profiler::singleton = std::make_shared<Profiler>();
+	#endif
 }
 
 void Engine::createPostProcessingMaterial()
@@ -26,7 +45,78 @@ void Engine::createPostProcessingMaterial()
 	postProcessing = std::make_unique<PostProcessing>(this);
 
 	IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-	postProcessingMaterial = gpu->addHighLevelShaderMaterialFromFiles("shaders/scene.vs", "shaders/scene.fs", postProcessing.get());
+
+	// Read sources, so every variant can be compiled with its own defines
+	const auto readSource = [](const std::string& path)
+	{
+		std::ifstream input(path);
+		std::stringstream buffer;
+		buffer << input.rdbuf();
+		return buffer.str();
+	};
+	const std::string vertexShader = readSource("shaders/scene.vs");
+	const std::string fragmentShader = readSource("shaders/scene.fs");
+
+	// Compile all of the variants now, so enabling an effect never stalls a frame
+	for (u32 variant = 0; variant < KEY_PP_VARIANT_COUNT; ++variant)
+	{
+		std::string defines;
+		if (variant & KEY_PP_VARIANT_WAVE)
+		{
+			defines += "#define WAVE\n";
+		}
+		if (variant & KEY_PP_VARIANT_RIPPLE)
+		{
+			defines += "#define RIPPLE\n";
+		}
+		if (variant & KEY_PP_VARIANT_MASK)
+		{
+			defines += "#define EFFECT_MASK\n";
+		}
+		const std::string source = defines + fragmentShader;
+
+		// Uniform locations are cached per program, so every variant has its own callback
+		postProcessingVariants[variant] = std::make_unique<PostProcessingVariant>(postProcessing.get());
+		postProcessingMaterials[variant] = gpu->addHighLevelShaderMaterial(vertexShader.c_str(), source.c_str(), postProcessingVariants[variant].get());
+
+		#if NDEBUG || _DEBUG
+		printf("Engine - Compiled post-processing variant %u as material %d\n", variant, postProcessingMaterials[variant]);
+		#endif
+	}
+	postProcessingVariant = 0;
+
+	// Every pass has its own program, so it needs its own callback
+	heatMaskPass = std::make_unique<PostProcessingPass>();
+	heatMaskMaterial = gpu->addHighLevelShaderMaterialFromFiles("shaders/scene.vs", "shaders/heatmask.fs", heatMaskPass.get());
+
+	blurPass = std::make_unique<PostProcessingPass>();
+	blurMaterial = gpu->addHighLevelShaderMaterialFromFiles("shaders/scene.vs", "shaders/blur.fs", blurPass.get());
+}
+
+void Engine::drawPostProcessingPass(ScreenQuadSceneNode& screenQuad, s32 material, ITexture* target, ITexture* source)
+{
+	// Pass can't be drawn without its program or without its render target
+	if (material == -1 || target == nullptr)
+	{
+		return;
+	}
+
+	// Viewport follows the size of the render target
+	driver->setRenderTarget(target, true, false, SColor(0, 0, 0, 0));
+
+	screenQuad.ChangeMaterialType((E_MATERIAL_TYPE)material);
+
+	SMaterial& quadMaterial = screenQuad.getMaterial(0);
+	quadMaterial.setTexture(0, source);
+	quadMaterial.TextureLayer[0].TextureWrapU = ETC_CLAMP_TO_EDGE;
+	quadMaterial.TextureLayer[0].TextureWrapV = ETC_CLAMP_TO_EDGE;
+
+	for (u32 i = 1; i < MATERIAL_MAX_TEXTURES; ++i)
+	{
+		quadMaterial.setTexture(i, nullptr);
+	}
+
+	screenQuad.render();
 }
 
 bool Engine::startDevice(void* privateData)
@@ -55,6 +145,22 @@ bool Engine::startDevice(void* privateData)
 	return device != nullptr;
 }
 
+bool Engine::startHeadlessDevice(E_DRIVER_TYPE driverType, const dimension2du& windowSize)
+{
+	// Create device without vertical sync, so frames are not throttled
+	SIrrlichtCreationParameters params;
+	params.WindowSize = windowSize;
+	params.Bits = 32;
+	params.Vsync = false;
+	params.DriverType = driverType;
+	params.EventReceiver = EventManager::singleton.get();
+
+	device = createDeviceEx(params);
+
+	// Return validity check
+	return device != nullptr;
+}
+
 bool Engine::setupComponents()
 {
 	// Setup window caption
@@ -75,12 +181,15 @@ bool Engine::setupComponents()
 	// Load assets for SharedData
 	SharedData::singleton->loadAssets();
 
-	// Set initial delta time
-	deltaTime = device->getTimer()->getTime();
+	// Start measuring time from now
+	simulationClock->reset();
 
 	// Setup material for post-processing
 	createPostProcessingMaterial();
 
+	// Compile shaders for game objects before the first room is loaded
+	MaterialCache::singleton->warmUp();
+
 	// Bind post processing functions
 	{
 		// Declare function
@@ -130,18 +239,58 @@ bool Engine::setupComponents()
 	return driver->queryFeature(EVDF_RENDER_TO_TARGET);
 }
 
-void Engine::loop()
+void Engine::startLoop()
 {
 	// Debug data
-	bool setBBoxVisible = false;
+	setBBoxVisible = false;
+
+	// Reset culling counters
+	visibleModels = 0;
+	culledModels = 0;
 
 	// Setup camera
 	Camera::singleton->setPosition(vector3df(0, 40, -100));
 	Camera::singleton->setLookAt(vector3df(0));
 
-	// Loop while game is still running
-	while (device->run() && RoomManager::singleton->isProgramRunning)
+	// Add camera scene node, which is kept for the whole program lifetime
+	smgr->addCameraSceneNode(0, Camera::singleton->getPosition(), Camera::singleton->getLookAt());
+
+	// Add render queue, which is kept for the whole program lifetime
+	renderQueue = new RenderQueue(smgr->getRootSceneNode(), smgr, -1);
+}
+
+void Engine::runFrame()
+{
+	#ifdef SPHEREBALL_PROFILER
+	// Count the previous frame for the running capture
+	Profiler::singleton->endFrame();
+	#endif
+
+	PROFILE_ZONE("frame");
+
+	// Advance simulation clock, then run as many fixed ticks as the elapsed time requires
+	const u32 ticks = simulationClock->advance();
+	const f32 tickDelta = simulationClock->getTickDelta();
+
+	for (u32 tick = 0; tick != ticks; ++tick)
 	{
+		PROFILE_ZONE("tick");
+
+		#ifdef SPHEREBALL_PROFILER
+		// Start or stop trace capture on key press
+		if (EventManager::singleton->keyStates[KEY_F9] == KEY_PRESSED)
+		{
+			if (Profiler::singleton->isCapturing())
+			{
+				Profiler::singleton->stopCapture();
+			}
+			else
+			{
+				Profiler::singleton->startCapture();
+			}
+		}
+		#endif
+
 		// Set debug data visible
 		#if NDEBUG || _DEBUG
 		if (EventManager::singleton->keyStates[KEY_KEY_P] == KEY_PRESSED)
@@ -155,207 +304,308 @@ void Engine::loop()
 		}
 		#endif
 
-		// Get window size
-		dimension2du windowSize;
+		// Update game objects
 		{
-			s32 videoMode = Utility::getVideoMode(device);
-			windowSize = videoMode == -1 ? dimension2du(Utility::getWindowSize<u32>(driver)) : device->getVideoModeList()->getVideoModeResolution(videoMode);
+			PROFILE_ZONE("update");
+			updateGameObjects(tickDelta);
 		}
 
-		// Setup GUI RTT
+		// Update shared state
+		SharedData::singleton->update(tickDelta);
+
+		// Update key states, so every key event is seen by a single tick
+		EventManager::singleton->updateKeyStates();
+	}
+
+	// Remove destroyed game objects in a single pass
+	RoomManager::singleton->removeDestroyedGameObjects();
+
+	// Interpolate drawn state between the last two ticks
+	GameObject::interpolation = simulationClock->getInterpolation();
+
+	// Get window size
+	dimension2du windowSize;
+	{
+		s32 videoMode = Utility::getVideoMode(device);
+		windowSize = videoMode == -1 ? dimension2du(Utility::getWindowSize<u32>(driver)) : device->getVideoModeList()->getVideoModeResolution(videoMode);
+	}
+
+	// Get render targets from pool, which reallocates them only when window size changes
+	RenderTargetPool* renderTargetPool = SharedData::singleton->renderTargetPool.get();
+
+	// Setup GUI RTT
+	{
+		bool reallocated = false;
+		SharedData::singleton->guiRtt = renderTargetPool->acquire("guiRtt", windowSize, ECF_A8R8G8B8, &reallocated);
+
+		// Clear the GUI only when it isn't valid anymore, since the HUD redraws it only when changed
+		if (reallocated)
 		{
-			if (SharedData::singleton->guiRtt != nullptr)
-			{
-				driver->removeTexture(SharedData::singleton->guiRtt);
-			}
+			SharedData::singleton->guiRttDirty = true;
+		}
 
-			SharedData::singleton->guiRtt = driver->addRenderTargetTexture(windowSize, "guiRtt", ECF_A8R8G8B8);
+		// Render targets are not supported by every driver, such as the null one
+		if (SharedData::singleton->guiRttDirty && SharedData::singleton->guiRtt != nullptr)
+		{
+			driver->setRenderTarget(SharedData::singleton->guiRtt, true, true, SColor(0, 0, 0, 0));
 		}
+	}
+
+	// Setup and MRT
+	irr::core::array<IRenderTarget>* sceneRtts = &SharedData::singleton->sceneRtts;
 
-		// Setup and MRT
-		irr::core::array<IRenderTarget>* sceneRtts = &SharedData::singleton->sceneRtts;
+	{
+		ITexture* colorRtt = renderTargetPool->acquire("colorRtt", windowSize);
+		ITexture* ppRtt = renderTargetPool->acquire("ppRtt", windowSize);
 
+		// Rebuild array only when textures have been reallocated
+		if (sceneRtts->size() != 2 || (*sceneRtts)[0].RenderTexture != colorRtt || (*sceneRtts)[1].RenderTexture != ppRtt)
 		{
-			// Remove all textures and clear array
-			for (s32 i = sceneRtts->size() - 1; i >= 0; --i)
-			{
-				driver->removeTexture((*sceneRtts)[i].RenderTexture);
-			}
 			sceneRtts->clear();
-
-			// Create new textures for render targets
-			sceneRtts->push_back(driver->addRenderTargetTexture(windowSize, "colorRtt", ECF_A8R8G8B8));
-			sceneRtts->push_back(driver->addRenderTargetTexture(windowSize, "ppRtt", ECF_A8R8G8B8));
+			sceneRtts->push_back(colorRtt);
+			sceneRtts->push_back(ppRtt);
 		}
+	}
 
-		// Make G-Buffer current
-		driver->setRenderTarget(*sceneRtts);
-
-		// Now delta time
-		u32 now = device->getTimer()->getTime();
-		deltaTime = now - deltaTime;
+	// Make G-Buffer current
+	driver->setRenderTarget(*sceneRtts);
 
-		// Update post processing manager
-		postProcessing->update((f32)deltaTime);
+	// Update post processing manager, which is purely visual, once per rendered frame
+	const f32 frameDelta = simulationClock->getFrameDelta();
+	postProcessing->update(frameDelta);
 
-		// Double buffered scene with clear color
-		driver->beginScene(true, true, SColor(0, 0, 0, 0));
+	// Per-frame shader constants are uploaded again by the first draw of every program
+	ShaderCallback::beginFrame();
 
-		// Add camera scene node
-		smgr->addCameraSceneNode(0, Camera::singleton->getPosition(), Camera::singleton->getLookAt());
+	// Double buffered scene with clear color
+	driver->beginScene(true, true, SColor(0, 0, 0, 0));
 
-		/*
-		// Search for level editor
-		if (RoomManager::singleton->gameObjects.size() > 0)
+	/*
+	// Search for level editor
+	if (RoomManager::singleton->gameObjects.size() > 0)
+	{
+		// Check if level editor is NOT in the final index of the vector
+		const auto& last = RoomManager::singleton->gameObjects.end() - 1;
+		if (Editor::singleton != nullptr && *(last) != Editor::singleton)
 		{
-			// Check if level editor is NOT in the final index of the vector
-			const auto& last = RoomManager::singleton->gameObjects.end() - 1;
-			if (Editor::singleton != nullptr && *(last) != Editor::singleton)
-			{
-				// Swap level editor instance against the last element
-				const auto& it = std::find(RoomManager::singleton->gameObjects.begin(), RoomManager::singleton->gameObjects.end(), Editor::singleton);
-				std::iter_swap(it, last);
-			}
+			// Swap level editor instance against the last element
+			const auto& it = std::find(RoomManager::singleton->gameObjects.begin(), RoomManager::singleton->gameObjects.end(), Editor::singleton);
+			std::iter_swap(it, last);
 		}
-		*/
+	}
+	*/
+
+	// Affect drawing of all game objects
+	{
+		PROFILE_ZONE("draw");
 
-		// Cycle through all available game objects
-		for (u32 i = 0; i != RoomManager::singleton->gameObjects.size(); ++i)
+		// Sleeping game objects keep the models of their last draw
+		for (const std::shared_ptr<GameObject>& go : RoomManager::singleton->activityManager->getAwakeGameObjects())
 		{
-			// Get game object
-			std::shared_ptr<GameObject> go = RoomManager::singleton->gameObjects[i];
+			go->draw();
+		}
 
-			// Set delta time for the current object
-			go->deltaTime = (f32) deltaTime;
+		// GUI RTT is up to date
+		SharedData::singleton->guiRttDirty = false;
+	}
 
-			// Update current game object
-			if (!SharedData::singleton->isAppPaused())
-			{
-				go->update();
-			}
+	// Add all game object's models to the scene, creating their persistent node only once
+	{
+		PROFILE_ZONE("submit");
 
-			// Check if game object has been destroyed
-			if (go->destroy)
-			{
-				RoomManager::singleton->gameObjects.erase(RoomManager::singleton->gameObjects.begin() + i);
-				--i;
-				continue;
-			}
+		// Static models are merged into chunks, which replace their own scene nodes
+		RoomManager::singleton->staticBatch->update(RoomManager::singleton->gameObjects, setBBoxVisible);
 
-			// Affect drawing of game object
-			go->draw();
-			
-			// Game Object is a SkyBox
-			if (go->gameObjectIndex == KEY_GOI_SKYBOX)
-			{
-				auto& model = go->models.at(0);
-				auto& textures = model->textures;
+		// Compute visible range from the camera moved by game objects
+		Camera::singleton->updateViewFrustum();
+		visibleModels = 0;
+		culledModels = 0;
 
-				ISceneNode* node = smgr->addSkyBoxSceneNode(textures[0], textures[1], textures[2], textures[3], textures[4], textures[5]);
-				node->setRotation(model->rotation);
+		// Drop draws of the previous frame, then queue visible chunks
+		renderQueue->reset();
+		RoomManager::singleton->staticBatch->submit(renderQueue);
 
-				node->setMaterialType((E_MATERIAL_TYPE)model->material);
-				node->setMaterialFlag(EMF_BLEND_OPERATION, true);
-				node->setMaterialFlag(EMF_LIGHTING, false);
-			}
-			// Ordinary game object
-			else
+		for (const std::shared_ptr<GameObject>& go : RoomManager::singleton->gameObjects)
+		{
+			for (std::shared_ptr<Model> &model : go->models)
 			{
-				// Add all game object's models to the scene
-				for (std::shared_ptr<Model> &model : go->models)
+				// Model is drawn by the static batch
+				if (model->isBatched())
 				{
-					// Create scene node from this mesh
-					IAnimatedMeshSceneNode* node = smgr->addAnimatedMeshSceneNode(model->mesh, nullptr, -1, model->position, model->rotation, model->scale);
+					continue;
+				}
 
-					// Add all texture layer for this mesh (obtained from model)
-					if (node != nullptr)
+				// Skip models outside of the visible range before any node work, while sky box is always visible
+				if (go->gameObjectIndex != KEY_GOI_SKYBOX && !Camera::singleton->isVisible(model->getWorldBoundingBox()))
+				{
+					if (model->getNode() != nullptr)
 					{
-						// Debug informations
-						if (setBBoxVisible)
-						{
-							node->setDebugDataVisible(irr::scene::EDS_BBOX);
-						}
+						model->getNode()->setVisible(false);
+					}
+					++culledModels;
+					continue;
+				}
+				++visibleModels;
 
-						// Set current frame position
-						node->setCurrentFrame(model->currentFrame);
+				if (model->getNode() == nullptr)
+				{
+					ISceneNode* node;
 
-						// Apply texture to all layers
-						for (auto &entry : model->textures)
-						{
-							node->setMaterialTexture(entry.first, entry.second);
-							node->setMaterialFlag(EMF_LIGHTING, false);
-							node->setMaterialFlag(EMF_NORMALIZE_NORMALS, true);
-						}
+					// Game Object is a SkyBox
+					if (go->gameObjectIndex == KEY_GOI_SKYBOX)
+					{
+						auto& textures = model->textures;
+						node = smgr->addSkyBoxSceneNode(textures[0], textures[1], textures[2], textures[3], textures[4], textures[5]);
+					}
+					// Ordinary game object
+					else
+					{
+						IAnimatedMeshSceneNode* meshNode = smgr->addAnimatedMeshSceneNode(model->mesh);
 
-						// Set material type, if available
-						if (model->material != -1)
+						// Frame is driven by the model, not by the scene manager's timer
+						if (meshNode != nullptr)
 						{
-							node->setMaterialType((E_MATERIAL_TYPE)model->material);
-							node->setMaterialFlag(EMF_BLEND_OPERATION, true);
+							meshNode->setAnimationSpeed(0);
 						}
+						node = meshNode;
+					}
+
+					// Let shared shader callbacks find the owner of this model
+					model->shaderInstance = go->shaderInstance;
+					model->attachNode(node);
+				}
+
+				// Apply only the changed properties
+				model->syncNode();
+
+				// Sky box is drawn by the scene manager, while other nodes are sorted by the render queue
+				if (model->getNode() != nullptr)
+				{
+					if (go->gameObjectIndex == KEY_GOI_SKYBOX)
+					{
+						model->getNode()->setVisible(true);
 					}
+					else
+					{
+						model->getNode()->setVisible(false);
+						renderQueue->add(model->getNode());
+					}
+
+					// Debug informations
+					model->getNode()->setDebugDataVisible(setBBoxVisible ? EDS_BBOX : EDS_OFF);
 				}
 			}
+		}
+	}
+
+	// Post update, after all the nodes have been added
+	{
+		PROFILE_ZONE("postUpdate");
 
-			// Post update
-			go->postUpdate();
+		std::vector<std::shared_ptr<GameObject>>& gameObjects = RoomManager::singleton->activityManager->getAwakeGameObjects();
+
+		for (u32 i = 0; i != gameObjects.size(); ++i)
+		{
+			gameObjects[i]->postUpdate();
 		}
+	}
 
-		// Draw the entire scene
+	// Draw the entire scene
+	{
+		PROFILE_ZONE("smgr->drawAll");
 		smgr->drawAll();
+	}
 
-		// Draw the entire GUI environment produced by game objects
-		guienv->drawAll();
+	// Work on scene render target
+	{
+		PROFILE_ZONE("postProcessQuad");
 
-		// Work on scene render target
+		ScreenQuadSceneNode screenQuad(smgr->getRootSceneNode(), smgr, -1);
+		ITexture* colorRtt = (*sceneRtts)[0].RenderTexture;
+		ITexture* ppRtt = (*sceneRtts)[1].RenderTexture;
+
+		// Pick the cheapest variant for the active effects
+		postProcessingVariant = postProcessing->getVariant(renderQueue->hasEffectMask());
+
+		// Heat wave mask is dilated once, at quarter resolution, when something can write it
+		ITexture* heatRtt = nullptr;
+		if (postProcessingVariant & KEY_PP_VARIANT_MASK)
+		{
+			heatRtt = renderTargetPool->acquire("heatRtt", dimension2du(core::max_(windowSize.Width / 4, 1u), core::max_(windowSize.Height / 4, 1u)));
+			drawPostProcessingPass(screenQuad, heatMaskMaterial, heatRtt, ppRtt);
+		}
+
+		// Pause blur is separable, at half resolution, and it replaces the scene color while active
+		ITexture* sceneColor = colorRtt;
+		if (postProcessing->blurFactor > 0.0001f)
 		{
-			// Clear the entire scene
-			smgr->clear();
+			const dimension2du blurSize(core::max_(windowSize.Width / 2, 1u), core::max_(windowSize.Height / 2, 1u));
+			ITexture* blurRtts[] = { renderTargetPool->acquire("blurRtt0", blurSize), renderTargetPool->acquire("blurRtt1", blurSize) };
 
-			// Clear all the GUI environment produced by game objects
-			guienv->clear();
+			// Sampling offsets are measured in full resolution texels, so the blur radius doesn't depend on the downsampling
+			blurPass->texelSize = vector2df(1.0f / (f32)windowSize.Width, 1.0f / (f32)windowSize.Height);
 
-			// Set default render target
-			driver->setRenderTarget(0);
+			blurPass->direction = vector2df(postProcessing->blurFactor, 0.0f);
+			drawPostProcessingPass(screenQuad, blurMaterial, blurRtts[0], colorRtt);
 
-			// Display game surface
-			ScreenQuadSceneNode screenQuad(smgr->getRootSceneNode(), smgr, -1);
-			screenQuad.ChangeMaterialType((E_MATERIAL_TYPE)postProcessingMaterial);
-			screenQuad.getMaterial(0).setTexture(0, SharedData::singleton->guiRtt);
-			screenQuad.getMaterial(0).setTexture(1, (*sceneRtts)[0].RenderTexture);
-			screenQuad.getMaterial(0).setTexture(2, (*sceneRtts)[1].RenderTexture);
+			blurPass->direction = vector2df(0.0f, postProcessing->blurFactor);
+			drawPostProcessingPass(screenQuad, blurMaterial, blurRtts[1], blurRtts[0]);
 
-			// Draw scene RTT quad
-			screenQuad.render();
-			screenQuad.remove();
+			if (blurMaterial != -1 && blurRtts[1] != nullptr)
+			{
+				sceneColor = blurRtts[1];
+			}
 		}
 
-		// Set Delta Time
-		SharedData::singleton->update((f32)deltaTime);
+		// Set default render target
+		driver->setRenderTarget(0);
 
-		// Build required GUI from SharedData
-		SharedData::singleton->buildGUI();
+		// Display game surface
+		screenQuad.ChangeMaterialType((E_MATERIAL_TYPE)postProcessingMaterials[postProcessingVariant]);
+		screenQuad.getMaterial(0).setTexture(0, SharedData::singleton->guiRtt);
+		screenQuad.getMaterial(0).setTexture(1, sceneColor);
+		screenQuad.getMaterial(0).setTexture(2, ppRtt);
+		screenQuad.getMaterial(0).setTexture(3, heatRtt);
 
-		// Draw the entire GUI environment produced by engine objects which are NOT game objects
-		guienv->drawAll();
+		// Draw scene RTT quad
+		screenQuad.render();
+		screenQuad.remove();
+	}
 
-		// End scene after all
-		driver->endScene();
+	// GUI animations advance once per rendered frame
+	SharedData::singleton->deltaTime = frameDelta;
 
-		// Clear scene manager
-		smgr->clear();
+	// Update retained GUI from SharedData, then draw it over the game surface
+	{
+		PROFILE_ZONE("updateGUI");
+		SharedData::singleton->updateGUI();
+	}
 
-		// Clear GUI environment
-		guienv->clear();
+	{
+		PROFILE_ZONE("drawGUI");
+		SharedData::singleton->drawGUI();
+	}
 
-		// Dispose unneeded resource for SharedData controller
-		SharedData::singleton->disposeResourcesAtFrameEnd();
+	// End scene after all
+	{
+		PROFILE_ZONE("endScene");
+		driver->endScene();
+	}
 
-		// Update key states
-		EventManager::singleton->updateKeyStates();
+	// Close render target allocation and sprite accounting for this frame
+	renderTargetPool->endFrame();
+	SharedData::singleton->spriteBatch->endFrame();
+}
 
-		// Update delta time
-		deltaTime = now;
+void Engine::stopLoop()
+{
+	// Release render queue, along with the nodes it holds
+	if (renderQueue != nullptr)
+	{
+		renderQueue->reset();
+		renderQueue->remove();
+		renderQueue->drop();
+		renderQueue = nullptr;
 	}
 
 	// Clear subsystem pointers
@@ -364,6 +614,12 @@ void Engine::loop()
 	SoundManager::singleton = nullptr;
 	SharedData::singleton = nullptr;
 	Camera::singleton = nullptr;
+	Editor::singleton = nullptr;
+	MaterialCache::singleton = nullptr;
+
+	#ifdef SPHEREBALL_PROFILER
+	Profiler::singleton = nullptr;
+	#endif
 
 	// Destroy device object
 	device->drop();
@@ -372,6 +628,124 @@ void Engine::loop()
 	Engine::singleton = nullptr;
 }
 
+void Engine::loop()
+{
+	startLoop();
+
+	// Loop while game is still running
+	while (device->run() && RoomManager::singleton->isProgramRunning)
+	{
+		runFrame();
+	}
+
+	stopLoop();
+}
+
+u32 Engine::getVisibleModelCount()
+{
+	return visibleModels;
+}
+
+u32 Engine::getCulledModelCount()
+{
+	return culledModels;
+}
+
+RenderQueue* Engine::getRenderQueue()
+{
+	return renderQueue;
+}
+
+u32 Engine::getPostProcessingVariant()
+{
+	return postProcessingVariant;
+}
+
+void Engine::updateGameObjects(f32 tickDelta)
+{
+	const bool isAppPaused = SharedData::singleton->isAppPaused();
+
+	// Put far game objects to sleep and wake the near ones, so only the awake ones are visited
+	if (!isAppPaused)
+	{
+		PROFILE_ZONE("activity");
+		RoomManager::singleton->activityManager->update(Camera::singleton->getLookAt(), tickDelta);
+	}
+
+	std::vector<std::shared_ptr<GameObject>>& gameObjects = RoomManager::singleton->activityManager->getAwakeGameObjects();
+
+	// Prepare game objects for this tick, collecting the ones which can be updated in parallel
+	parallelUpdates.clear();
+
+	for (const std::shared_ptr<GameObject>& go : gameObjects)
+	{
+		// Store state for interpolation
+		go->previousPosition = go->position;
+
+		// Set delta time for the current object
+		go->deltaTime = tickDelta;
+
+		// Check if game object can be updated on a worker thread
+		if (!isAppPaused && !go->destroy && go->isUpdateThreadSafe())
+		{
+			parallelUpdates.push_back(go.get());
+		}
+	}
+
+	// Nothing else to do while the application is paused
+	if (isAppPaused)
+	{
+		return;
+	}
+
+	// Parallel phase, for thread-safe updates
+	{
+		PROFILE_ZONE("parallelUpdate");
+
+		workerPool->parallelFor((u32)parallelUpdates.size(), [this](u32 i)
+		{
+			parallelUpdates[i]->update();
+		});
+	}
+
+	// Commit phase, for side effects deferred by thread-safe updates
+	for (GameObject* go : parallelUpdates)
+	{
+		go->commit();
+		RoomManager::singleton->updateBounds(go);
+	}
+
+	// Serial phase, for updates which interact with other game objects or subsystems
+	{
+		PROFILE_ZONE("serialUpdate");
+
+		for (u32 i = 0; i != gameObjects.size(); ++i)
+		{
+			// Get game object
+			std::shared_ptr<GameObject> go = gameObjects[i];
+
+			// Skip game objects which are waiting to be removed, or which have been already updated
+			if (go->destroy || go->isUpdateThreadSafe())
+			{
+				continue;
+			}
+
+			// Objects created during this tick need their state to be initialized
+			go->deltaTime = tickDelta;
+
+			// Update current game object, so the next ones can collide with its new bounds
+			go->update();
+			RoomManager::singleton->updateBounds(go.get());
+		}
+	}
+
+	// Contact phase, where every interaction is found once with the final bounds of this tick
+	{
+		PROFILE_ZONE("contacts");
+		RoomManager::singleton->contactManager->update();
+	}
+}
+
 Engine::PostProcessing::PostProcessing(Engine* engine)
 {
 	// Set engine reference
@@ -386,23 +760,34 @@ Engine::PostProcessing::PostProcessing(Engine* engine)
 	blurFactor = 0.0f;
 }
 
-void Engine::PostProcessing::OnSetConstants(IMaterialRendererServices* services, s32 userData)
+f32 Engine::PostProcessing::getTime()
+{
+	return ppTime;
+}
+
+u32 Engine::PostProcessing::getVariant(const bool effectMask)
 {
-	// Set shader values
-	s32 layers[] = { 0, 1, 2 };
-	services->setPixelShaderConstant("guiRtt", &layers[0], 1);
-	services->setPixelShaderConstant("colorRtt", &layers[1], 1);
-	services->setPixelShaderConstant("ppRtt", &layers[2], 1);
+	u32 variant = 0;
+
+	// Wave is fading out
+	if (waveStrength >= 0.00001f)
+	{
+		variant |= KEY_PP_VARIANT_WAVE;
+	}
 
-	dimension2du rttSize = SharedData::singleton->sceneRtts[0].RenderTexture->getOriginalSize();
-	vector2df resolution((f32)rttSize.Width, (f32)rttSize.Height);
-	services->setPixelShaderConstant("resolution", &resolution.X, 2);
+	// Ripple is fading out
+	if (ripplePoint.Z > 0.0f)
+	{
+		variant |= KEY_PP_VARIANT_RIPPLE;
+	}
 
-	services->setPixelShaderConstant("time", &ppTime, 1);
-	services->setPixelShaderConstant("waveStrength", &waveStrength, 1);
-	services->setPixelShaderConstant("ripplePoint", &ripplePoint.X, 3);
+	// Heat wave and glass are read from the mask
+	if (effectMask)
+	{
+		variant |= KEY_PP_VARIANT_MASK;
+	}
 
-	services->setPixelShaderConstant("blurFactor", &blurFactor, 1);
+	return variant;
 }
 
 void Engine::PostProcessing::update(f32 deltaTime)
@@ -441,4 +826,96 @@ void Engine::PostProcessing::update(f32 deltaTime)
 			blurFactor = 0.0f;
 		}
 	}
+}
+
+Engine::PostProcessingVariant::PostProcessingVariant(PostProcessing* postProcessing)
+{
+	// Assign effect state
+	this->postProcessing = postProcessing;
+
+	// Locations are resolved on first use
+	guiRttId = -1;
+	colorRttId = -1;
+	ppRttId = -1;
+	heatRttId = -1;
+	timeId = -1;
+	waveStrengthId = -1;
+	ripplePointId = -1;
+}
+
+void Engine::PostProcessingVariant::resolveConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::resolveConstants(services);
+
+	guiRttId = services->getPixelShaderConstantID("guiRtt");
+	colorRttId = services->getPixelShaderConstantID("colorRtt");
+	ppRttId = services->getPixelShaderConstantID("ppRtt");
+	heatRttId = services->getPixelShaderConstantID("heatRtt");
+	timeId = services->getPixelShaderConstantID("time");
+	waveStrengthId = services->getPixelShaderConstantID("waveStrength");
+	ripplePointId = services->getPixelShaderConstantID("ripplePoint");
+}
+
+void Engine::PostProcessingVariant::setFrameConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::setFrameConstants(services);
+
+	// Set texture layers
+	s32 layers[] = { 0, 1, 2, 3 };
+	services->setPixelShaderConstant(guiRttId, &layers[0], 1);
+	services->setPixelShaderConstant(colorRttId, &layers[1], 1);
+	services->setPixelShaderConstant(ppRttId, &layers[2], 1);
+	services->setPixelShaderConstant(heatRttId, &layers[3], 1);
+}
+
+void Engine::PostProcessingVariant::OnSetConstants(IMaterialRendererServices* services, s32 userData)
+{
+	// Execute parent method
+	ShaderCallback::OnSetConstants(services, userData);
+
+	// Set shader values, which are missing from the variants without the related effect
+	const f32 time = postProcessing->getTime();
+	services->setPixelShaderConstant(timeId, &time, 1);
+	services->setPixelShaderConstant(waveStrengthId, &postProcessing->waveStrength, 1);
+	services->setPixelShaderConstant(ripplePointId, &postProcessing->ripplePoint.X, 3);
+}
+
+Engine::PostProcessingPass::PostProcessingPass()
+{
+	// Initialize variables
+	texelSize = vector2df(0.0f);
+	direction = vector2df(0.0f);
+
+	// Locations are resolved on first use
+	sourceId = -1;
+	texelSizeId = -1;
+	directionId = -1;
+}
+
+void Engine::PostProcessingPass::resolveConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::resolveConstants(services);
+
+	sourceId = services->getPixelShaderConstantID("source");
+	texelSizeId = services->getPixelShaderConstantID("texelSize");
+	directionId = services->getPixelShaderConstantID("direction");
+}
+
+void Engine::PostProcessingPass::setFrameConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::setFrameConstants(services);
+
+	// Set texture layer
+	s32 layer0 = 0;
+	services->setPixelShaderConstant(sourceId, &layer0, 1);
+}
+
+void Engine::PostProcessingPass::OnSetConstants(IMaterialRendererServices* services, s32 userData)
+{
+	// Execute parent method
+	ShaderCallback::OnSetConstants(services, userData);
+
+	// Direction changes between the draws of a separable filter
+	services->setPixelShaderConstant(texelSizeId, &texelSize.X, 2);
+	services->setPixelShaderConstant(directionId, &direction.X, 2);
 }
\ No newline at end of file
@@ -8,7 +8,11 @@
 #include <vector>
 
 #include "EventManager.h"
+#include "RenderQueue.h"
+#include "ScreenQuadSceneNode.h"
 #include "ShaderCallback.h"
+#include "SimulationClock.h"
+#include "WorkerPool.h"
 
 using namespace irr;
 using namespace core;
@@ -16,12 +20,20 @@ using namespace scene;
 using namespace video;
 using namespace gui;
 
+// Effects applied by variants of the post-processing program
+#define KEY_PP_VARIANT_WAVE		0x1
+#define KEY_PP_VARIANT_RIPPLE	0x2
+#define KEY_PP_VARIANT_MASK		0x4
+#define KEY_PP_VARIANT_COUNT	8
+
+class GameObject;
+
 class Engine
 {
 protected:
 
-	// ShaderCallBack
-	class PostProcessing : public ShaderCallback
+	// State of post-processing effects
+	class PostProcessing
 	{
 	protected:
 		Engine* engine;
@@ -38,22 +50,121 @@ protected:
 
 		PostProcessing(Engine* engine);
 
+		void update(f32 deltaTime);
+
+		// Time for animated effects
+		f32 getTime();
+
+		/**
+			Get the cheapest variant of the post-processing program which can draw the current effects.
+
+			@param effectMask true if something drawn during the frame writes heat wave or glass into the mask.
+
+			@return combination of "KEY_PP_VARIANT_*" flags.
+		*/
+		u32 getVariant(const bool effectMask);
+	};
+
+	// ShaderCallBack for a single variant of the post-processing program
+	class PostProcessingVariant : public ShaderCallback
+	{
+	protected:
+		PostProcessing* postProcessing;
+
+		// Uniform locations
+		s32 guiRttId;
+		s32 colorRttId;
+		s32 ppRttId;
+		s32 heatRttId;
+		s32 timeId;
+		s32 waveStrengthId;
+		s32 ripplePointId;
+
+		virtual void resolveConstants(IMaterialRendererServices* services);
+		virtual void setFrameConstants(IMaterialRendererServices* services);
+
+	public:
+
+		PostProcessingVariant(PostProcessing* postProcessing);
+
 		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
+	};
 
-		void update(f32 deltaTime);
+	// ShaderCallBack for the intermediate passes of post-processing, which read a single texture
+	class PostProcessingPass : public ShaderCallback
+	{
+	protected:
+
+		// Uniform locations
+		s32 sourceId;
+		s32 texelSizeId;
+		s32 directionId;
+
+		virtual void resolveConstants(IMaterialRendererServices* services);
+		virtual void setFrameConstants(IMaterialRendererServices* services);
+
+	public:
+
+		// Size of a texel, in texture coordinates, used to scale sampling offsets
+		vector2df texelSize;
+
+		// Sampling direction, for separable filters
+		vector2df direction;
+
+		PostProcessingPass();
+
+		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
 	};
 
 	// Public static class constants
 	static const wchar_t* WINDOW_TITLE;
 
-	// Delta time
-	u32 deltaTime;
+	// Debug data
+	bool setBBoxVisible;
+
+	// Models submitted and skipped by visibility culling during the last frame
+	u32 visibleModels;
+	u32 culledModels;
+
+	// Scene node drawing the visible models, sorted to reduce state changes
+	RenderQueue* renderQueue;
+
+	// Worker threads for thread-safe game object updates
+	std::unique_ptr<WorkerPool> workerPool;
+
+	// Game objects updated in parallel during the current tick
+	std::vector<GameObject*> parallelUpdates;
+
+	// Update all the game objects for a single simulation tick
+	void updateGameObjects(f32 tickDelta);
 
 	// Post-Processing system
 	std::unique_ptr<PostProcessing> postProcessing;
-	s32 postProcessingMaterial;
 	void createPostProcessingMaterial();
 
+	// Variants of the post-processing program, by their "KEY_PP_VARIANT_*" flags
+	std::unique_ptr<PostProcessingVariant> postProcessingVariants[KEY_PP_VARIANT_COUNT];
+	s32 postProcessingMaterials[KEY_PP_VARIANT_COUNT];
+
+	// Variant used for the last frame
+	u32 postProcessingVariant;
+
+	// Low resolution passes, which run before the final post-processing one
+	std::unique_ptr<PostProcessingPass> heatMaskPass;
+	std::unique_ptr<PostProcessingPass> blurPass;
+	s32 heatMaskMaterial;
+	s32 blurMaterial;
+
+	/**
+		Draw a full screen pass into a render target, reading from a single texture.
+
+		@param screenQuad the quad used to draw the pass.
+		@param material the material of the pass.
+		@param target the render target to draw into.
+		@param source the texture to be read by the pass, on the first layer.
+	*/
+	void drawPostProcessingPass(ScreenQuadSceneNode& screenQuad, s32 material, ITexture* target, ITexture* source);
+
 public:
 	// Singleton pattern
 	static std::shared_ptr<Engine> singleton;
@@ -61,6 +172,9 @@ public:
 	// Constructor
 	Engine();
 
+	// Clock for fixed-step simulation, whose tick rate can be changed before starting the loop
+	std::unique_ptr<SimulationClock> simulationClock;
+
 	// Engine objects
 	IrrlichtDevice* device;
 	IVideoDriver* driver;
@@ -70,11 +184,35 @@ public:
 	// Start device with best target system target
 	bool startDevice(void* privateData);
 
+	// Start device for benchmarks, which does not need a GPU or a display when "EDT_NULL" is used
+	bool startHeadlessDevice(E_DRIVER_TYPE driverType, const dimension2du& windowSize);
+
 	// Setup window and required managers
 	bool setupComponents();
 
+	// Prepare the scene for the first frame
+	void startLoop();
+
+	// Run simulation ticks, then draw a single frame
+	void runFrame();
+
+	// Release all the subsystems and the device
+	void stopLoop();
+
 	// Loop system for game
 	void loop();
+
+	// Amount of models submitted to the scene during the last frame
+	u32 getVisibleModelCount();
+
+	// Amount of models skipped during the last frame, because they were outside of the camera range
+	u32 getCulledModelCount();
+
+	// Queue for the draws of the current frame, which holds state change counters
+	RenderQueue* getRenderQueue();
+
+	// Variant of the post-processing program used for the last frame, as "KEY_PP_VARIANT_*" flags
+	u32 getPostProcessingVariant();
 };
 
 #endif // ENGINE_H
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Exit.h"
 #include "SharedData.h"
+#include "MaterialCache.h"
 
 using nlohmann::json;
 
@@ -17,13 +18,8 @@ Exit::Exit() : GameObject()
 	picked = 0;
 	color = SColorf(1.0f, 0.0f, 0.0f);
 
-	// Create custom material
-	SpecializedShaderCallback* ssc = new SpecializedShaderCallback(this);
-
-	IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-	customMaterial = gpu->addHighLevelShaderMaterialFromFiles("shaders/standard.vs", "shaders/exit.fs", ssc, EMT_TRANSPARENT_ALPHA_CHANNEL);
-
-	ssc->drop();
+	// Get custom material
+	customMaterial = MaterialCache::singleton->getMaterial<SpecializedShaderCallback>("shaders/standard.vs", "shaders/exit.fs", EMT_TRANSPARENT_ALPHA_CHANNEL);
 
 	// Load mesh and texture for Exit model
 	IAnimatedMesh* mesh = smgr->getMesh("models/exit.obj");
@@ -45,6 +41,7 @@ Exit::Exit() : GameObject()
 	model->rotation = vector3df(90, 0, 0);
 	model->scale = vector3df(1, 1, 1);
 	model->material = getCommonBasicMaterial(EMT_SOLID);
+	model->isStatic = true;
 	models.push_back(model);
 }
 
@@ -74,17 +71,22 @@ void Exit::update()
 	}
 }
 
+s32 Exit::getCollisionLayer()
+{
+	return COLLISION_LAYER_EXIT;
+}
+
 void Exit::draw()
 {
 	// Exit model
 	std::shared_ptr<Model> model = models.at(0);
-	model->position = color.a <= 0.0f ? vector3df(std::numeric_limits<f32>::infinity()) : position;
+	model->position = color.a <= 0.0f ? vector3df(std::numeric_limits<f32>::infinity()) : getDrawPosition();
 	model->rotation = vector3df(0, angle, 0);
 	model->material = customMaterial;
 
 	// Base model
 	model = models.at(1);
-	model->position = position + vector3df(0, -9.7f, 0);
+	model->position = getDrawPosition() + vector3df(0, -9.7f, 0);
 }
 
 void Exit::pick()
@@ -93,7 +95,7 @@ void Exit::pick()
 	picked = 1;
 
 	// Replace texture
-	models.at(1)->textures[0] = driver->getTexture("textures/exit_base_green.png");
+	models.at(1)->addTexture(0, driver->getTexture("textures/exit_base_green.png"));
 
 	// Make exit color green
 	color = SColorf(0.0f, 1.0f, 0.0f);
@@ -104,9 +106,15 @@ void Exit::fade()
 	color.a = 0.999f;
 }
 
-Exit::SpecializedShaderCallback::SpecializedShaderCallback(Exit* exit)
+Exit::SpecializedShaderCallback::SpecializedShaderCallback()
 {
-	this->exit = exit;
+	colorId = -1;
+}
+
+void Exit::SpecializedShaderCallback::resolveConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::resolveConstants(services);
+	colorId = services->getPixelShaderConstantID("color");
 }
 
 void Exit::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServices* services, s32 userData)
@@ -114,10 +122,13 @@ void Exit::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServices*
 	// Execute parent method
 	ShaderCallback::OnSetConstants(services, userData);
 
-	// Set texture layer
-	s32 layer0 = 0;
-	services->setPixelShaderConstant("tex", (s32*)&layer0, 1);
+	// Get exit being drawn
+	Exit* exit = static_cast<Exit*>(instance);
+	if (exit == nullptr)
+	{
+		return;
+	}
 
-	// Set position
-	services->setPixelShaderConstant("color", &exit->color.r, 4);
+	// Set color
+	services->setPixelShaderConstant(colorId, &exit->color.r, 4);
 }
\ No newline at end of file
@@ -22,6 +22,9 @@ public:
 	void update();
 	void draw();
 
+	// Collision layer
+	s32 getCollisionLayer();
+
 	// Create specialized instance
 	static std::shared_ptr<Exit> createInstance(const nlohmann::json &jsonData);
 
@@ -32,13 +35,15 @@ public:
 	void fade();
 
 	// ShaderCallBack
-	class SpecializedShaderCallback : public ShaderCallback
+	class SpecializedShaderCallback : public InstanceShaderCallback
 	{
 	protected:
-		Exit* exit;
+		s32 colorId;
+
+		virtual void resolveConstants(IMaterialRendererServices* services);
 
 	public:
-		SpecializedShaderCallback(Exit* exit);
+		SpecializedShaderCallback();
 		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
 	};
 };
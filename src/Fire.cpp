@@ -1,4 +1,5 @@
 #include "Fire.h"
+#include "MaterialCache.h"
 
 std::shared_ptr<Fire> Fire::createInstance(const nlohmann::json &jsonData)
 {
@@ -7,13 +8,8 @@ std::shared_ptr<Fire> Fire::createInstance(const nlohmann::json &jsonData)
 
 Fire::Fire() : GameObject()
 {
-	// Create shader
-	ShaderCallback* bsc = new ShaderCallback();
-
-	IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-	s32 material = gpu->addHighLevelShaderMaterialFromFiles("shaders/standard.vs", "shaders/bonfire.fs", bsc);
-
-	bsc->drop();
+	// Get shader
+	s32 material = MaterialCache::singleton->getMaterial<ShaderCallback>("shaders/standard.vs", "shaders/bonfire.fs", EMT_SOLID, true);
 
 	// Load mesh and texture for Exit model
 	IAnimatedMesh* mesh = smgr->getMesh("models/bonfire.obj");
@@ -35,22 +31,31 @@ Fire::Fire() : GameObject()
 
 Fire::~Fire()
 {
-	// Drop the pointer, so resources can be released
+	// Remove from scene and drop the pointer, so resources can be released
+	particleSystem->remove();
 	particleSystem->drop();
 	particleSystem = nullptr;
 }
 
 void Fire::update()
 {
-	// Add particle system scene node to scene
-	smgr->getRootSceneNode()->addChild(particleSystem);
+}
+
+bool Fire::canSleep()
+{
+	return true;
+}
+
+s32 Fire::getCollisionLayer()
+{
+	return COLLISION_LAYER_FIRE;
 }
 
 void Fire::draw()
 {
 	// Bonfire model
 	std::shared_ptr<Model> model = models.at(0);
-	model->position = position;
+	model->position = getDrawPosition();
 }
 
 void Fire::createFileParticle()
@@ -58,7 +63,7 @@ void Fire::createFileParticle()
 	// Add particle scene node
 	particleSystem = smgr->addParticleSystemSceneNode(false);
 
-	// Grab the pointer, so it won't be destroyed when clearing the scene
+	// Grab the pointer, so it stays valid until this object is destroyed
 	particleSystem->grab();
 
 	// Create emitter
@@ -88,4 +93,7 @@ void Fire::createFileParticle()
 	particleSystem->setMaterialFlag(EMF_BLEND_OPERATION, true);
 	particleSystem->setMaterialTexture(0, driver->getTexture("textures/particle_fire.png"));
 	particleSystem->setMaterialType((E_MATERIAL_TYPE)getCommonBasicMaterial(EMT_TRANSPARENT_ADD_COLOR));
+
+	// Let the shared shader callback find this object
+	particleSystem->getMaterial(0).MaterialTypeParam2 = (f32)shaderInstance;
 }
\ No newline at end of file
@@ -22,6 +22,12 @@ public:
 	void update();
 	void draw();
 
+	// Collision layer
+	s32 getCollisionLayer();
+
+	// Bonfire has no state, while its particles are animated by the scene
+	bool canSleep();
+
 	// Create specialized instance
 	static std::shared_ptr<Fire> createInstance(const nlohmann::json &jsonData);
 };
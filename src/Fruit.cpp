@@ -76,6 +76,20 @@ void Fruit::update()
 		angle += 0.1f * deltaTime;
 		floatEffect += 0.05f;
 	}
+	else
+	{
+		updateGlow();
+	}
+}
+
+void Fruit::onWake(const f32 elapsed, const u32 ticks)
+{
+	// Floating advances by ticks, not by time
+	if (notPicked)
+	{
+		angle += 0.1f * elapsed;
+		floatEffect += 0.05f * ticks;
+	}
 }
 
 void Fruit::draw()
@@ -90,7 +104,7 @@ void Fruit::draw()
 		f32 topup = std::sin(floatEffect * 0.75f) * 0.5f + 0.5f;
 
 		std::shared_ptr<Model> model = models.at(0);
-		model->position = position + vector3df(0, fx, 0);
+		model->position = getDrawPosition() + vector3df(0, fx, 0);
 		model->rotation = vector3df(topup * 10.0f, angle, 0);
 	}
 }
@@ -1,17 +1,21 @@
 #include "GameObject.h"
 #include "Camera.h"
+#include "MaterialCache.h"
 
-const s32 GameObject::getCommonBasicMaterial(E_MATERIAL_TYPE basicMaterial)
-{
-	// Create basic shader
-	BasicShaderCallback* bsc = new BasicShaderCallback(this);
+f32 GameObject::interpolation = 1.0f;
 
-	IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-	s32 material = gpu->addHighLevelShaderMaterialFromFiles("shaders/standard.vs", "shaders/standard.fs", bsc, basicMaterial);
+std::vector<GameObject*> GameObject::shaderInstances = { nullptr };
+std::vector<u32> GameObject::freeShaderInstances;
 
-	bsc->drop();
+const s32 GameObject::getCommonBasicMaterial(E_MATERIAL_TYPE basicMaterial)
+{
+	return MaterialCache::singleton->getMaterial<BasicShaderCallback>("shaders/standard.vs", "shaders/standard.fs", basicMaterial);
+}
 
-	return material;
+GameObject* GameObject::getShaderInstance(const SMaterial& material)
+{
+	const u32 index = (u32)material.MaterialTypeParam2;
+	return index < shaderInstances.size() ? shaderInstances[index] : nullptr;
 }
 
 std::shared_ptr<GameObject> GameObject::createInstance(const nlohmann::json &jsonData)
@@ -64,44 +68,200 @@ GameObject::GameObject()
 	// Initialize variables
 	gameObjectIndex = 0;
 	destroy = false;
+	previousPosition = position;
+	collisionMask = 0;
+	activity.sequence = 0;
+	activity.sleeping = false;
+	activity.time = 0.0;
+	activity.tick = 0;
+	activity.wakeToken = 0;
+	worldBoundingBox.mesh = nullptr;
+	worldBoundingBox.valid = false;
+	worldBoundingBox.changed = false;
+
+	// Register for shared shader callbacks, reusing free indices
+	if (freeShaderInstances.size() > 0)
+	{
+		shaderInstance = freeShaderInstances.back();
+		freeShaderInstances.pop_back();
+		shaderInstances[shaderInstance] = this;
+	}
+	else
+	{
+		shaderInstance = (u32)shaderInstances.size();
+		shaderInstances.push_back(this);
+	}
+}
+
+GameObject::~GameObject()
+{
+	// Unregister from shared shader callbacks
+	shaderInstances[shaderInstance] = nullptr;
+	freeShaderInstances.push_back(shaderInstance);
 }
 
 void GameObject::postUpdate()
 {
 }
 
+bool GameObject::isUpdateThreadSafe()
+{
+	return false;
+}
+
+void GameObject::commit()
+{
+}
+
+s32 GameObject::getCollisionLayer()
+{
+	return COLLISION_LAYER_NONE;
+}
+
+void GameObject::onContact(const Collision& contact, const u8 state)
+{
+}
+
+bool GameObject::canSleep()
+{
+	return false;
+}
+
+f32 GameObject::getWakeDelay()
+{
+	return -1.0f;
+}
+
+void GameObject::onSleep()
+{
+}
+
+void GameObject::onWake(const f32 elapsed, const u32 ticks)
+{
+}
+
 aabbox3df GameObject::getBoundingBox()
 {
 	return models.at(0)->mesh->getBoundingBox();
 }
 
-void GameObject::applyNormalMapping(IMaterialRendererServices* services, const std::shared_ptr<Model> model)
+void GameObject::updateWorldBoundingBox()
+{
+	// World box is still valid while neither the position nor the mesh have changed
+	IAnimatedMesh* mesh = models.at(0)->mesh;
+	if (worldBoundingBox.valid && worldBoundingBox.position == position && worldBoundingBox.mesh == mesh)
+	{
+		return;
+	}
+
+	worldBoundingBox.box = getBoundingBox();
+	Utility::transformAABBox(worldBoundingBox.box, position);
+	worldBoundingBox.position = position;
+	worldBoundingBox.mesh = mesh;
+	worldBoundingBox.valid = true;
+	worldBoundingBox.changed = true;
+}
+
+const aabbox3df& GameObject::getWorldBoundingBox()
+{
+	updateWorldBoundingBox();
+	return worldBoundingBox.box;
+}
+
+bool GameObject::consumeWorldBoundingBoxChanges()
+{
+	updateWorldBoundingBox();
+
+	const bool changed = worldBoundingBox.changed;
+	worldBoundingBox.changed = false;
+	return changed;
+}
+
+void GameObject::invalidateWorldBoundingBox()
+{
+	worldBoundingBox.valid = false;
+}
+
+void GameObject::removeSceneNodes()
+{
+	for (std::shared_ptr<Model>& model : models)
+	{
+		model->removeNode();
+	}
+}
+
+vector3df GameObject::getDrawPosition()
+{
+	return position.getInterpolated(previousPosition, interpolation);
+}
+
+void GameObject::snapDrawPosition()
+{
+	previousPosition = position;
+}
+
+void GameObject::applyNormalMapping(IMaterialRendererServices* services, const NormalMappingConstants& constants, const std::shared_ptr<Model> model)
 {
-	// Apply normal map if required
-	const bool useNormalMap = model->normalMapping.textureIndex > 0;
-	services->setVertexShaderConstant("useNormalMap", &useNormalMap, 1);
-	services->setPixelShaderConstant("useNormalMap", &useNormalMap, 1);
+	// Apply normal map if required. Uniform is shared by vertex and fragment shader
+	const s32 useNormalMap = model->normalMapping.textureIndex > 0;
+	services->setPixelShaderConstant(constants.useNormalMap, &useNormalMap, 1);
 
 	// Check for normal map existance
 	if (useNormalMap)
 	{
-		const vector3df p = Camera::singleton->getPosition();
-		services->setVertexShaderConstant("eyePos", &p.X, 3);
+		services->setPixelShaderConstant(constants.lightPower, &model->normalMapping.lightPower, 1);
+		services->setPixelShaderConstant(constants.normalMap, &model->normalMapping.textureIndex, 1);
+	}
+}
 
-		const vector3df lightDir(0, -1, 1);
-		services->setVertexShaderConstant("lightDir", &lightDir.X, 3);
+void GameObject::NormalMappingConstants::resolve(IMaterialRendererServices* services)
+{
+	useNormalMap = services->getPixelShaderConstantID("useNormalMap");
+	eyePos = services->getVertexShaderConstantID("eyePos");
+	lightDir = services->getVertexShaderConstantID("lightDir");
+	eyeDir = services->getVertexShaderConstantID("eyeDir");
+	lightPower = services->getPixelShaderConstantID("lightPower");
+	normalMap = services->getPixelShaderConstantID("normalMap");
+}
 
-		const vector3df eyeDir = Camera::singleton->getLookAt() - p;
-		services->setVertexShaderConstant("eyeDir", &eyeDir.X, 3);
+void GameObject::NormalMappingConstants::setFrameConstants(IMaterialRendererServices* services)
+{
+	const vector3df p = Camera::singleton->getPosition();
+	services->setVertexShaderConstant(eyePos, &p.X, 3);
 
-		services->setPixelShaderConstant("lightPower", &model->normalMapping.lightPower, 1);
-		services->setPixelShaderConstant("normalMap", &model->normalMapping.textureIndex, 1);
-	}
+	const vector3df direction(0, -1, 1);
+	services->setVertexShaderConstant(lightDir, &direction.X, 3);
+
+	const vector3df eyeDirection = Camera::singleton->getLookAt() - p;
+	services->setVertexShaderConstant(eyeDir, &eyeDirection.X, 3);
 }
 
-GameObject::BasicShaderCallback::BasicShaderCallback(GameObject* go)
+void GameObject::NormalMappingConstants::disable(IMaterialRendererServices* services)
 {
-	this->go = go;
+	const s32 value = 0;
+	services->setPixelShaderConstant(useNormalMap, &value, 1);
+}
+
+GameObject::InstanceShaderCallback::InstanceShaderCallback()
+{
+	instance = nullptr;
+}
+
+void GameObject::InstanceShaderCallback::OnSetMaterial(const SMaterial& material)
+{
+	instance = GameObject::getShaderInstance(material);
+}
+
+void GameObject::BasicShaderCallback::resolveConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::resolveConstants(services);
+	normalMapping.resolve(services);
+}
+
+void GameObject::BasicShaderCallback::setFrameConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::setFrameConstants(services);
+	normalMapping.setFrameConstants(services);
 }
 
 void GameObject::BasicShaderCallback::OnSetConstants(IMaterialRendererServices* services, s32 userData)
@@ -110,8 +270,13 @@ void GameObject::BasicShaderCallback::OnSetConstants(IMaterialRendererServices*
 	ShaderCallback::OnSetConstants(services, userData);
 
 	// Apply normal mapping if required
-	if (go->models.size())
+	if (instance != nullptr && instance->models.size())
+	{
+		instance->applyNormalMapping(services, normalMapping, instance->models.at(0));
+	}
+	// Program is shared, so the value set for the previous object must be cleared
+	else
 	{
-		go->applyNormalMapping(services, go->models.at(0));
+		normalMapping.disable(services);
 	}
 }
\ No newline at end of file
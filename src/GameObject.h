@@ -3,6 +3,22 @@
 
 #define KEY_GOI_SKYBOX 1
 
+// Collision layers, each one holding the game objects which are queried together
+#define COLLISION_LAYER_PLAYER 0
+#define COLLISION_LAYER_SOLID 1
+#define COLLISION_LAYER_PICKUP 2
+#define COLLISION_LAYER_SPIKES 3
+#define COLLISION_LAYER_EXIT 4
+#define COLLISION_LAYER_FIRE 5
+#define COLLISION_LAYER_TELEPORTER 6
+#define COLLISION_LAYER_COUNT 7
+#define COLLISION_LAYER_NONE -1
+
+// States of a contact between two game objects, as notified by "onContact"
+#define CONTACT_ENTER 0
+#define CONTACT_STAY 1
+#define CONTACT_EXIT 2
+
 #include <vector>
 
 #include "EngineObject.h"
@@ -15,65 +31,29 @@ class GameObject : public EngineObject
 {
 protected:
 
-	// Check for collision with another game object
-	template <typename T>
-	Collision checkBoundingBoxCollision(const std::vector<std::shared_ptr<GameObject>>& gameObjects, aabbox3df& rect, const std::function<bool(GameObject* go)>& specializedCheck = nullptr)
+	// Game objects which can be read by shared shader callbacks, by their "shaderInstance" index
+	static std::vector<GameObject*> shaderInstances;
+	static std::vector<u32> freeShaderInstances;
+
+	// World bounding box, with the values it has been computed from
+	struct
 	{
-		// Create data structure to hold the return value
-		Collision collision;
-
-		// Get translated bounding box;
-		Utility::transformAABBox(rect, position);
-
-		// Check for all of the other game objects
-		for (const std::shared_ptr<GameObject> &gameObject : gameObjects)
-		{
-			// Check for class maching
-			if (dynamic_cast<T*>(gameObject.get()) == nullptr)
-			{
-				continue;
-			}
-
-			// Check if object has been destroyed
-			else if (gameObject->destroy)
-			{
-				continue;
-			}
-
-			// Check if object has any model attached
-			else if (gameObject->models.size() == 0)
-			{
-				continue;
-			}
-
-			// Get bounding box of mesh
-			aabbox3df otherBox(gameObject->getBoundingBox());
-			Utility::transformAABBox(otherBox, gameObject->position);
-
-			// Check for intersection
-			if (rect.intersectsWithBox(otherBox))
-			{
-				// Perform specialized checking if supplied
-				if (specializedCheck != nullptr && !specializedCheck(gameObject.get()))
-					continue;
-
-				// Return collision information
-				collision.engineObject = gameObject;
-				collision.mainBoundingBox = models.at(0)->mesh->getBoundingBox();
-				collision.otherBoundingBox = otherBox;
-				return collision;
-			}
-		}
-
-		// Return built object
-		return collision;
-	}
+		aabbox3df box;
+		vector3df position;
+		IAnimatedMesh* mesh;
+		bool valid;
+		bool changed;
+	} worldBoundingBox;
+
+	// Compute the world bounding box again, only if the game object has moved or changed its model since the last time
+	void updateWorldBoundingBox();
 
 public:
 
 	/*
-		Create a basic common material to apply transformation matrix in vertex shader and
+		Get a basic common material to apply transformation matrix in vertex shader and
 		basic texture mapping in fragment shader. "standard.vs" and "standard.fs" are used.
+		The material is shared among all of the game objects using the same basic material.
 
 		@param basicMaterial the basic material to create the shader from.
 
@@ -81,6 +61,16 @@ public:
 	*/
 	const s32 getCommonBasicMaterial(E_MATERIAL_TYPE basicMaterial = EMT_SOLID);
 
+	/**
+		Get the game object which owns the material being set. Materials store the "shaderInstance"
+		index of their owner in "MaterialTypeParam2", which is zero when there is no owner.
+
+		@param material the material given to "OnSetMaterial".
+
+		@return pointer to the game object, or "nullptr" if there is none.
+	*/
+	static GameObject* getShaderInstance(const SMaterial& material);
+
 	// Get instance of game object with parameters
 	static std::shared_ptr<GameObject> createInstance(const nlohmann::json &jsonData);
 
@@ -93,8 +83,31 @@ public:
 	vector3df position;
 	vector3df speed;
 
-	// Constructor
+	// Bit mask of the collision layers this game object belongs to, assigned by the room from "getCollisionLayer"
+	u32 collisionMask;
+
+	// Activity state, managed by "ActivityManager"
+	struct
+	{
+		u32 sequence;
+		bool sleeping;
+		f64 time;
+		u32 tick;
+		u32 wakeToken;
+	} activity;
+
+	// Position at the beginning of the last simulation tick
+	vector3df previousPosition;
+
+	// Fraction of tick elapsed since the last simulation tick, shared by all game objects
+	static f32 interpolation;
+
+	// Index of this game object for shared shader callbacks, which is stored in the materials of its models
+	u32 shaderInstance;
+
+	// Constructor and deconstructor
 	GameObject();
+	virtual ~GameObject();
 
 	// Update this game object
 	virtual void update() = 0;
@@ -105,29 +118,147 @@ public:
 	// All the actions performed after adding all the nodes to scene manager
 	virtual void postUpdate();
 
+	/**
+		Check if "update" can run on a worker thread, concurrently with other thread-safe updates.
+		It must only write the state of this game object, and must not touch the scene, the GUI,
+		the sounds or other game objects. Side effects can be deferred to "commit".
+
+		@return true if "update" is thread-safe, false otherwise.
+	*/
+	virtual bool isUpdateThreadSafe();
+
+	// Apply side effects deferred by a thread-safe "update", on the main thread
+	virtual void commit();
+
+	/**
+		Get the collision layer of this game object, which decides the broadphase it is registered into
+		and the contacts it takes part in.
+
+		@return one of the "COLLISION_LAYER_*" values, or "COLLISION_LAYER_NONE" if it never collides.
+	*/
+	virtual s32 getCollisionLayer();
+
+	/**
+		React to a contact with another game object, as found by "ContactManager" once per tick after all
+		of the updates. Both game objects of a pair are notified, so interactions can be handled by either one.
+		Contacts are found with a small margin around the world boxes, so game objects resting on each other
+		are in contact. Whether the boxes actually overlap is told by the "overlapping" flag of the contact.
+
+		@param contact the contact, whose "mainBoundingBox" is the world box of this game object and whose
+		"otherBoundingBox" is the world box of the other one.
+		@param state one of the "CONTACT_*" values.
+	*/
+	virtual void onContact(const Collision& contact, const u8 state);
+
+	/**
+		Check if this game object can be put to sleep when it is far from the camera. Sleeping game objects
+		are neither updated nor drawn, so their "update" must not affect anything but themselves.
+
+		@return true if this game object can sleep, false otherwise.
+	*/
+	virtual bool canSleep();
+
+	/**
+		Get the time after which a sleeping game object must be woken even if it is still far, for instance
+		to switch state with a real update, so catching up never has to replay a state change.
+
+		@return the time in milliseconds, or a negative value to wake only by distance.
+	*/
+	virtual f32 getWakeDelay();
+
+	// Called when this game object is put to sleep
+	virtual void onSleep();
+
+	/**
+		Catch up on the time spent sleeping, before the first update after waking up. The result must be
+		the same of having updated for all of the elapsed ticks, each one lasting "deltaTime".
+
+		@param elapsed the time spent sleeping, in milliseconds.
+		@param ticks the amount of simulation ticks spent sleeping.
+	*/
+	virtual void onWake(const f32 elapsed, const u32 ticks);
+
 	// Bounding box getter
 	virtual aabbox3df getBoundingBox();
 
+	// Bounding box translated to the position, which is cached until the game object moves or changes its model
+	const aabbox3df& getWorldBoundingBox();
+
+	/**
+		Check if the world bounding box has changed since the last call, then take the current one as
+		the consumed one. The game object must have at least one model.
+
+		@return true if the broadphase must be updated with the new box, false otherwise.
+	*/
+	bool consumeWorldBoundingBoxChanges();
+
+	// Compute the world bounding box again on next use, for changes of "getBoundingBox" which don't involve the model
+	void invalidateWorldBoundingBox();
+
+	// Remove the persistent scene nodes of all the models
+	void removeSceneNodes();
+
+	// Position interpolated between the previous and the current simulation tick, to be used in "draw"
+	vector3df getDrawPosition();
+
+	// Make the drawn position jump to the current one, for instance after spawning or teleporting
+	void snapDrawPosition();
+
 	// Assign common room data for GameObject
 	void assignGameObjectCommonData(const nlohmann::json& commonData);
 
+	// Uniform locations for normal mapping, resolved once per program by shader callbacks
+	struct NormalMappingConstants
+	{
+		s32 useNormalMap = -1;
+		s32 eyePos = -1;
+		s32 lightDir = -1;
+		s32 eyeDir = -1;
+		s32 lightPower = -1;
+		s32 normalMap = -1;
+
+		// Resolve uniform locations for the current program
+		void resolve(IMaterialRendererServices* services);
+
+		// Upload eye and light data, which are the same for all of the objects during a frame
+		void setFrameConstants(IMaterialRendererServices* services);
+
+		// Disable normal mapping for the object being drawn
+		void disable(IMaterialRendererServices* services);
+	};
+
 	/**
-		This method applies the routine for normal mapping, used in shader service
-		inside this GameObject's subclasses.
+		This method applies the per-object routine for normal mapping, used in shader service
+		inside this GameObject's subclasses. Eye and light data are uploaded once per frame by
+		"NormalMappingConstants::setFrameConstants".
 
 		@param services the "IMaterialRendererServices" instance passed as argument by "OnSetConstants".
+		@param constants the uniform locations for the current program.
 		@param model the model where to get the texture from.
 	*/
-	void applyNormalMapping(IMaterialRendererServices* services, const std::shared_ptr<Model> model);
+	void applyNormalMapping(IMaterialRendererServices* services, const NormalMappingConstants& constants, const std::shared_ptr<Model> model);
+
+	// ShaderCallBack shared by all of the instances, which reads the game object being drawn
+	class InstanceShaderCallback : public ShaderCallback
+	{
+	protected:
+		GameObject* instance;
+
+	public:
+		InstanceShaderCallback();
+		virtual void OnSetMaterial(const SMaterial& material);
+	};
 
 	// ShaderCallBack
-	class BasicShaderCallback : public ShaderCallback
+	class BasicShaderCallback : public InstanceShaderCallback
 	{
 	protected:
-		GameObject* go;
+		NormalMappingConstants normalMapping;
+
+		virtual void resolveConstants(IMaterialRendererServices* services);
+		virtual void setFrameConstants(IMaterialRendererServices* services);
 
 	public:
-		BasicShaderCallback(GameObject* go);
 		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
 	};
 };
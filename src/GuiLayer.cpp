@@ -0,0 +1,209 @@
+#include <cwchar>
+
+#include "GuiLayer.h"
+#include "SharedData.h"
+
+const s32 GuiLayer::ROOT_SIZE = 16384;
+
+GuiLayer::GuiLayer()
+{
+	// Create root element, owned by this layer
+	root = new IGUIElement(EGUIET_ELEMENT, guienv, nullptr, -1, recti(0, 0, ROOT_SIZE, ROOT_SIZE));
+
+	// Nothing has been drawn yet
+	dirty = true;
+}
+
+GuiLayer::~GuiLayer()
+{
+	// Children are dropped along with the root
+	root->drop();
+}
+
+IGUIElement* GuiLayer::getParent(IGUIElement* parent)
+{
+	return parent != nullptr ? parent : root;
+}
+
+IGUIElement* GuiLayer::addGroup(IGUIElement* parent)
+{
+	// Parent grabs the group
+	IGUIElement* group = new IGUIElement(EGUIET_ELEMENT, guienv, getParent(parent), -1, recti(0, 0, ROOT_SIZE, ROOT_SIZE));
+	group->drop();
+
+	dirty = true;
+	return group;
+}
+
+IGUIImage* GuiLayer::addImage(ITexture* texture, const recti& rect, IGUIElement* parent)
+{
+	IGUIImage* image = guienv->addImage(rect, getParent(parent));
+	image->setImage(texture);
+
+	dirty = true;
+	return image;
+}
+
+IGUIStaticText* GuiLayer::addText(const wchar_t* text, const recti& rect, IGUIFont* font, const EGUI_ALIGNMENT horizontal, const EGUI_ALIGNMENT vertical, IGUIElement* parent)
+{
+	IGUIStaticText* element = guienv->addStaticText(text, rect, false, true, getParent(parent));
+	element->setOverrideFont(font);
+	element->setTextAlignment(horizontal, vertical);
+
+	dirty = true;
+	return element;
+}
+
+void GuiLayer::setText(IGUIStaticText* text, const wchar_t* value)
+{
+	if (std::wcscmp(text->getText(), value) != 0)
+	{
+		text->setText(value);
+		numbers.erase(text);
+		dirty = true;
+	}
+}
+
+void GuiLayer::setNumber(IGUIStaticText* text, const s32 value, const std::wstring& prefix, const std::wstring& suffix)
+{
+	// Format the text only when the value has changed
+	const auto& iterator = numbers.find(text);
+	if (iterator != numbers.end() && iterator->second.value == value && iterator->second.prefix == prefix && iterator->second.suffix == suffix)
+	{
+		return;
+	}
+
+	Number number;
+	number.value = value;
+	number.prefix = prefix;
+	number.suffix = suffix;
+	numbers[text] = number;
+
+	text->setText((prefix + std::to_wstring(value) + suffix).c_str());
+	dirty = true;
+}
+
+void GuiLayer::setImage(IGUIImage* image, ITexture* texture)
+{
+	if (image->getImage() != texture)
+	{
+		image->setImage(texture);
+		dirty = true;
+	}
+}
+
+void GuiLayer::setColor(IGUIImage* image, const SColor& color)
+{
+	if (image->getColor() != color)
+	{
+		image->setColor(color);
+		dirty = true;
+	}
+}
+
+void GuiLayer::setColor(IGUIStaticText* text, const SColor& color)
+{
+	if (text->getOverrideColor() != color)
+	{
+		text->setOverrideColor(color);
+		dirty = true;
+	}
+}
+
+void GuiLayer::setRect(IGUIElement* element, const recti& rect)
+{
+	if (element->getRelativePosition() != rect)
+	{
+		element->setRelativePosition(rect);
+		dirty = true;
+	}
+}
+
+void GuiLayer::setVisible(IGUIElement* element, const bool visible)
+{
+	if (element->isVisible() != visible)
+	{
+		element->setVisible(visible);
+		dirty = true;
+	}
+}
+
+void GuiLayer::markDirty()
+{
+	dirty = true;
+}
+
+bool GuiLayer::isDirty()
+{
+	return dirty;
+}
+
+void GuiLayer::drawChildren(IGUIElement* element, SpriteBatch* batch)
+{
+	const core::list<IGUIElement*>& children = element->getChildren();
+	for (core::list<IGUIElement*>::ConstIterator iterator = children.begin(); iterator != children.end(); ++iterator)
+	{
+		IGUIElement* child = *iterator;
+		if (!child->isVisible())
+		{
+			continue;
+		}
+
+		if (child->getType() == EGUIET_IMAGE)
+		{
+			// Same rectangles as the ones drawn by the GUI environment
+			IGUIImage* image = (IGUIImage*)child;
+			ITexture* texture = image->getImage();
+
+			if (texture != nullptr)
+			{
+				const recti sourceRect(vector2di(0), dimension2di(texture->getOriginalSize()));
+				const recti absoluteRect = image->getAbsolutePosition();
+				const recti clipRect = image->getAbsoluteClippingRect();
+				const recti destRect = image->isImageScaled() ? absoluteRect : recti(absoluteRect.UpperLeftCorner, dimension2di(texture->getOriginalSize()));
+				batch->draw(texture, destRect, sourceRect, image->getColor(), &clipRect);
+			}
+		}
+		else if (child->getType() == EGUIET_ELEMENT)
+		{
+			// Groups have nothing to draw on their own
+			drawChildren(child, batch);
+		}
+		else if (child->getType() == EGUIET_STATIC_TEXT && ((IGUIStaticText*)child)->getActiveFont()->getType() == EGFT_CUSTOM)
+		{
+			// Glyphs of distance field fonts are queued into the same batch
+			child->draw();
+		}
+		else
+		{
+			// Keep drawing order
+			batch->flush();
+			child->draw();
+		}
+	}
+}
+
+void GuiLayer::draw()
+{
+	SpriteBatch* batch = SharedData::singleton->spriteBatch.get();
+
+	if (root->isVisible())
+	{
+		drawChildren(root, batch);
+	}
+	batch->flush();
+
+	dirty = false;
+}
+
+void GuiLayer::clear()
+{
+	// Remove children from a copy, since removal changes the list
+	const core::list<IGUIElement*> children = root->getChildren();
+	for (core::list<IGUIElement*>::ConstIterator iterator = children.begin(); iterator != children.end(); ++iterator)
+	{
+		(*iterator)->remove();
+	}
+	numbers.clear();
+	dirty = true;
+}
\ No newline at end of file
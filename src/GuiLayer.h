@@ -0,0 +1,111 @@
+#ifndef GUILAYER_H
+#define GUILAYER_H
+
+#include <string>
+#include <unordered_map>
+
+#include "EngineObject.h"
+#include "SpriteBatch.h"
+
+class GuiLayer : public EngineObject
+{
+protected:
+
+	// Size of the root element, which must cover any render target
+	static const s32 ROOT_SIZE;
+
+	// Structure for the value displayed by a numeric text
+	struct Number
+	{
+		s32 value;
+		std::wstring prefix;
+		std::wstring suffix;
+	};
+
+	/*
+		Root of the layer. It has no parent, so it's never drawn or destroyed by the GUI environment,
+		and its elements are kept alive until the layer is destroyed.
+	*/
+	IGUIElement* root;
+
+	// Some element has changed since the last draw
+	bool dirty;
+
+	// Map to hold values displayed by numeric texts, so they are formatted only when changed
+	std::unordered_map<IGUIStaticText*, Number> numbers;
+
+	// Get parent for a new element
+	IGUIElement* getParent(IGUIElement* parent);
+
+	/**
+		Draw the visible children of an element, in order. Images are queued into the sprite batch,
+		so consecutive images are drawn at once, while any other element flushes the batch first.
+
+		@param element the element whose children must be drawn.
+		@param batch the sprite batch where images are queued.
+	*/
+	void drawChildren(IGUIElement* element, SpriteBatch* batch);
+
+public:
+
+	// Constructor and deconstructor
+	GuiLayer();
+	~GuiLayer();
+
+	/**
+		Create a group of elements, which can be hidden or shown at once.
+
+		@param parent the parent group. The root of the layer is used when it's "nullptr".
+
+		@return the group element.
+	*/
+	IGUIElement* addGroup(IGUIElement* parent = nullptr);
+
+	/**
+		Create an image element.
+
+		@param texture the texture to be displayed.
+		@param rect the position and size of the image.
+		@param parent the parent group. The root of the layer is used when it's "nullptr".
+
+		@return the image element.
+	*/
+	IGUIImage* addImage(ITexture* texture, const recti& rect, IGUIElement* parent = nullptr);
+
+	/**
+		Create a text element.
+
+		@param text the text to be displayed.
+		@param rect the position and size of the text.
+		@param font the font for the text.
+		@param horizontal the horizontal alignment.
+		@param vertical the vertical alignment.
+		@param parent the parent group. The root of the layer is used when it's "nullptr".
+
+		@return the text element.
+	*/
+	IGUIStaticText* addText(const wchar_t* text, const recti& rect, IGUIFont* font, const EGUI_ALIGNMENT horizontal, const EGUI_ALIGNMENT vertical, IGUIElement* parent = nullptr);
+
+	// Setters for element properties, which mark the layer as dirty only when the value changes
+	void setText(IGUIStaticText* text, const wchar_t* value);
+	void setNumber(IGUIStaticText* text, const s32 value, const std::wstring& prefix = L"", const std::wstring& suffix = L"");
+	void setImage(IGUIImage* image, ITexture* texture);
+	void setColor(IGUIImage* image, const SColor& color);
+	void setColor(IGUIStaticText* text, const SColor& color);
+	void setRect(IGUIElement* element, const recti& rect);
+	void setVisible(IGUIElement* element, const bool visible);
+
+	// Force the layer to be drawn again
+	void markDirty();
+
+	// Check if something has changed since the last draw
+	bool isDirty();
+
+	// Draw all of the visible elements on the current render target
+	void draw();
+
+	// Remove all of the elements
+	void clear();
+};
+
+#endif // GUILAYER_H
\ No newline at end of file
@@ -27,6 +27,23 @@ Hourglass::Hourglass() : Pickup()
 void Hourglass::update()
 {
 	Pickup::update();
+
+	// Spin model
+	if (notPicked)
+	{
+		models.at(0)->rotation += vector3df(0.0625f, 0.125f, 0.25f) * deltaTime;
+	}
+}
+
+void Hourglass::onWake(const f32 elapsed, const u32 ticks)
+{
+	Pickup::onWake(elapsed, ticks);
+
+	// Catch up on spin
+	if (notPicked)
+	{
+		models.at(0)->rotation += vector3df(0.0625f, 0.125f, 0.25f) * elapsed;
+	}
 }
 
 void Hourglass::draw()
@@ -37,8 +54,7 @@ void Hourglass::draw()
 	if (notPicked)
 	{
 		std::shared_ptr<Model> &model = models.at(0);
-		model->position = position;
-		model->rotation += vector3df(0.0625f, 0.125f, 0.25f) * deltaTime;
+		model->position = getDrawPosition();
 	}
 }
 
@@ -13,6 +13,7 @@ public:
 	// Mandatory methods
 	void update();
 	void draw();
+	void onWake(const f32 elapsed, const u32 ticks);
 
 	bool pick();
 
@@ -7,6 +7,10 @@ Hud::Hud() : GameObject()
 	// Initialize font to null
 	font = nullptr;
 
+	// Elements are created on first draw
+	layer = std::make_unique<GuiLayer>();
+	mouseImage = nullptr;
+
 	// Load textures
 	mouse = driver->getTexture("textures/gui_mouse.png");
 	rectangleTexture = driver->getTexture("textures/gui_rectangle.png");
@@ -15,6 +19,15 @@ Hud::Hud() : GameObject()
 	SharedData::singleton->startFade(false, nullptr);
 }
 
+Hud::~Hud()
+{
+	// GUI RTT still holds the last drawn HUD
+	if (SharedData::singleton != nullptr)
+	{
+		SharedData::singleton->guiRttDirty = true;
+	}
+}
+
 void Hud::update()
 {
 	// Get window size
@@ -24,30 +37,33 @@ void Hud::update()
 
 void Hud::draw()
 {
-	// Render on GUI RTT
-	driver->setRenderTarget(SharedData::singleton->guiRtt);
-
 	// Load font if required
 	if (font == nullptr)
 	{
-		font = guienv->getFont(hudSize.Width > 1024 ? "fonts/titles.xml" : "fonts/titles_small.xml");
+		font = hudSize.Width > 1024 ? SharedData::singleton->titleFont : SharedData::singleton->smallTitleFont;
 	}
 
-	// Draw GUI
-	drawHud();
-
-	// Draw mouse pointer
+	// Create elements only once, with mouse pointer on top
+	if (mouseImage == nullptr)
 	{
-		recti r = Utility::getSourceRect(mouse) + mousePosition;
-		IGUIImage* image = guienv->addImage(r);
-		image->setImage(mouse);
+		createHud();
+		mouseImage = layer->addImage(mouse, Utility::getSourceRect(mouse));
 	}
 
-	// Draw GUI and Reset RTT
-	guienv->drawAll();
-	guienv->clear();
+	// Update GUI
+	drawHud();
+
+	// Move mouse pointer
+	layer->setRect(mouseImage, Utility::getSourceRect(mouse) + mousePosition);
 
-	driver->setRenderTarget(SharedData::singleton->sceneRtts, false, false);
+	// GUI RTT keeps its content between frames, so it's drawn again only when something has changed. It's missing
+	// on drivers without render targets, such as the null one
+	if (SharedData::singleton->guiRtt != nullptr && (layer->isDirty() || SharedData::singleton->guiRttDirty))
+	{
+		driver->setRenderTarget(SharedData::singleton->guiRtt, true, true, SColor(0, 0, 0, 0));
+		layer->draw();
+		driver->setRenderTarget(SharedData::singleton->sceneRtts, false, false);
+	}
 }
 
 vector2di Hud::adjustResolutionAndGetMouse()
@@ -2,6 +2,7 @@
 #define HUD_H
 
 #include "GameObject.h"
+#include "GuiLayer.h"
 
 class Hud : public GameObject
 {
@@ -14,6 +15,10 @@ protected:
 	ITexture* mouse;
 	ITexture* rectangleTexture;
 
+	// Retained elements, which are drawn on GUI RTT only when something has changed
+	std::unique_ptr<GuiLayer> layer;
+	IGUIImage* mouseImage;
+
 	// HUD and Window size
 	vector2df windowSize;
 	dimension2di hudSize;
@@ -26,11 +31,16 @@ public:
 
 	// Constructor and deconstructor
 	Hud();
+	~Hud();
 
 	// Mandatory methods
 	virtual void update();
 	void draw();
 
+	// Create the retained elements, once the font has been loaded
+	virtual void createHud() = 0;
+
+	// Update the retained elements for the current frame
 	virtual void drawHud() = 0;
 };
 
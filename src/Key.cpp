@@ -38,7 +38,7 @@ void Key::draw()
 	if (notPicked)
 	{
 		std::shared_ptr<Model> &model = models.at(0);
-		model->position = position;
+		model->position = getDrawPosition();
 		model->rotation = vector3df(0, angle, 0);
 	}
 }
@@ -19,8 +19,8 @@ MainMenu::MainMenu() : Hud()
 
 	// Create texts for options
 	optionTitles.push_back(L"Resolution");
-	optionTitles.push_back(L"SFX Volume");
-	optionTitles.push_back(L"Music Volume");
+	optionTitles.push_back(L"SFX Volume: ");
+	optionTitles.push_back(L"Music Volume: ");
 	optionTitles.push_back(L"Back");
 
 	// Create texts for levels
@@ -40,6 +40,9 @@ MainMenu::MainMenu() : Hud()
 	currentIndex = -1;
 	animation = 0;
 
+	// No video mode has been displayed yet
+	resolutionMode = -2;
+
 	roomToLoad = "";
 
 	// Fade out animation
@@ -251,6 +254,35 @@ void MainMenu::update()
 	}
 }
 
+void MainMenu::createHud()
+{
+	// Title
+	titleText = layer->addText(L"SphereBall", recti(), font, EGUIA_CENTER, EGUIA_CENTER);
+	titleText->setOverrideColor(SColor(255, 255, 255, 0));
+
+	// Main menu and options
+	for (u8 i = 0; i < optionTitles.size(); ++i)
+	{
+		optionTexts.push_back(layer->addText(optionTitles[i].c_str(), recti(), font, EGUIA_CENTER, EGUIA_CENTER));
+	}
+
+	// Level entries, with their background rectangles
+	for (u8 i = 0; i < levelTitles.size(); ++i)
+	{
+		IGUIImage* image = nullptr;
+
+		if (i >= 2)
+		{
+			image = layer->addImage(rectangleTexture, recti());
+			image->setScaleImage(true);
+			image->setColor(SColor(255, 255, 128, 128));
+		}
+
+		levelBackgrounds.push_back(image);
+		levelTexts.push_back(layer->addText(levelTitles[i].c_str(), recti(), font, i == 1 ? EGUIA_LOWERRIGHT : EGUIA_CENTER, EGUIA_CENTER));
+	}
+}
+
 void MainMenu::drawHud()
 {
 	// Reposition camera
@@ -260,27 +292,33 @@ void MainMenu::drawHud()
 	// Get animated value
 	f32 animatedValue = Utility::getCubicBezierAt(*(&vector2df(0, 1)), *(&vector2df(1, 0)), abs(animation)).X;
 
-	// Draw title
+	// Update title
 	{
 		// Compute right animated position
+		recti r = titleArea;
 		if (animation < 0)
 		{
 			s32 x = (s32)(animatedValue * (f32)hudSize.Width * (animation < 0 ? 1.0f : -1.0f));
-			titleArea.UpperLeftCorner.X += x;
-			titleArea.LowerRightCorner.X += x;
+			r.UpperLeftCorner.X += x;
+			r.LowerRightCorner.X += x;
 		}
 
-		// Create text to be drawn
-		IGUIStaticText* text = guienv->addStaticText(L"SphereBall", titleArea);
-		text->setOverrideFont(font);
-		text->setOverrideColor(SColor(255, 255, 255, 0));
-		text->setTextAlignment(EGUIA_CENTER, EGUIA_CENTER);
+		layer->setRect(titleText, r);
 	}
 
-	// Draw main menu and options
+	// Update main menu and options
 	size_t limit = animation < 0 ? optionsAreas.size() / 2 : optionsAreas.size();
-	for (s8 i = 0; i != limit; ++i)
+	for (s8 i = 0; i != optionTexts.size(); ++i)
 	{
+		IGUIStaticText* text = optionTexts[i];
+
+		// Entries of the options are hidden while choosing the level
+		layer->setVisible(text, (size_t)i < limit);
+		if ((size_t)i >= limit)
+		{
+			continue;
+		}
+
 		// Get index for menu entry
 		const s8 entryIndex = i % 4;
 
@@ -289,74 +327,73 @@ void MainMenu::drawHud()
 
 		// Compute right animated position
 		s32 x = (s32)(animatedValue * (f32)hudSize.Width * (animation < 0 ? 1.0f : -1.0f));
-		optionsAreas[i].UpperLeftCorner.X += x;
-		optionsAreas[i].LowerRightCorner.X += x;
-
-		// Get right string for text
-		std::wstring str = optionTitles[i];
+		recti r = optionsAreas[i];
+		r.UpperLeftCorner.X += x;
+		r.LowerRightCorner.X += x;
 
+		// Update text, which is formatted again only when its value changes
 		if (i == 4)
 		{
-			dimension2du* windowSize;
+			const s32 videoMode = Utility::getVideoMode(device);
+			if (videoMode != resolutionMode)
 			{
-				const s32 videoMode = Utility::getVideoMode(device);
-				windowSize = videoMode >= 0 ? &device->getVideoModeList()->getVideoModeResolution(videoMode) : nullptr;
+				const dimension2du* windowSize = videoMode >= 0 ? &device->getVideoModeList()->getVideoModeResolution(videoMode) : nullptr;
+				const std::wstring str = optionTitles[i] + (windowSize != nullptr ? L" " + std::to_wstring(windowSize->Width) + L"x" + std::to_wstring(windowSize->Height) : L" Auto");
+				layer->setText(text, str.c_str());
+				resolutionMode = videoMode;
 			}
-			str += windowSize != nullptr ? L" " + std::to_wstring(windowSize->Width) + L"x" + std::to_wstring(windowSize->Height) : L" Auto";
 		}
 		else if (i == 5 || i == 6)
 		{
 			f32 value = SoundManager::singleton->volumeLevels[i == 5 ? KEY_SETTING_SOUND : KEY_SETTING_MUSIC];
-			str += L": " + std::to_wstring((s32)(value * 0.1f));
+			layer->setNumber(text, (s32)(value * 0.1f), optionTitles[i]);
 		}
 
-		// Create text to be drawn
-		IGUIStaticText* text = guienv->addStaticText(str.c_str(), optionsAreas[i]);
-		text->setOverrideFont(font);
-		text->setOverrideColor(color);
-		text->setTextAlignment(EGUIA_CENTER, EGUIA_CENTER);
+		layer->setRect(text, r);
+		layer->setColor(text, color);
 	}
 
-	// Draw level entries
-	if (animation < 0)
+	// Update level entries
+	for (u8 i = 0; i != levelTexts.size(); ++i)
 	{
-		for (u8 i = 0; i != levelAreas.size(); ++i)
+		// Level entries are shown only while choosing the level
+		layer->setVisible(levelTexts[i], animation < 0);
+		if (levelBackgrounds[i] != nullptr)
 		{
-			// Compute final animated coordinate offset
-			s32 x = (s32)((1 - animatedValue) * (f32)hudSize.Width * -1.0f);
+			layer->setVisible(levelBackgrounds[i], animation < 0);
+		}
 
-			if (i >= 2)
-			{
-				// Background color
-				SColor bgColor = SColor(255, 128, 128, 255);
+		if (animation >= 0)
+		{
+			continue;
+		}
 
-				// Draw background rectangle
-				recti r = recti(levelAreas[i]);
-				vector2di diff = vector2di(hudSize.Height / 50, hudSize.Height / 75);
-				vector2di offset(x, 0);
+		// Compute final animated coordinate offset
+		s32 x = (s32)((1 - animatedValue) * (f32)hudSize.Width * -1.0f);
 
-				r.UpperLeftCorner += diff + offset;
-				r.LowerRightCorner += -diff + offset;
+		if (levelBackgrounds[i] != nullptr)
+		{
+			// Update background rectangle
+			recti r = recti(levelAreas[i]);
+			vector2di diff = vector2di(hudSize.Height / 50, hudSize.Height / 75);
+			vector2di offset(x, 0);
 
-				IGUIImage* image = guienv->addImage(r);
-				image->setImage(rectangleTexture);
-				image->setScaleImage(true);
-				image->setColor(SColor(255, 255, 128, 128));
-			}
+			r.UpperLeftCorner += diff + offset;
+			r.LowerRightCorner += -diff + offset;
 
-			// Foreground color
-			SColor fgColor = i == currentIndex ? SColor(255, 255, 255, 0) : SColor(255, 255, 255, 255);
+			layer->setRect(levelBackgrounds[i], r);
+		}
 
-			// Compute right animated position
-			levelAreas[i].UpperLeftCorner.X += x;
-			levelAreas[i].LowerRightCorner.X += x;
+		// Foreground color
+		SColor fgColor = i == currentIndex ? SColor(255, 255, 255, 0) : SColor(255, 255, 255, 255);
 
-			// Create text to be drawn
-			IGUIStaticText* text = guienv->addStaticText(levelTitles[i].c_str(), levelAreas[i]);
-			text->setOverrideFont(font);
-			text->setOverrideColor(fgColor);
-			text->setTextAlignment(i == 1 ? EGUIA_LOWERRIGHT : EGUIA_CENTER, EGUIA_CENTER);
-		}
+		// Compute right animated position
+		recti r = levelAreas[i];
+		r.UpperLeftCorner.X += x;
+		r.LowerRightCorner.X += x;
+
+		layer->setRect(levelTexts[i], r);
+		layer->setColor(levelTexts[i], fgColor);
 	}
 }
 
@@ -18,6 +18,15 @@ protected:
 	recti titleArea;
 	f32 animation;
 
+	// Retained elements
+	IGUIStaticText* titleText;
+	std::vector<IGUIStaticText*> optionTexts;
+	std::vector<IGUIStaticText*> levelTexts;
+	std::vector<IGUIImage*> levelBackgrounds;
+
+	// Video mode displayed by the resolution entry
+	s32 resolutionMode;
+
 	// Current selected entry index
 	s8 currentSection;
 	s8 currentIndex;
@@ -36,6 +45,7 @@ public:
 	// Mandatory methods
 	void update();
 
+	void createHud();
 	void drawHud();
 
 	// Create specialized instance
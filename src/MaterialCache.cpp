@@ -0,0 +1,49 @@
+#include "MaterialCache.h"
+#include "GameObject.h"
+#include "Solid.h"
+#include "Exit.h"
+#include "Player.h"
+#include "Pill.h"
+#include "Teleporter.h"
+
+std::shared_ptr<MaterialCache> MaterialCache::singleton = nullptr;
+
+MaterialCache::MaterialCache()
+{
+	hits = 0;
+}
+
+void MaterialCache::warmUp()
+{
+	// Common basic materials
+	getMaterial<GameObject::BasicShaderCallback>("shaders/standard.vs", "shaders/standard.fs", EMT_SOLID);
+	getMaterial<GameObject::BasicShaderCallback>("shaders/standard.vs", "shaders/standard.fs", EMT_TRANSPARENT_VERTEX_ALPHA);
+	getMaterial<GameObject::BasicShaderCallback>("shaders/standard.vs", "shaders/standard.fs", EMT_TRANSPARENT_ADD_COLOR);
+
+	// Blocks
+	getMaterial<Solid::SpecializedShaderCallback>("shaders/standard.vs", "shaders/standard.fs", EMT_SOLID);
+	getMaterial<Solid::SpecializedShaderCallback>("shaders/glass.vs", "shaders/glass.fs", EMT_TRANSPARENT_VERTEX_ALPHA, true);
+	getMaterial<Solid::SpecializedShaderCallback>("shaders/standard.vs", "shaders/delayed.fs", EMT_TRANSPARENT_VERTEX_ALPHA);
+
+	// Other game objects
+	getMaterial<Exit::SpecializedShaderCallback>("shaders/standard.vs", "shaders/exit.fs", EMT_TRANSPARENT_ALPHA_CHANNEL);
+	getMaterial<Player::SpecializedShaderCallback>("shaders/standard.vs", "shaders/player.fs", EMT_TRANSPARENT_VERTEX_ALPHA);
+	getMaterial<Pill::PillShaderCallback>("shaders/pill.vs", "shaders/pill.fs", EMT_SOLID);
+	getMaterial<Teleporter::SpecializedShaderCallback>("shaders/standard.vs", "shaders/teleporter.fs", EMT_SOLID);
+	getMaterial<ShaderCallback>("shaders/standard.vs", "shaders/bonfire.fs", EMT_SOLID, true);
+}
+
+bool MaterialCache::writesEffectMask(const s32 material)
+{
+	return effectMaskMaterials.find(material) != effectMaskMaterials.end();
+}
+
+u32 MaterialCache::getMaterialCount()
+{
+	return (u32)materials.size();
+}
+
+u32 MaterialCache::getHitCount()
+{
+	return hits;
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef MATERIALCACHE_H
+#define MATERIALCACHE_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+
+#include "EngineObject.h"
+
+class MaterialCache : public EngineObject
+{
+protected:
+
+	// Programs are shared among materials with the same shaders, base material and callback class
+	typedef std::tuple<std::string, std::string, E_MATERIAL_TYPE, std::type_index> Key;
+
+	// Map to hold material indices, by their key
+	std::map<Key, s32> materials;
+
+	// Amount of requests served without compiling a new program
+	u32 hits;
+
+	// Materials whose fragment shader writes heat wave or glass into the post-processing mask
+	std::set<s32> effectMaskMaterials;
+
+public:
+
+	// Singleton holder
+	static std::shared_ptr<MaterialCache> singleton;
+
+	// Constructor
+	MaterialCache();
+
+	/**
+		Get the material for the requested shaders, compiling and linking the program only the first time.
+		The callback class is instantiated once for all of the objects sharing the material, so it must read
+		per-object data from the object being drawn, which is given by "OnSetMaterial".
+
+		@param vertexShader path to the vertex shader file.
+		@param fragmentShader path to the fragment shader file.
+		@param baseMaterial the basic material to create the shader from.
+		@param writesEffectMask true if the fragment shader writes heat wave or glass into the post-processing mask.
+
+		@return material index to be used on mesh nodes. It's -1 if the driver can't compile the program.
+	*/
+	template <typename T>
+	s32 getMaterial(const std::string& vertexShader, const std::string& fragmentShader, const E_MATERIAL_TYPE baseMaterial = EMT_SOLID, const bool writesEffectMask = false)
+	{
+		// Check if program has already been compiled
+		const Key key(vertexShader, fragmentShader, baseMaterial, std::type_index(typeid(T)));
+
+		const auto& iterator = materials.find(key);
+		if (iterator != materials.end())
+		{
+			++hits;
+			return iterator->second;
+		}
+
+		// Compile program, whose material renderer keeps the callback alive
+		T* callback = new T();
+
+		IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
+		const s32 material = gpu->addHighLevelShaderMaterialFromFiles(vertexShader.c_str(), fragmentShader.c_str(), callback, baseMaterial);
+
+		callback->drop();
+
+		#if NDEBUG || _DEBUG
+		printf("MaterialCache - Compiled %s + %s as material %d\n", vertexShader.c_str(), fragmentShader.c_str(), material);
+		#endif
+
+		// Failures are stored too, so they are not retried for every object
+		materials[key] = material;
+
+		if (material != -1 && writesEffectMask)
+		{
+			effectMaskMaterials.insert(material);
+		}
+		return material;
+	}
+
+	// Compile all of the programs used by game objects, so rooms don't stall on their first load
+	void warmUp();
+
+	/**
+		Check if drawing with the material requires the mask-based effects of post-processing.
+
+		@param material the material index.
+
+		@return true if the material writes heat wave or glass into the post-processing mask.
+	*/
+	bool writesEffectMask(const s32 material);
+
+	// Amount of compiled programs
+	u32 getMaterialCount();
+
+	// Amount of requests served from the cache
+	u32 getHitCount();
+};
+
+#endif // MATERIALCACHE_H
\ No newline at end of file
@@ -5,6 +5,16 @@ Model::Model()
 	textures = std::unordered_map<u32, ITexture*>();
 	material = -1;
 	currentFrame = 0.0f;
+	isStatic = false;
+	shaderInstance = 0;
+
+	// Node is created lazily by the engine
+	node = nullptr;
+	dirtyFlags = KEY_MODEL_DIRTY_ALL;
+	batched = false;
+
+	// World bounding box is computed on first use
+	world.valid = false;
 }
 
 Model::Model(IAnimatedMesh* mesh) : Model()
@@ -18,15 +28,236 @@ Model::Model(Model* model)
 {
 	// Assign mesh
 	this->mesh = model->mesh;
+	boundingBox = model->boundingBox;
 
 	// Initialize members
 	textures = std::unordered_map<u32, ITexture*>(model->textures);
 	material = model->material;
 
 	currentFrame = 0.0f;
+	isStatic = model->isStatic;
+	shaderInstance = model->shaderInstance;
+
+	// Scene node is never shared between models
+	node = nullptr;
+	dirtyFlags = KEY_MODEL_DIRTY_ALL;
+	batched = false;
+
+	// World bounding box is computed on first use
+	world.valid = false;
+}
+
+Model::~Model()
+{
+	removeNode();
 }
 
 void Model::addTexture(u32 layer, ITexture* texture)
 {
 	textures[layer] = texture;
+	dirtyFlags |= KEY_MODEL_DIRTY_TEXTURES;
+}
+
+void Model::markDirty(u8 flags)
+{
+	dirtyFlags |= flags;
+}
+
+ISceneNode* Model::getNode()
+{
+	return node;
+}
+
+matrix4 Model::getTransformation()
+{
+	matrix4 transformation;
+	transformation.setRotationDegrees(rotation);
+	transformation.setTranslation(position);
+
+	matrix4 scaling;
+	scaling.setScale(scale);
+	transformation *= scaling;
+
+	return transformation;
+}
+
+const aabbox3df& Model::getWorldBoundingBox()
+{
+	// Models which didn't move, rotate nor scale skip the transformation
+	if (!world.valid || world.position != position || world.rotation != rotation || world.scale != scale || world.boundingBox != boundingBox)
+	{
+		world.box = boundingBox;
+		getTransformation().transformBoxEx(world.box);
+		world.boundingBox = boundingBox;
+		world.position = position;
+		world.rotation = rotation;
+		world.scale = scale;
+		world.valid = true;
+	}
+
+	return world.box;
+}
+
+void Model::attachNode(ISceneNode* node)
+{
+	// Release the previous node, if any
+	removeNode();
+
+	// Grab the pointer, so it won't be destroyed with the scene
+	this->node = node;
+	if (node != nullptr)
+	{
+		node->grab();
+	}
+
+	// Everything must be applied to the new node
+	dirtyFlags = KEY_MODEL_DIRTY_ALL;
+}
+
+void Model::removeNode()
+{
+	if (node != nullptr)
+	{
+		node->remove();
+		node->drop();
+		node = nullptr;
+	}
+}
+
+void Model::syncNode()
+{
+	// Nothing to synchronize
+	if (node == nullptr)
+	{
+		return;
+	}
+
+	// Detect changes on plain properties
+	detectChanges();
+
+	// Check if node is up to date
+	if (dirtyFlags == 0)
+	{
+		return;
+	}
+
+	// Sky box only follows rotation and material
+	if (node->getType() == ESNT_SKY_BOX)
+	{
+		if (dirtyFlags & KEY_MODEL_DIRTY_TRANSFORM)
+		{
+			node->setRotation(rotation);
+		}
+
+		if (dirtyFlags & KEY_MODEL_DIRTY_MATERIAL)
+		{
+			node->setMaterialType((E_MATERIAL_TYPE)material);
+			node->setMaterialFlag(EMF_BLEND_OPERATION, true);
+			node->setMaterialFlag(EMF_LIGHTING, false);
+			applyShaderInstance();
+		}
+	}
+	// Animated mesh
+	else
+	{
+		if (dirtyFlags & KEY_MODEL_DIRTY_TRANSFORM)
+		{
+			node->setPosition(position);
+			node->setRotation(rotation);
+			node->setScale(scale);
+		}
+
+		// Set current frame position
+		if (dirtyFlags & KEY_MODEL_DIRTY_FRAME && node->getType() == ESNT_ANIMATED_MESH)
+		{
+			((IAnimatedMeshSceneNode*)node)->setCurrentFrame(currentFrame);
+		}
+
+		// Apply texture to all layers
+		if (dirtyFlags & KEY_MODEL_DIRTY_TEXTURES)
+		{
+			for (auto &entry : textures)
+			{
+				node->setMaterialTexture(entry.first, entry.second);
+				node->setMaterialFlag(EMF_LIGHTING, false);
+				node->setMaterialFlag(EMF_NORMALIZE_NORMALS, true);
+			}
+		}
+
+		// Set material type, if available
+		if (dirtyFlags & KEY_MODEL_DIRTY_MATERIAL && material != -1)
+		{
+			node->setMaterialType((E_MATERIAL_TYPE)material);
+			node->setMaterialFlag(EMF_BLEND_OPERATION, true);
+			applyShaderInstance();
+		}
+	}
+
+	// Store synchronized values
+	storeSynced();
+}
+
+void Model::applyShaderInstance()
+{
+	for (u32 i = 0; i < node->getMaterialCount(); ++i)
+	{
+		node->getMaterial(i).MaterialTypeParam2 = (f32)shaderInstance;
+	}
+}
+
+void Model::detectChanges()
+{
+	if (position != synced.position || rotation != synced.rotation || scale != synced.scale)
+	{
+		dirtyFlags |= KEY_MODEL_DIRTY_TRANSFORM;
+	}
+	if (currentFrame != synced.currentFrame)
+	{
+		dirtyFlags |= KEY_MODEL_DIRTY_FRAME;
+	}
+	if (material != synced.material)
+	{
+		dirtyFlags |= KEY_MODEL_DIRTY_MATERIAL;
+	}
+}
+
+void Model::storeSynced()
+{
+	synced.position = position;
+	synced.rotation = rotation;
+	synced.scale = scale;
+	synced.material = material;
+	synced.currentFrame = currentFrame;
+	dirtyFlags = 0;
+}
+
+void Model::setBatched(bool batched)
+{
+	this->batched = batched;
+
+	if (batched)
+	{
+		// Geometry is drawn by the batch from now on
+		removeNode();
+		storeSynced();
+	}
+	else
+	{
+		// Node will be created again by the engine
+		dirtyFlags = KEY_MODEL_DIRTY_ALL;
+	}
+}
+
+bool Model::isBatched()
+{
+	return batched;
+}
+
+bool Model::consumeBatchChanges()
+{
+	detectChanges();
+
+	const bool changed = dirtyFlags != 0;
+	storeSynced();
+	return changed;
 }
\ No newline at end of file
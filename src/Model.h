@@ -1,6 +1,12 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#define KEY_MODEL_DIRTY_TRANSFORM	0x01
+#define KEY_MODEL_DIRTY_FRAME		0x02
+#define KEY_MODEL_DIRTY_TEXTURES	0x04
+#define KEY_MODEL_DIRTY_MATERIAL	0x08
+#define KEY_MODEL_DIRTY_ALL			0x0F
+
 #include <memory>
 #include <unordered_map>
 #include <irrlicht.h>
@@ -12,6 +18,47 @@ using namespace video;
 
 class Model
 {
+protected:
+
+	// Persistent scene node owned by this model
+	ISceneNode* node;
+
+	// Properties which must be synchronized to the scene node
+	u8 dirtyFlags;
+
+	// Geometry is merged into a static batch instead of owning a scene node
+	bool batched;
+
+	// Values applied to the scene node during the last synchronization
+	struct
+	{
+		vector3df position;
+		vector3df rotation;
+		vector3df scale;
+		s32 material;
+		f32 currentFrame;
+	} synced;
+
+	// World bounding box, with the values it has been computed from
+	struct
+	{
+		aabbox3df box;
+		aabbox3df boundingBox;
+		vector3df position;
+		vector3df rotation;
+		vector3df scale;
+		bool valid;
+	} world;
+
+	// Compare plain properties against the last synchronized values and mark the changed ones
+	void detectChanges();
+
+	// Store current values as synchronized and clear dirty flags
+	void storeSynced();
+
+	// Store the owner index into the materials of the scene node
+	void applyShaderInstance();
+
 public:
 	/**
 		This structure indicates the normal map texture index in the "textures" map of the model
@@ -34,13 +81,73 @@ public:
 	s32 material;
 	f32 currentFrame;
 
-	// Constructor
+	// Model never moves nor animates, so its geometry can be merged with other static models
+	bool isStatic;
+
+	// Index of the owning game object, which shared shader callbacks read from the material
+	u32 shaderInstance;
+
+	// Constructor and deconstructor
 	Model();
 	Model(Model* model);
 	Model(IAnimatedMesh* mesh);
+	~Model();
+
+	// Scene node is owned by a single model, so models can't be copied. Use the "Model(Model*)" constructor instead
+	Model(const Model&) = delete;
+	Model& operator=(const Model&) = delete;
 
 	// Texture adder for layer
 	void addTexture(u32 layer, ITexture* texture);
+
+	// Mark properties to be synchronized on the next "syncNode" call
+	void markDirty(u8 flags);
+
+	// Scene node getter
+	ISceneNode* getNode();
+
+	// Build the world transformation, the same way scene nodes do
+	matrix4 getTransformation();
+
+	// Bounding box transformed into world space, which is cached until the box or the transform change
+	const aabbox3df& getWorldBoundingBox();
+
+	/**
+		Attach the persistent scene node for this model. The node is grabbed, so it survives until
+		"removeNode" is called or the model is destroyed. All of its properties are marked as dirty.
+
+		@param node the scene node created for this model.
+	*/
+	void attachNode(ISceneNode* node);
+
+	// Remove the scene node from the scene graph and release it
+	void removeNode();
+
+	/**
+		Apply to the scene node only the properties which have changed since the last call.
+		Transform, frame and material are compared against the last synchronized values, while
+		textures must be marked dirty through "addTexture" or "markDirty".
+	*/
+	void syncNode();
+
+	/**
+		Mark this model as merged into a static batch. A batched model has no scene node of its own,
+		so the one it had, if any, is removed.
+
+		@param batched true when the geometry has been merged, false when it has been released.
+	*/
+	void setBatched(bool batched);
+
+	// Check if geometry is merged into a static batch
+	bool isBatched();
+
+	/**
+		Check if any property has changed since the geometry has been merged into the static batch,
+		then take the current values as the merged ones.
+
+		@return true if the static batch holding this model must be rebuilt, false otherwise.
+	*/
+	bool consumeBatchChanges();
 };
 
 #endif // MODEL_H
\ No newline at end of file
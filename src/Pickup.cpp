@@ -26,6 +26,34 @@ void Pickup::update()
 	{
 		angle += 0.25f * deltaTime;
 	}
+	else
+	{
+		updateGlow();
+	}
+}
+
+bool Pickup::isUpdateThreadSafe()
+{
+	return true;
+}
+
+bool Pickup::canSleep()
+{
+	// Glow must fade out, so the item is destroyed
+	return notPicked;
+}
+
+void Pickup::onWake(const f32 elapsed, const u32 ticks)
+{
+	if (notPicked)
+	{
+		angle += 0.25f * elapsed;
+	}
+}
+
+s32 Pickup::getCollisionLayer()
+{
+	return COLLISION_LAYER_PICKUP;
 }
 
 void Pickup::draw()
@@ -34,20 +62,26 @@ void Pickup::draw()
 	if (!notPicked)
 	{
 		std::shared_ptr<Model> &model = models.at(0);
-		model->position = position;
+		model->position = getDrawPosition();
 		model->rotation = vector3df(0, angle, 0);
+	}
+}
+
+void Pickup::updateGlow()
+{
+	// Grow, then shrink, the glow plane
+	std::shared_ptr<Model> &model = models.at(0);
 
-		f32 s = (angle > 0.5f ? -0.05f : 0.05f) * deltaTime;
-		model->scale += vector3df(s, s, 0);
+	f32 s = (angle > 0.5f ? -0.05f : 0.05f) * deltaTime;
+	model->scale += vector3df(s, s, 0);
 
-		if (model->scale.X >= 16)
-		{
-			angle = 1;
-		}
-		else if (model->scale.X <= 0)
-		{
-			destroy = true;
-		}
+	if (model->scale.X >= 16)
+	{
+		angle = 1;
+	}
+	else if (model->scale.X <= 0)
+	{
+		destroy = true;
 	}
 }
 
@@ -69,24 +103,4 @@ bool Pickup::pick()
 	
 	// Item is already picked
 	return true;
-}
-
-Pickup::SpecializedShaderCallback::SpecializedShaderCallback(Pickup* pickup)
-{
-	this->pickup = pickup;
-}
-
-void Pickup::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServices* services, s32 userData)
-{
-	// Execute parent method
-	ShaderCallback::OnSetConstants(services, userData);
-
-	// Set shader values
-	if (pickup->notPicked)
-	{
-		f32 shaderValues[1] = { pickup->angle };
-		s32 layer0 = 0;
-		services->setPixelShaderConstant("tex", (s32*)&layer0, 1);
-		services->setPixelShaderConstant("angle", shaderValues, 1);
-	}
 }
\ No newline at end of file
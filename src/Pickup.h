@@ -3,7 +3,6 @@
 
 #include "GameObject.h"
 #include "EventManager.h"
-#include "ShaderCallback.h"
 
 class Pickup : public GameObject
 {
@@ -13,6 +12,9 @@ protected:
 	// Plane model
 	std::shared_ptr<Model> planeModel;
 
+	// Animate glow plane after the item has been picked
+	void updateGlow();
+
 public:
 
 	// Specialized variables
@@ -26,19 +28,18 @@ public:
 	virtual void update();
 	virtual void draw();
 
-	// Specialized methods
-	virtual bool pick();
+	// All of the pickups share the same collision layer
+	virtual s32 getCollisionLayer();
 
-	// ShaderCallBack
-	class SpecializedShaderCallback : public ShaderCallback
-	{
-	protected:
-		Pickup* pickup;
+	// Pickups only animate themselves, since picking is performed by the player
+	virtual bool isUpdateThreadSafe();
 
-	public:
-		SpecializedShaderCallback(Pickup* coin);
-		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
-	};
+	// Far pickups sleep until they are picked, catching up on their spin when woken
+	virtual bool canSleep();
+	virtual void onWake(const f32 elapsed, const u32 ticks);
+
+	// Specialized methods
+	virtual bool pick();
 };
 
 #endif // PICKUP_H
\ No newline at end of file
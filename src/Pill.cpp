@@ -1,6 +1,7 @@
 #include "Pill.h"
 #include "SharedData.h"
 #include "SoundManager.h"
+#include "MaterialCache.h"
 
 using nlohmann::json;
 
@@ -33,12 +34,7 @@ Pill::Pill(u8 type) : Pickup()
 	ITexture* texture = driver->getTexture("textures/lethargy_pill.png");
 
 	// Create fake lighting from shader
-	PillShaderCallback* ssc = new PillShaderCallback(this);
-
-	IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-	customMaterial = gpu->addHighLevelShaderMaterialFromFiles("shaders/pill.vs", "shaders/pill.fs", ssc);
-
-	ssc->drop();
+	customMaterial = MaterialCache::singleton->getMaterial<PillShaderCallback>("shaders/pill.vs", "shaders/pill.fs");
 
 	// Create model for player
 	std::shared_ptr<Model> model = std::make_shared<Model>(mesh);
@@ -50,6 +46,23 @@ Pill::Pill(u8 type) : Pickup()
 void Pill::update()
 {
 	Pickup::update();
+
+	// Spin model
+	if (notPicked)
+	{
+		models.at(0)->rotation += vector3df(0.125f, 0.25f, 0.5f) * deltaTime;
+	}
+}
+
+void Pill::onWake(const f32 elapsed, const u32 ticks)
+{
+	Pickup::onWake(elapsed, ticks);
+
+	// Catch up on spin
+	if (notPicked)
+	{
+		models.at(0)->rotation += vector3df(0.125f, 0.25f, 0.5f) * elapsed;
+	}
 }
 
 void Pill::draw()
@@ -58,8 +71,7 @@ void Pill::draw()
 
 	// Exit model
 	std::shared_ptr<Model> model = models.at(0);
-	model->position = position;
-	model->rotation += vector3df(0.125f, 0.25f, 0.5f) * deltaTime;
+	model->position = getDrawPosition();
 }
 
 bool Pill::pick()
@@ -84,9 +96,15 @@ bool Pill::pick()
 	return false;
 }
 
-Pill::PillShaderCallback::PillShaderCallback(Pill* pill)
+Pill::PillShaderCallback::PillShaderCallback()
+{
+	positionId = -1;
+}
+
+void Pill::PillShaderCallback::resolveConstants(IMaterialRendererServices* services)
 {
-	this->pill = pill;
+	ShaderCallback::resolveConstants(services);
+	positionId = services->getPixelShaderConstantID("position");
 }
 
 void Pill::PillShaderCallback::OnSetConstants(IMaterialRendererServices* services, s32 userData)
@@ -94,10 +112,13 @@ void Pill::PillShaderCallback::OnSetConstants(IMaterialRendererServices* service
 	// Execute parent method
 	ShaderCallback::OnSetConstants(services, userData);
 
-	// Set texture layer
-	s32 layer0 = 0;
-	services->setPixelShaderConstant("tex", (s32*)&layer0, 1);
+	// Get pill being drawn
+	Pill* pill = static_cast<Pill*>(instance);
+	if (pill == nullptr)
+	{
+		return;
+	}
 
 	// Set position
-	services->setPixelShaderConstant("position", &pill->position.X, 3);
+	services->setPixelShaderConstant(positionId, &pill->position.X, 3);
 }
\ No newline at end of file
@@ -25,6 +25,7 @@ public:
 	// Mandatory methods
 	void update();
 	void draw();
+	void onWake(const f32 elapsed, const u32 ticks);
 
 	bool pick();
 
@@ -32,13 +33,15 @@ public:
 	static std::shared_ptr<Pill> createInstance(const nlohmann::json &jsonData);
 
 	// ShaderCallBack
-	class PillShaderCallback : public ShaderCallback
+	class PillShaderCallback : public InstanceShaderCallback
 	{
 	protected:
-		Pill* pill;
+		s32 positionId;
+
+		virtual void resolveConstants(IMaterialRendererServices* services);
 
 	public:
-		PillShaderCallback(Pill* pill);
+		PillShaderCallback();
 		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
 	};
 };
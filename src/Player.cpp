@@ -5,6 +5,7 @@
 #include "SoundManager.h"
 #include "SharedData.h"
 #include "Camera.h"
+#include "MaterialCache.h"
 
 #include "Utility.h"
 #include "Solid.h"
@@ -18,6 +19,7 @@
 #include "Teleporter.h"
 
 const f32 Player::breathingDelta = 0.125f;
+const f32 Player::supportDistance = 0.05f;
 
 std::shared_ptr<Player> Player::createInstance(const nlohmann::json &jsonData)
 {
@@ -27,12 +29,7 @@ std::shared_ptr<Player> Player::createInstance(const nlohmann::json &jsonData)
 Player::Player() : GameObject()
 {
 	// Load custom shader for player
-	SpecializedShaderCallback* ssc = new SpecializedShaderCallback(this);
-
-	IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-	customMaterial = gpu->addHighLevelShaderMaterialFromFiles("shaders/standard.vs", "shaders/player.fs", ssc, EMT_TRANSPARENT_VERTEX_ALPHA);
-
-	ssc->drop();
+	customMaterial = MaterialCache::singleton->getMaterial<SpecializedShaderCallback>("shaders/standard.vs", "shaders/player.fs", EMT_TRANSPARENT_VERTEX_ALPHA);
 
 	// Load model for player
 	IAnimatedMesh* mesh = smgr->getMesh("models/sphere.obj");
@@ -65,6 +62,7 @@ Player::Player() : GameObject()
 	breathingSpeed = 0.001f;
 
 	fireFactor = 0.0f;
+	fireTouched = false;
 
 	playerScale = 1.0f;
 
@@ -92,12 +90,6 @@ Player::Player() : GameObject()
 		return ((Solid*)go)->isSolid();
 	};
 
-	collisionChecks["solidTop"] = [this](GameObject* go)
-	{
-		Solid* solid = (Solid*)go;
-		return solid->position.Y + 1.0f < position.Y && solid->isSolid();
-	};
-
 	collisionChecks["pickup"] = [](GameObject* go)
 	{
 		return ((Pickup*)go)->notPicked;
@@ -216,8 +208,9 @@ void Player::update()
 			// Make electric ball invisible
 			models.at(1)->scale = vector3df(0);
 
-			// Restore player
+			// Restore player, without interpolating across the warp
 			position = warpingPosition;
+			snapDrawPosition();
 			state = STATE_WALKING;
 
 			// Start fade out
@@ -242,8 +235,16 @@ void Player::update()
 	// sf::Listener::setPosition(Utility::irrVectorToSf(position));
 }
 
+s32 Player::getCollisionLayer()
+{
+	return COLLISION_LAYER_PLAYER;
+}
+
 void Player::draw()
 {
+	// Get interpolated position
+	const vector3df drawPosition = getDrawPosition();
+
 	// Update model
 	if (models.size() > 0)
 	{
@@ -253,12 +254,12 @@ void Player::draw()
 		if (state == STATE_DEAD)
 		{
 			std::shared_ptr<Model> model = models.at(0);
-			model->position = position + vector3df(0, 0, -11);
+			model->position = drawPosition + vector3df(0, 0, -11);
 		}
 		else // if (state == STATE_WALKING)
 		{
 			// Update model parameters
-			model->position = position;
+			model->position = drawPosition;
 			model->rotation = vector3df(0);
 
 			// Update matrix for shader
@@ -271,7 +272,7 @@ void Player::draw()
 			{
 				f32 time = (f32)device->getTimer()->getTime();
 				model2->rotation = vector3df(0, 0, std::floorf(time / 40.0f) * 90.0f);
-				model2->position = position;
+				model2->position = drawPosition;
 			}
 		}
 	}
@@ -279,9 +280,9 @@ void Player::draw()
 	// Reposition camera
 	if (state != STATE_FELLOFF)
 	{
-		Camera::singleton->setPosition(position + cameraDistance);
+		Camera::singleton->setPosition(drawPosition + cameraDistance);
 	}
-	Camera::singleton->setLookAt(position);
+	Camera::singleton->setLookAt(drawPosition);
 }
 
 s32 Player::getJumpingState()
@@ -316,6 +317,7 @@ void Player::updateTransformMatrix()
 {
 	// Get required values
 	f32 height = models.at(0)->mesh->getBoundingBox().getExtent().Y;
+	const vector3df drawPosition = getDrawPosition();
 	f32 phaseAngle = (f32)std::sin(breathing);
 
 	f32 scaleHeight = phaseAngle * breathingDelta + (1.0f - breathingDelta);
@@ -323,7 +325,7 @@ void Player::updateTransformMatrix()
 
 	// Rotation
 	matrix4 rotation;
-	rotation.setRotationDegrees(vector3df(-45.0f, 0.0f, -position.X * 3.0f));
+	rotation.setRotationDegrees(vector3df(-45.0f, 0.0f, -drawPosition.X * 3.0f));
 
 	// Scaling
 	matrix4 scaling;
@@ -332,7 +334,7 @@ void Player::updateTransformMatrix()
 
 	// Translation
 	matrix4 translation;
-	translation.setTranslation(position);
+	translation.setTranslation(drawPosition);
 
 	// Final matrix
 	transformMatrix = translation * scaling * rotation;
@@ -446,34 +448,38 @@ void Player::walk()
 		speed.Y = -4.0f;
 	}
 
-	// Affect position by speed
-	position += speed * deltaTime;
+	// Sweep the box against solids along the motion of this tick, sliding along the hit faces.
+	// Solids are collected by a single broadphase query and by tile lookups, so fast falls can't skip through them
+	vector3df motion = speed * deltaTime;
+	position.Z += motion.Z;
+
+	aabbox3df box(bbox);
+	Utility::transformAABBox(box, position);
+	solidSweep.collect(RoomManager::singleton->getCollisionLayer(COLLISION_LAYER_SOLID), RoomManager::singleton->getTileMap(), box, motion, supportDistance, collisionChecks["solid"]);
 
-	// Check collision on top and bottom side
-	for (s8 i = 0, j = 1; i < 2; ++i, j -= 2)
+	bool landed = false;
+	for (u8 i = 0; i < 3 && (motion.X != 0.0f || motion.Y != 0.0f); ++i)
 	{
-		if (i && speed.Y > 0)
-		{
-			continue;
-		}
-		else if (!i && speed.Y <= 0)
+		// Move until the earliest impact
+		Collision collision = solidSweep.cast(box, motion);
+		const vector3df travel(motion.X * collision.time, motion.Y * collision.time, 0.0f);
+		position += travel;
+		box.MinEdge += travel;
+		box.MaxEdge += travel;
+
+		if (collision.engineObject == nullptr)
 		{
-			continue;
+			break;
 		}
 
-		// Get shifted BB
-		aabbox3df rect(bbox);
-		Utility::getVerticalAABBox(bbox, rect, (1.0f + (0.25f * std::abs(speed.Y))) * j, 0.75f - std::abs(speed.X * 2));
+		// Keep the rest of the motion, along the hit face
+		motion = vector3df(motion.X, motion.Y, 0.0f) * (1.0f - collision.time);
 
-		// Check for collision
-		Collision collision = checkBoundingBoxCollision<Solid>(RoomManager::singleton->gameObjects, rect, collisionChecks[i ? "solidTop" : "solid"]);
-		if (collision.engineObject != nullptr)
+		// Check collision on top and bottom side
+		if (collision.normal.Y != 0.0f)
 		{
-			// Cast to game object
-			std::shared_ptr<GameObject> go = collision.getGameObject<Solid>();
-
 			// Motion effects
-			if ((!i && speed.Y > 0.001) || (i && speed.Y < -0.001))
+			if ((collision.normal.Y < 0.0f && speed.Y > 0.001) || (collision.normal.Y > 0.0f && speed.Y < -0.001))
 			{
 				// Play sound
 				playAudio(KEY_SOUND_BOUNCE);
@@ -484,71 +490,83 @@ void Player::walk()
 
 			// Stop vertical movement
 			speed.Y = 0;
+			motion.Y = 0;
 
-			// Reposition object correctly
-			if (i)
+			// Land on floor, or start falling from ceiling
+			if (collision.normal.Y > 0.0f)
 			{
-				position.Y = go->position.Y + bbox.getExtent().Y;
 				falling = 0;
+				landed = true;
 			}
 			else
 			{
-				position.Y = go->position.Y - collision.otherBoundingBox.getExtent().Y;
 				falling = 1;
 				fallLine = nullptr;
 			}
 		}
-		else if (i)
+		// Check collision on left and right side
+		else
 		{
-			falling = 1;
+			// Play sound
+			if (std::abs(speed.X) > 0.05f)
+			{
+				playAudio(KEY_SOUND_BOUNCE);
+			}
+
+			// Stop horizontal movement
+			speed.X = 0;
+			motion.X = 0;
 		}
 	}
 
-	// Check collision on left and right side
-	for (s8 i = 0, j = -1; i < 2; ++i, j += 2)
+	// Check for ground below, when not moving upwards
+	if (!landed && speed.Y <= 0)
 	{
-		if (i && speed.X <= 0)
+		Collision collision = solidSweep.findSupport(box, supportDistance);
+		if (collision.engineObject != nullptr)
 		{
-			continue;
+			// Stand on top of it
+			position.Y += collision.otherBoundingBox.MaxEdge.Y - box.MinEdge.Y;
+			speed.Y = 0;
+			falling = 0;
 		}
-		else if (!i && speed.X >= 0)
+		else
 		{
-			continue;
+			falling = 1;
 		}
+	}
 
-		// Get shifted BB
-		aabbox3df rect(bbox);
-		Utility::getHorizontalAABBox(bbox, rect, (0.85f + (0.1f * std::abs(speed.X))) * j, 0.9f);
-
-		// Check for collision
-		Collision collision = checkBoundingBoxCollision<Solid>(RoomManager::singleton->gameObjects, rect, collisionChecks["solid"]);
-		if (collision.engineObject != nullptr)
+	// Lower fire effect, when no fire has been touched by the last contact pass
+	if (state == STATE_WALKING && !fireTouched && fireFactor > 0.0f && !falling && speed.Y == 0.0f)
+	{
+		fireFactor -= 0.001f * deltaTime;
+		if (fireFactor < 0)
 		{
-			// Cast to game object
-			std::shared_ptr<GameObject> go = collision.getGameObject<GameObject>();
-
-			// Play sound
-			if ((!i && speed.X < -0.05) || (i && speed.X > 0.05))
-			{
-				playAudio(KEY_SOUND_BOUNCE);
-			}
-
-			// Reposition object correctly
-			position.X = go->position.X;
-			position.X += (i ? -bbox.getExtent().X : collision.otherBoundingBox.getExtent().X) * 0.9f;
-			speed.X = 0;
+			fireFactor = 0;
 		}
 	}
+	fireTouched = false;
+}
+
+void Player::onContact(const Collision& contact, const u8 contactState)
+{
+	// Only ongoing contacts are reacted to, while walking
+	if (contactState == CONTACT_EXIT || state != STATE_WALKING)
+	{
+		return;
+	}
+
+	// Get main model bounding box
+	const aabbox3df bbox = models.at(0)->mesh->getBoundingBox();
+	const std::shared_ptr<GameObject> other = contact.getGameObject<GameObject>();
 
 	// Check collision with pickup
-	if (state == STATE_WALKING)
+	if (other->collisionMask & (1 << COLLISION_LAYER_PICKUP))
 	{
-		aabbox3df rect(bbox);
-		Collision collision = checkBoundingBoxCollision<Pickup>(RoomManager::singleton->gameObjects, rect, collisionChecks["pickup"]);
-		if (collision.engineObject != nullptr)
+		if (collisionChecks["pickup"](other.get()) && contact.overlapping)
 		{
 			// Trigger pick
-			std::shared_ptr<Pickup> pickup = collision.getGameObject<Pickup>();
+			std::shared_ptr<Pickup> pickup = contact.getGameObject<Pickup>();
 			pickup->pick();
 
 			// Play audio
@@ -557,13 +575,13 @@ void Player::walk()
 	}
 
 	// Check collision with spikes
-	if (state == STATE_WALKING)
+	else if (other->collisionMask & (1 << COLLISION_LAYER_SPIKES))
 	{
 		aabbox3df rect(bbox);
 		Utility::transformAABBox(rect, vector3df(0), vector3df(0), vector3df(0.75f, 0.85f, 1.0f));
+		Utility::transformAABBox(rect, position);
 
-		Collision collision = checkBoundingBoxCollision<Spikes>(RoomManager::singleton->gameObjects, rect, collisionChecks["spikes"]);
-		if (collision.engineObject != nullptr)
+		if (collisionChecks["spikes"](other.get()) && rect.intersectsWithBox(contact.otherBoundingBox))
 		{
 			playAudio(KEY_SOUND_NAILED);
 			die();
@@ -571,16 +589,16 @@ void Player::walk()
 	}
 
 	// Check collision with exit
-	if (state == STATE_WALKING && !falling && speed.Y == 0.0f)
+	else if (other->collisionMask & (1 << COLLISION_LAYER_EXIT))
 	{
 		// Check for score
-		if (SharedData::singleton->getGameScoreValue(KEY_SCORE_KEY_PICKED) == SharedData::singleton->getGameScoreValue(KEY_SCORE_KEY_TOTAL))
+		if (!falling && speed.Y == 0.0f && SharedData::singleton->getGameScoreValue(KEY_SCORE_KEY_PICKED) == SharedData::singleton->getGameScoreValue(KEY_SCORE_KEY_TOTAL))
 		{
 			aabbox3df rect(bbox);
 			Utility::transformAABBox(rect, vector3df(0), vector3df(0), vector3df(0.9f, 0.8f, 0.8f));
+			Utility::transformAABBox(rect, position);
 
-			Collision collision = checkBoundingBoxCollision<Exit>(RoomManager::singleton->gameObjects, rect);
-			if (collision.engineObject != nullptr)
+			if (rect.intersectsWithBox(contact.otherBoundingBox))
 			{
 				// Play sound
 				playAudio(KEY_SOUND_EXITED);
@@ -591,21 +609,20 @@ void Player::walk()
 				// Change state
 				state = STATE_EXITED;
 
-				std::shared_ptr<Exit> exit = collision.getGameObject<Exit>();
+				std::shared_ptr<Exit> exit = contact.getGameObject<Exit>();
 				exitedPosition = exit->position;
 				exit->fade();
 			}
 		}
 	}
 
-	// Check collision with fire
-	if (state == STATE_WALKING)
+	// Check collision with fire, which affects player once per tick
+	else if (other->collisionMask & (1 << COLLISION_LAYER_FIRE))
 	{
-		// Affect player
-		aabbox3df rect(bbox);
-		Collision collision = checkBoundingBoxCollision<Fire>(RoomManager::singleton->gameObjects, rect);
-		if (collision.engineObject != nullptr)
+		if (!fireTouched && contact.overlapping)
 		{
+			fireTouched = true;
+
 			// Raise fire effect
 			fireFactor += 0.001f * deltaTime;
 
@@ -619,42 +636,35 @@ void Player::walk()
 				state = STATE_BURNED;
 			}
 		}
-		// Lower fire effect
-		else if (fireFactor > 0.0f && !falling && speed.Y == 0.0f)
-		{
-			fireFactor -= 0.001f * deltaTime;
-			if (fireFactor < 0)
-			{
-				fireFactor = 0;
-			}
-		}
 	}
 
 	// Check collision with teleporter
-	if (state == STATE_WALKING && !falling && speed == vector3df(0))
+	else if (other->collisionMask & (1 << COLLISION_LAYER_TELEPORTER))
 	{
-		// Get shifted BB
-		aabbox3df rect(bbox);
-		Utility::getHorizontalAABBox(bbox, rect, 0);
-
-		// Check collision
-		Collision collision = checkBoundingBoxCollision<Teleporter>(RoomManager::singleton->gameObjects, rect);
-		if (collision.engineObject != nullptr)
+		if (!falling && speed == vector3df(0))
 		{
-			// Trigger alarm
-			teleportAlarm = std::make_unique<Alarm>(600.0f);
+			// Get shifted BB
+			aabbox3df rect(bbox);
+			Utility::getHorizontalAABBox(bbox, rect, 0);
+			Utility::transformAABBox(rect, position);
 
-			// Play sound
-			playAudio(KEY_SOUND_TELEPORT);
+			if (rect.intersectsWithBox(contact.otherBoundingBox))
+			{
+				// Trigger alarm
+				teleportAlarm = std::make_unique<Alarm>(600.0f);
+
+				// Play sound
+				playAudio(KEY_SOUND_TELEPORT);
 
-			// Make electric ball visible
-			models.at(1)->scale = vector3df(1);
+				// Make electric ball visible
+				models.at(1)->scale = vector3df(1);
 
-			// Change player state
-			std::shared_ptr<Teleporter> teleporter = collision.getGameObject<Teleporter>();
-			warpingTeleporter = teleporter->position + vector3df(0, 10, 0);
-			warpingPosition = teleporter->warp;
-			state = STATE_TELEPORT;
+				// Change player state
+				std::shared_ptr<Teleporter> teleporter = contact.getGameObject<Teleporter>();
+				warpingTeleporter = teleporter->position + vector3df(0, 10, 0);
+				warpingPosition = teleporter->warp;
+				state = STATE_TELEPORT;
+			}
 		}
 	}
 }
@@ -765,13 +775,32 @@ void Player::resetBreathing()
 	breathing += ((f32)std::cos(-1) - breathing) * 0.005f * deltaTime;
 }
 
-Player::SpecializedShaderCallback::SpecializedShaderCallback(Player* player)
+Player::SpecializedShaderCallback::SpecializedShaderCallback()
 {
-	this->player = player;
+	fireFactorId = -1;
+	noiseFactorId = -1;
+	noiseTextureId = -1;
+}
+
+void Player::SpecializedShaderCallback::resolveConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::resolveConstants(services);
+
+	fireFactorId = services->getPixelShaderConstantID("fireFactor");
+	noiseFactorId = services->getPixelShaderConstantID("noiseFactor");
+	noiseTextureId = services->getPixelShaderConstantID("noiseTexture");
 }
 
 void Player::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServices* services, s32 userData)
 {
+	// Get player being drawn
+	Player* player = static_cast<Player*>(instance);
+	if (player == nullptr)
+	{
+		ShaderCallback::OnSetConstants(services, userData);
+		return;
+	}
+
 	// Set custom world matrix. After restore the original one
 	matrix4 etsWorld = driver->getTransform(ETS_WORLD);
 	driver->setTransform(ETS_WORLD, player->transformMatrix);
@@ -779,14 +808,14 @@ void Player::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServices
 	driver->setTransform(ETS_WORLD, etsWorld);
 
 	// Setup fire effect
-	services->setPixelShaderConstant("fireFactor", (f32*)&this->player->fireFactor, 1);
+	services->setPixelShaderConstant(fireFactorId, (f32*)&player->fireFactor, 1);
 
 	// Setup timeout effect
-	services->setPixelShaderConstant("noiseFactor", (f32*)&this->player->noiseFactor, 1);
+	services->setPixelShaderConstant(noiseFactorId, (f32*)&player->noiseFactor, 1);
 
-	if (this->player->state == STATE_TIME_OUT)
+	if (player->state == STATE_TIME_OUT)
 	{
 		const s32 layer1 = 1;
-		services->setPixelShaderConstant("noiseTexture", (s32*)&layer1, 1);
+		services->setPixelShaderConstant(noiseTextureId, (s32*)&layer1, 1);
 	}
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 #include "GameObject.h"
 #include "Alarm.h"
+#include "Sweep.h"
 #include "ShaderCallback.h"
 
 class Player : public GameObject
@@ -20,6 +21,9 @@ protected:
 	// Constants
 	const static f32 breathingDelta;
 
+	// Maximum gap under the player for a solid to hold it
+	const static f32 supportDistance;
+
 	// State
 	s8 state;
 	f32 noiseFactor;
@@ -48,6 +52,7 @@ protected:
 
 	// Behaviour
 	f32 fireFactor;
+	bool fireTouched;
 
 	// State change alarms
 	std::unique_ptr<Alarm> dieAlarm;
@@ -58,23 +63,15 @@ protected:
 	vector3df warpingTeleporter;
 	vector3df warpingPosition;
 
+	// Sweep against solids, whose storage is reused by every tick
+	Sweep solidSweep;
+
 	// Custom collision check function
 	std::unordered_map<std::string, std::function<bool(GameObject* go)>> collisionChecks;
 
 	// Update transform matrix
 	void updateTransformMatrix();
 
-	// ShaderCallBack
-	class SpecializedShaderCallback : public ShaderCallback
-	{
-	protected:
-		Player* player;
-
-	public:
-		SpecializedShaderCallback(Player* coin);
-		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
-	};
-
 public:
 
 	// Constructor
@@ -84,6 +81,12 @@ public:
 	void update();
 	void draw();
 
+	// Collision layer
+	s32 getCollisionLayer();
+
+	// React to pickups, spikes, exits, fires and teleporters
+	void onContact(const Collision& contact, const u8 contactState);
+
 	/*
 		Check if the player is walking / standing on a solid platform, if it's jumping or
 		if it's falling. Jumping and falling state are almost the same, so if you have to
@@ -107,6 +110,21 @@ public:
 
 	// Create specialized instance
 	static std::shared_ptr<Player> createInstance(const nlohmann::json &jsonData);
+
+	// ShaderCallBack
+	class SpecializedShaderCallback : public InstanceShaderCallback
+	{
+	protected:
+		s32 fireFactorId;
+		s32 noiseFactorId;
+		s32 noiseTextureId;
+
+		virtual void resolveConstants(IMaterialRendererServices* services);
+
+	public:
+		SpecializedShaderCallback();
+		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
+	};
 };
 
 #endif // PLAYER_H
\ No newline at end of file
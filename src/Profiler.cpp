@@ -0,0 +1,137 @@
+#include "Profiler.h"
+
+#ifdef SPHEREBALL_PROFILER
+
+#include <ctime>
+#include <fstream>
+
+const u32 Profiler::DEFAULT_CAPTURE_FRAMES = 600;
+std::shared_ptr<Profiler> Profiler::singleton = nullptr;
+
+Profiler::Profiler()
+{
+	// Initialize variables
+	epoch = std::chrono::steady_clock::now();
+	capturing = false;
+	framesLeft = 0;
+}
+
+u32 Profiler::getThreadIndex()
+{
+	static std::atomic<u32> threadCount(0);
+	thread_local u32 threadIndex = threadCount++;
+	return threadIndex;
+}
+
+void Profiler::startCapture(u32 frames)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	events.clear();
+	framesLeft = frames;
+	capturing = true;
+}
+
+bool Profiler::stopCapture(const std::string& path)
+{
+	// Stop recording
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!capturing)
+		{
+			return false;
+		}
+		capturing = false;
+	}
+
+	// Build file name, if not supplied
+	if (path.length() > 0)
+	{
+		return writeTrace(path);
+	}
+	return writeTrace("profile_" + std::to_string((u32)std::time(nullptr)) + ".json");
+}
+
+bool Profiler::isCapturing()
+{
+	return capturing;
+}
+
+void Profiler::endFrame()
+{
+	if (!capturing)
+	{
+		return;
+	}
+
+	// Check if all the requested frames have been recorded
+	bool completed;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		completed = framesLeft <= 1;
+		--framesLeft;
+	}
+
+	if (completed)
+	{
+		stopCapture();
+	}
+}
+
+void Profiler::record(const char* name, const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end)
+{
+	// Build event, with times in microseconds
+	Event event;
+	event.name = name;
+	event.start = std::chrono::duration<f64, std::micro>(start - epoch).count();
+	event.duration = std::chrono::duration<f64, std::micro>(end - start).count();
+	event.threadIndex = getThreadIndex();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (capturing)
+	{
+		events.push_back(event);
+	}
+}
+
+bool Profiler::writeTrace(const std::string& path)
+{
+	std::ofstream output(path);
+	if (!output.is_open())
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Write complete events ("ph" = "X"), zone names are string literals, so they need no escaping
+	output << "{\"traceEvents\":[";
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		const Event& event = events[i];
+		output << (i ? ",\n" : "\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.threadIndex << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+	}
+	output << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	events.clear();
+	return output.good();
+}
+
+Profiler::Zone::Zone(const char* name)
+{
+	this->name = name;
+	active = Profiler::singleton != nullptr && Profiler::singleton->isCapturing();
+	if (active)
+	{
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+Profiler::Zone::~Zone()
+{
+	if (active)
+	{
+		Profiler::singleton->record(name, start, std::chrono::steady_clock::now());
+	}
+}
+
+#endif // SPHEREBALL_PROFILER
\ No newline at end of file
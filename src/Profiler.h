@@ -0,0 +1,104 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef SPHEREBALL_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+
+// Open a zone which lasts until the end of the enclosing scope
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(profilerZone, __LINE__)(name)
+
+class Profiler
+{
+protected:
+
+	// Structure for a single completed zone
+	struct Event
+	{
+		const char* name;
+		f64 start;
+		f64 duration;
+		u32 threadIndex;
+	};
+
+	// Time origin for all the events
+	std::chrono::steady_clock::time_point epoch;
+
+	// Events recorded during the current capture
+	std::mutex mutex;
+	std::vector<Event> events;
+
+	// Capture state
+	std::atomic<bool> capturing;
+	u32 framesLeft;
+
+	// Get a small index for the calling thread
+	static u32 getThreadIndex();
+
+	// Write the recorded events as Chrome trace JSON
+	bool writeTrace(const std::string& path);
+
+public:
+
+	// Default values
+	static const u32 DEFAULT_CAPTURE_FRAMES;
+
+	// Singleton pattern
+	static std::shared_ptr<Profiler> singleton;
+
+	// Constructor
+	Profiler();
+
+	// Start recording zones for the given amount of frames
+	void startCapture(u32 frames = DEFAULT_CAPTURE_FRAMES);
+
+	/**
+		Stop recording zones and write them to a file, which can be loaded by "chrome://tracing"
+		or by the Perfetto UI.
+
+		@param path the path of the file to write. When empty, a name based on the current time is used.
+
+		@return true if the file has been written, false otherwise.
+	*/
+	bool stopCapture(const std::string& path = "");
+
+	// Check if zones are being recorded
+	bool isCapturing();
+
+	// Count a completed frame, stopping the capture when all the requested frames have been recorded
+	void endFrame();
+
+	// Record a completed zone
+	void record(const char* name, const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end);
+
+	// Scoped zone, to be used through the "PROFILE_ZONE" macro
+	class Zone
+	{
+	protected:
+		const char* name;
+		std::chrono::steady_clock::time_point start;
+		bool active;
+
+	public:
+		Zone(const char* name);
+		~Zone();
+	};
+};
+
+#else
+
+#define PROFILE_ZONE(name)
+
+#endif // SPHEREBALL_PROFILER
+
+#endif // PROFILER_H
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "QueryStamp.h"
+
+QueryStamp::QueryStamp()
+{
+	reset();
+}
+
+void QueryStamp::reset()
+{
+	stamp = 0;
+}
+
+void QueryStamp::next(const std::function<void()>& clearItems)
+{
+	if (++stamp == 0)
+	{
+		clearItems();
+		stamp = 1;
+	}
+}
+
+bool QueryStamp::mark(u32& itemStamp)
+{
+	if (itemStamp == stamp)
+	{
+		return false;
+	}
+
+	itemStamp = stamp;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef QUERYSTAMP_H
+#define QUERYSTAMP_H
+
+#include <functional>
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+
+class QueryStamp
+{
+protected:
+
+	// Stamp of the running query. Zero is never used, so items whose stamp is zero are never collected
+	u32 stamp;
+
+public:
+
+	// Constructor
+	QueryStamp();
+
+	// Forget the running query, since all of the items it stamped are gone
+	void reset();
+
+	/**
+		Start a new query.
+
+		@param clearItems function setting the stamp of every item to zero. It's only called when the
+		counter wraps around, since items stamped long ago could be mistaken for collected ones.
+	*/
+	void next(const std::function<void()>& clearItems);
+
+	/**
+		Stamp an item with the running query.
+
+		@param itemStamp the stamp of the item.
+
+		@return true if the item wasn't stamped by the running query yet, so it has to be collected.
+	*/
+	bool mark(u32& itemStamp);
+};
+
+#endif // QUERYSTAMP_H
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include <algorithm>
+
+#include "RenderQueue.h"
+#include "Camera.h"
+#include "MaterialCache.h"
+
+const u32 RenderQueue::DEPTH_BITS = 24;
+const u32 RenderQueue::TEXTURE_SET_BITS = 24;
+
+RenderQueue::RenderQueue(ISceneNode* parent, ISceneManager* smgr, s32 id) : ISceneNode(parent, smgr, id)
+{
+	// Queue is always registered, while its nodes are culled by the engine
+	setAutomaticCulling(EAC_OFF);
+	aabb.reset(0, 0, 0);
+
+	// Initialize variables
+	sorted = true;
+	effectMask = false;
+	drawCount = 0;
+	programChanges = 0;
+	textureChanges = 0;
+	unsortedProgramChanges = 0;
+	unsortedTextureChanges = 0;
+}
+
+RenderQueue::~RenderQueue()
+{
+	reset();
+}
+
+void RenderQueue::reset()
+{
+	// Release queued nodes
+	for (Entry& entry : opaque)
+	{
+		entry.node->drop();
+	}
+	for (Entry& entry : transparent)
+	{
+		entry.node->drop();
+	}
+
+	opaque.clear();
+	transparent.clear();
+	textureSets.clear();
+	sorted = false;
+	effectMask = false;
+}
+
+RenderQueue::Entry RenderQueue::createEntry(ISceneNode* node, const SMaterial& material, const f32 distance, const bool isTransparent)
+{
+	Entry entry;
+	entry.node = node;
+	entry.program = (s32)material.MaterialType;
+
+	// Find identifier for the texture set
+	std::array<ITexture*, MATERIAL_MAX_TEXTURES> textures;
+	for (u32 i = 0; i < MATERIAL_MAX_TEXTURES; ++i)
+	{
+		textures[i] = material.getTexture(i);
+	}
+
+	const auto& iterator = textureSets.find(textures);
+	if (iterator != textureSets.end())
+	{
+		entry.textureSet = iterator->second;
+	}
+	else
+	{
+		entry.textureSet = (u32)textureSets.size();
+		textureSets[textures] = entry.textureSet;
+	}
+
+	// Quantize distance to camera, one step for every world unit
+	const u64 maxDepth = ((u64)1 << DEPTH_BITS) - 1;
+	const u64 depth = std::min((u64)std::max(distance, 0.0f), maxDepth);
+
+	// Opaque draws are grouped by program, then by texture set, then front-to-back
+	entry.key = ((u64)(u32)entry.program << (DEPTH_BITS + TEXTURE_SET_BITS)) | ((u64)entry.textureSet << DEPTH_BITS) | depth;
+
+	// Transparent draws are strictly back-to-front
+	if (isTransparent)
+	{
+		entry.key = maxDepth - depth;
+	}
+
+	return entry;
+}
+
+void RenderQueue::add(ISceneNode* node)
+{
+	// Node is hidden to the scene manager, so its transformation must be updated here
+	node->updateAbsolutePosition();
+	const f32 distance = (f32)Camera::singleton->getPosition().getDistanceFrom(node->getTransformedBoundingBox().getCenter());
+
+	// Find the first material for each pass
+	const SMaterial* opaqueMaterial = nullptr;
+	const SMaterial* transparentMaterial = nullptr;
+	IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	for (u32 i = 0; i < node->getMaterialCount(); ++i)
+	{
+		const SMaterial& material = node->getMaterial(i);
+		IMaterialRenderer* renderer = driver->getMaterialRenderer(material.MaterialType);
+
+		// Post-processing must read the mask
+		if (MaterialCache::singleton->writesEffectMask(material.MaterialType))
+		{
+			effectMask = true;
+		}
+
+		if (renderer != nullptr && renderer->isTransparent())
+		{
+			if (transparentMaterial == nullptr)
+			{
+				transparentMaterial = &material;
+			}
+		}
+		else if (opaqueMaterial == nullptr)
+		{
+			opaqueMaterial = &material;
+		}
+	}
+
+	// Node draws only the buffers matching the current pass
+	if (opaqueMaterial != nullptr)
+	{
+		node->grab();
+		opaque.push_back(createEntry(node, *opaqueMaterial, distance, false));
+	}
+	if (transparentMaterial != nullptr)
+	{
+		node->grab();
+		transparent.push_back(createEntry(node, *transparentMaterial, distance, true));
+	}
+
+	sorted = false;
+}
+
+void RenderQueue::countStateChanges(const std::vector<const Entry*>& entries, u32& programs, u32& textures)
+{
+	const Entry* previous = nullptr;
+
+	for (const Entry* entry : entries)
+	{
+		if (previous == nullptr || previous->program != entry->program)
+		{
+			++programs;
+		}
+		if (previous == nullptr || previous->textureSet != entry->textureSet)
+		{
+			++textures;
+		}
+		previous = entry;
+	}
+}
+
+void RenderQueue::sort()
+{
+	// Collect draws in submission order, solid pass first, like the scene manager does
+	std::vector<const Entry*> order;
+	order.reserve(opaque.size() + transparent.size());
+
+	for (const Entry& entry : opaque)
+	{
+		order.push_back(&entry);
+	}
+	for (const Entry& entry : transparent)
+	{
+		order.push_back(&entry);
+	}
+
+	unsortedProgramChanges = 0;
+	unsortedTextureChanges = 0;
+	countStateChanges(order, unsortedProgramChanges, unsortedTextureChanges);
+
+	// Sort draws, keeping submission order between equal keys, so the result is deterministic
+	const auto compare = [](const Entry& a, const Entry& b)
+	{
+		return a.key < b.key;
+	};
+	std::stable_sort(opaque.begin(), opaque.end(), compare);
+	std::stable_sort(transparent.begin(), transparent.end(), compare);
+
+	// Count state changes of the sorted draws
+	order.clear();
+	for (const Entry& entry : opaque)
+	{
+		order.push_back(&entry);
+	}
+	for (const Entry& entry : transparent)
+	{
+		order.push_back(&entry);
+	}
+
+	programChanges = 0;
+	textureChanges = 0;
+	countStateChanges(order, programChanges, textureChanges);
+
+	drawCount = (u32)order.size();
+	sorted = true;
+}
+
+void RenderQueue::OnRegisterSceneNode()
+{
+	if (!IsVisible)
+	{
+		return;
+	}
+
+	// Sort once per frame, before any pass is drawn
+	if (!sorted)
+	{
+		sort();
+	}
+
+	// Register only the passes which have something to draw
+	if (opaque.size() > 0)
+	{
+		SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+	}
+	if (transparent.size() > 0)
+	{
+		SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+	}
+}
+
+void RenderQueue::render()
+{
+	// Draw the list of the current pass
+	const std::vector<Entry>& entries = SceneManager->getSceneNodeRenderPass() == ESNRP_TRANSPARENT ? transparent : opaque;
+
+	for (const Entry& entry : entries)
+	{
+		entry.node->render();
+	}
+}
+
+const aabbox3df& RenderQueue::getBoundingBox() const
+{
+	return aabb;
+}
+
+bool RenderQueue::hasEffectMask()
+{
+	return effectMask;
+}
+
+u32 RenderQueue::getDrawCount()
+{
+	return drawCount;
+}
+
+u32 RenderQueue::getProgramChanges()
+{
+	return programChanges;
+}
+
+u32 RenderQueue::getTextureChanges()
+{
+	return textureChanges;
+}
+
+u32 RenderQueue::getUnsortedProgramChanges()
+{
+	return unsortedProgramChanges;
+}
+
+u32 RenderQueue::getUnsortedTextureChanges()
+{
+	return unsortedTextureChanges;
+}
\ No newline at end of file
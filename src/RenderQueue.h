@@ -0,0 +1,118 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <array>
+#include <map>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+
+class RenderQueue : public ISceneNode
+{
+protected:
+
+	// Structure for a single queued draw
+	struct Entry
+	{
+		ISceneNode* node;
+		u64 key;
+		s32 program;
+		u32 textureSet;
+	};
+
+	// Bits of the sort key reserved to the depth
+	static const u32 DEPTH_BITS;
+
+	// Bits of the sort key reserved to the texture set
+	static const u32 TEXTURE_SET_BITS;
+
+	// Draws of the solid and of the transparent pass
+	std::vector<Entry> opaque;
+	std::vector<Entry> transparent;
+
+	// Texture sets met during the current frame, compacted into small identifiers
+	std::map<std::array<ITexture*, MATERIAL_MAX_TEXTURES>, u32> textureSets;
+
+	// Queue must be sorted before being drawn
+	bool sorted;
+
+	// Some queued material writes heat wave or glass into the post-processing mask
+	bool effectMask;
+
+	// Not needed, since the queue is never culled
+	aabbox3df aabb;
+
+	// Counters for the last sorted frame
+	u32 drawCount;
+	u32 programChanges;
+	u32 textureChanges;
+	u32 unsortedProgramChanges;
+	u32 unsortedTextureChanges;
+
+	/**
+		Create the entry for a node, whose sort key is built from the given material.
+
+		@param node the scene node to be drawn.
+		@param material the first material of the node drawn in the pass.
+		@param distance the distance between the node and the camera.
+		@param isTransparent true if the entry belongs to the transparent pass.
+
+		@return the entry for the queue of the pass.
+	*/
+	Entry createEntry(ISceneNode* node, const SMaterial& material, const f32 distance, const bool isTransparent);
+
+	/**
+		Count how many times the shader program and the texture set change between consecutive draws.
+
+		@param entries the draws, in submission order.
+		@param programs the counter where to add program changes.
+		@param textures the counter where to add texture set changes.
+	*/
+	static void countStateChanges(const std::vector<const Entry*>& entries, u32& programs, u32& textures);
+
+	// Sort draws and update counters
+	void sort();
+
+public:
+
+	// Constructor and deconstructor
+	RenderQueue(ISceneNode* parent, ISceneManager* smgr, s32 id);
+	~RenderQueue();
+
+	// Drop all of the queued draws, before submitting a new frame
+	void reset();
+
+	/**
+		Queue a scene node, which must be hidden to the scene manager, so it's drawn only once.
+		The node is queued to the solid pass, to the transparent pass or to both of them, according
+		to its materials, and it's kept alive until the next reset.
+
+		@param node the scene node to be drawn during the current frame.
+	*/
+	void add(ISceneNode* node);
+
+	// Scene node methods
+	virtual void OnRegisterSceneNode();
+	virtual void render();
+	virtual const aabbox3df& getBoundingBox() const;
+
+	// Check if some draw of the current frame writes heat wave or glass into the post-processing mask
+	bool hasEffectMask();
+
+	// Amount of draws submitted during the last frame
+	u32 getDrawCount();
+
+	// Shader program and texture set changes between the draws of the last frame
+	u32 getProgramChanges();
+	u32 getTextureChanges();
+
+	// State changes the same draws would have required in submission order
+	u32 getUnsortedProgramChanges();
+	u32 getUnsortedTextureChanges();
+};
+
+#endif // RENDERQUEUE_H
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "RenderTargetPool.h"
+
+RenderTargetPool::RenderTargetPool(IVideoDriver* driver)
+{
+	// Assign driver
+	this->driver = driver;
+
+	// Initialize counters
+	frameAllocations = 0;
+	lastFrameAllocations = 0;
+	totalAllocations = 0;
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+	clear();
+}
+
+ITexture* RenderTargetPool::acquire(const std::string& name, const dimension2du& size, const ECOLOR_FORMAT format, bool* reallocated)
+{
+	// Check if the pooled render target can be reused
+	const auto& iterator = entries.find(name);
+	if (iterator != entries.end())
+	{
+		Entry& entry = iterator->second;
+		if (entry.size == size && entry.format == format)
+		{
+			if (reallocated != nullptr)
+			{
+				*reallocated = false;
+			}
+			return entry.texture;
+		}
+
+		// Size or format has changed, so the old texture is no longer valid
+		if (entry.texture != nullptr)
+		{
+			driver->removeTexture(entry.texture);
+		}
+		entries.erase(iterator);
+	}
+
+	// Allocate the new render target
+	Entry entry;
+	entry.texture = driver->addRenderTargetTexture(size, name.c_str(), format);
+	entry.size = size;
+	entry.format = format;
+	entries[name] = entry;
+
+	// Update counters
+	++frameAllocations;
+	++totalAllocations;
+
+	if (reallocated != nullptr)
+	{
+		*reallocated = true;
+	}
+	return entry.texture;
+}
+
+void RenderTargetPool::release(const std::string& name)
+{
+	const auto& iterator = entries.find(name);
+	if (iterator != entries.end())
+	{
+		if (iterator->second.texture != nullptr)
+		{
+			driver->removeTexture(iterator->second.texture);
+		}
+		entries.erase(iterator);
+	}
+}
+
+void RenderTargetPool::clear()
+{
+	for (auto& entry : entries)
+	{
+		if (entry.second.texture != nullptr)
+		{
+			driver->removeTexture(entry.second.texture);
+		}
+	}
+	entries.clear();
+}
+
+void RenderTargetPool::endFrame()
+{
+	lastFrameAllocations = frameAllocations;
+	frameAllocations = 0;
+}
+
+u32 RenderTargetPool::getFrameAllocations()
+{
+	return lastFrameAllocations;
+}
+
+u32 RenderTargetPool::getTotalAllocations()
+{
+	return totalAllocations;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef RENDERTARGETPOOL_H
+#define RENDERTARGETPOOL_H
+
+#include <string>
+#include <unordered_map>
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+class RenderTargetPool
+{
+protected:
+
+	// Structure for a single pooled render target
+	struct Entry
+	{
+		ITexture* texture;
+		dimension2du size;
+		ECOLOR_FORMAT format;
+	};
+
+	// Video driver which owns the textures
+	IVideoDriver* driver;
+
+	// Map to hold render targets, by their slot name
+	std::unordered_map<std::string, Entry> entries;
+
+	// Allocation counters
+	u32 frameAllocations;
+	u32 lastFrameAllocations;
+	u32 totalAllocations;
+
+public:
+
+	// Constructor and deconstructor
+	RenderTargetPool(IVideoDriver* driver);
+	~RenderTargetPool();
+
+	/**
+		Get the render target for the requested slot. The texture is allocated only when the slot
+		is empty or when the requested size or color format differs from the pooled one, so the
+		same texture is returned frame after frame while the window size stays the same.
+
+		@param name the slot name, which is also used as the texture name inside the driver.
+		@param size the required size for the render target.
+		@param format the required color format for the render target.
+		@param reallocated optional pointer which is set to "true" when a new texture has been created.
+
+		@return pointer to the render target texture. It can be "nullptr" if the driver does not support RTTs.
+	*/
+	ITexture* acquire(const std::string& name, const dimension2du& size, const ECOLOR_FORMAT format = ECF_A8R8G8B8, bool* reallocated = nullptr);
+
+	// Release a single slot
+	void release(const std::string& name);
+
+	// Release all of the pooled render targets
+	void clear();
+
+	// Close allocation accounting for the current frame
+	void endFrame();
+
+	// Allocations performed during the last completed frame
+	u32 getFrameAllocations();
+
+	// Allocations performed since the pool has been created
+	u32 getTotalAllocations();
+};
+
+#endif // RENDERTARGETPOOL_H
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <fstream>
 #include "RoomManager.h"
 #include "SharedData.h"
@@ -16,11 +17,14 @@
 #include "Fire.h"
 #include "Teleporter.h"
 #include "Editor.h"
+#include "Profiler.h"
 
 std::shared_ptr<RoomManager> RoomManager::singleton = nullptr;
 
 const std::string RoomManager::LEVEL_PREFIX = "level_";
 
+const f32 RoomManager::BROADPHASE_CELL_SIZE = 40.0f;
+
 const std::string RoomManager::ROOM_MAIN_MENU = "main_menu";
 const std::string RoomManager::ROOM_EDITOR = "editor";
 
@@ -34,6 +38,18 @@ RoomManager::RoomManager()
 	// Create vector to hold game objects
 	gameObjects = std::vector<std::shared_ptr<GameObject>>();
 
+	// Create static batch for room geometry
+	staticBatch = std::make_unique<StaticBatch>();
+
+	// Create broadphase for every collision layer
+	for (std::unique_ptr<SpatialHash>& layer : collisionLayers)
+	{
+		layer = std::make_unique<SpatialHash>(BROADPHASE_CELL_SIZE);
+	}
+
+	// Create tilemap for solids
+	tileMap = std::make_unique<TileMap>();
+
 	// Populate map for game objects factory pattern
 	gameObjectFactory["MainMenu"] = &MainMenu::createInstance;
 	gameObjectFactory["Player"] = &Player::createInstance;
@@ -50,9 +66,23 @@ RoomManager::RoomManager()
 	gameObjectFactory["Teleporter"] = &Teleporter::createInstance;
 	gameObjectFactory["Editor"] = &Editor::createInstance;
 
+	// Create contact manager, where the player looks for everything it interacts with, in order of reaction
+	contactManager = std::make_unique<ContactManager>();
+	contactManager->addTilePair(COLLISION_LAYER_PLAYER, TILE_BREAKABLE | TILE_SPRING);
+	contactManager->addLayerPair(COLLISION_LAYER_PLAYER, COLLISION_LAYER_SOLID);
+	contactManager->addLayerPair(COLLISION_LAYER_PLAYER, COLLISION_LAYER_PICKUP);
+	contactManager->addLayerPair(COLLISION_LAYER_PLAYER, COLLISION_LAYER_SPIKES);
+	contactManager->addLayerPair(COLLISION_LAYER_PLAYER, COLLISION_LAYER_EXIT);
+	contactManager->addLayerPair(COLLISION_LAYER_PLAYER, COLLISION_LAYER_FIRE);
+	contactManager->addLayerPair(COLLISION_LAYER_PLAYER, COLLISION_LAYER_TELEPORTER);
+
+	// Create activity manager, which lets far game objects sleep
+	activityManager = std::make_unique<ActivityManager>();
+
 	// Initialize variables
 	isProgramRunning = true;
 	levelIndex = 0;
+	frameRemovals = 0;
 }
 
 u32 RoomManager::getCurrentLevelIndex()
@@ -60,8 +90,102 @@ u32 RoomManager::getCurrentLevelIndex()
 	return levelIndex;
 }
 
+u32 RoomManager::removeDestroyedGameObjects()
+{
+	// Release scene nodes of the destroyed game objects, then prune them from tilemap, sleeping game objects and collision layers
+	for (const std::shared_ptr<GameObject>& gameObject : gameObjects)
+	{
+		if (!gameObject->destroy)
+		{
+			continue;
+		}
+
+		gameObject->removeSceneNodes();
+		tileMap->remove(gameObject.get());
+		activityManager->remove(gameObject.get());
+
+		for (u32 i = 0; i < COLLISION_LAYER_COUNT; ++i)
+		{
+			if (gameObject->collisionMask & (1 << i))
+			{
+				collisionLayers[i]->remove(gameObject.get());
+			}
+		}
+	}
+
+	// Move surviving game objects to the front, keeping their order
+	const auto& iterator = std::remove_if(gameObjects.begin(), gameObjects.end(), [](const std::shared_ptr<GameObject>& gameObject)
+	{
+		return gameObject->destroy;
+	});
+
+	// Release the destroyed ones
+	frameRemovals = (u32)(gameObjects.end() - iterator);
+	gameObjects.erase(iterator, gameObjects.end());
+	activityManager->compact();
+
+	return frameRemovals;
+}
+
+void RoomManager::addGameObject(const std::shared_ptr<GameObject>& gameObject)
+{
+	// Assign collision layer of the game object
+	const s32 layer = gameObject->getCollisionLayer();
+	gameObject->collisionMask = layer != COLLISION_LAYER_NONE ? 1 << layer : 0;
+
+	// Insert into current room and into its layers
+	gameObjects.push_back(gameObject);
+	activityManager->add(gameObject);
+
+	for (u32 i = 0; i < COLLISION_LAYER_COUNT; ++i)
+	{
+		if (gameObject->collisionMask & (1 << i))
+		{
+			collisionLayers[i]->insert(gameObject);
+		}
+	}
+
+	updateBounds(gameObject.get());
+}
+
+void RoomManager::updateBounds(GameObject* gameObject)
+{
+	// Game objects without layers or models can't collide, while unchanged ones are already up to date
+	if (gameObject->collisionMask == 0 || gameObject->models.size() == 0 || !gameObject->consumeWorldBoundingBoxChanges())
+	{
+		return;
+	}
+
+	const aabbox3df& box = gameObject->getWorldBoundingBox();
+
+	for (u32 i = 0; i < COLLISION_LAYER_COUNT; ++i)
+	{
+		if (gameObject->collisionMask & (1 << i))
+		{
+			collisionLayers[i]->update(gameObject, box);
+		}
+	}
+}
+
+SpatialHash* RoomManager::getCollisionLayer(const u32 layer)
+{
+	return collisionLayers[layer].get();
+}
+
+TileMap* RoomManager::getTileMap()
+{
+	return tileMap.get();
+}
+
+u32 RoomManager::getFrameRemovals()
+{
+	return frameRemovals;
+}
+
 void RoomManager::loadRoom(const std::string roomToLoad)
 {
+	PROFILE_ZONE("loadRoom");
+
 	// Check if requested room is a level
 	if (Utility::startsWith(roomToLoad, LEVEL_PREFIX))
 	{
@@ -88,9 +212,24 @@ void RoomManager::loadRoom(const std::string roomToLoad)
 		}
 	}
 
-	// Clear currently loaded room
+	// Release merged geometry, which is collected again for the new room
+	staticBatch->invalidate();
+
+	// Clear currently loaded room, removing scene nodes of objects which can outlive it
+	for (const std::shared_ptr<GameObject>& gameObject : gameObjects)
+	{
+		gameObject->removeSceneNodes();
+	}
 	gameObjects.clear();
 
+	for (std::unique_ptr<SpatialHash>& layer : collisionLayers)
+	{
+		layer->clear();
+	}
+	tileMap->clear();
+	contactManager->clear();
+	activityManager->clear();
+
 	// Clear game score values
 	SharedData::singleton->clearGameScore();
 
@@ -165,8 +304,19 @@ void RoomManager::loadRoom(const std::string roomToLoad)
 				{
 				}
 
-				// Insert into current room
-				gameObjects.push_back(instance);
+				// Start drawing from the spawn position
+				instance->snapDrawPosition();
+
+				// Insert into current room, where grid-aligned solids become tiles instead of joining their layer
+				if (goIterator->first == "Solid" && tileMap->add(instance, std::static_pointer_cast<Solid>(instance)->getTileFlags()))
+				{
+					gameObjects.push_back(instance);
+					activityManager->add(instance);
+				}
+				else
+				{
+					addGameObject(instance);
+				}
 
 				// Check for solid game object to minimize room's lower bound
 				if (goIterator->first == "Solid")
@@ -177,6 +327,9 @@ void RoomManager::loadRoom(const std::string roomToLoad)
 		}
 	}
 
+	// Merge tiles, now that all of them are known
+	tileMap->build();
+
 	// Move lower bound a bit lower
 	lowerBound -= 40.0f;
 
@@ -1,12 +1,18 @@
 #ifndef ROOMMANAGER_H
 #define ROOMMANAGER_H
 
+#include <array>
 #include <memory>
 #include <vector>
 #include <unordered_map>
 #include <string>
 #include <functional>
 #include "GameObject.h"
+#include "StaticBatch.h"
+#include "SpatialHash.h"
+#include "ContactManager.h"
+#include "TileMap.h"
+#include "ActivityManager.h"
 
 class RoomManager
 {
@@ -24,12 +30,24 @@ protected:
 	// Level index holder
 	u32 levelIndex;
 
+	// Amount of game objects removed by the last compaction
+	u32 frameRemovals;
+
+	// Broadphase for every collision layer, holding the world bounding box of its game objects
+	std::array<std::unique_ptr<SpatialHash>, COLLISION_LAYER_COUNT> collisionLayers;
+
+	// Grid-aligned solids of the room, which collide as tiles instead of being in the solid layer
+	std::unique_ptr<TileMap> tileMap;
+
 public:
 
 	// namespacefor static room names
 	static const std::string ROOM_MAIN_MENU;
 	static const std::string ROOM_EDITOR;
 
+	// Size of the broadphase cells, in world units. Blocks are 20 units wide, so a cell holds a few of them
+	static const f32 BROADPHASE_CELL_SIZE;
+
 	// Singleton holder
 	static std::shared_ptr<RoomManager> singleton;
 
@@ -45,12 +63,60 @@ public:
 	// Vector to hold all active game objects
 	std::vector<std::shared_ptr<GameObject>> gameObjects;
 
+	// Merged geometry for the static models of the current room
+	std::unique_ptr<StaticBatch> staticBatch;
+
+	// Contacts between the game objects of the current room, found once per tick
+	std::unique_ptr<ContactManager> contactManager;
+
+	// Game objects of the current room which are near enough to the camera to be updated
+	std::unique_ptr<ActivityManager> activityManager;
+
 	// Current room's lower bound
 	f32 lowerBound;
 
 	// Get current level index
 	u32 getCurrentLevelIndex();
 
+	/**
+		Remove all the game objects marked as destroyed. Removal is deferred until this method is called once
+		per frame, so the vector is compacted in a single pass instead of being shifted for every object.
+		Order of the remaining game objects is preserved, since it is also the update and draw order.
+
+		@return the amount of removed game objects.
+	*/
+	u32 removeDestroyedGameObjects();
+
+	/**
+		Add a game object to the current room, registering it into the collision layer it reports.
+
+		@param gameObject the game object, which must be already placed in the room.
+	*/
+	void addGameObject(const std::shared_ptr<GameObject>& gameObject);
+
+	/**
+		Refresh the world bounding box of a game object for collision queries. It must be called
+		after the game object has moved, or changed its bounding box.
+
+		@param gameObject the game object.
+	*/
+	void updateBounds(GameObject* gameObject);
+
+	/**
+		Get the broadphase of a collision layer.
+
+		@param layer one of the "COLLISION_LAYER_*" values.
+
+		@return the broadphase holding the game objects of the layer.
+	*/
+	SpatialHash* getCollisionLayer(const u32 layer);
+
+	// Get the tilemap holding the grid-aligned solids loaded with the room
+	TileMap* getTileMap();
+
+	// Amount of game objects removed during the last frame
+	u32 getFrameRemovals();
+
 	// Method to load room
 	void loadRoom(const std::string roomToLoad);
 
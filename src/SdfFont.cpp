@@ -0,0 +1,548 @@
+#include <algorithm>
+#include <cmath>
+#include <cwchar>
+#include <limits>
+#include <string_view>
+
+#include "SdfFont.h"
+
+const u32 SdfFont::MAX_LAYOUTS = 512;
+
+SdfFont::SdfFont(std::shared_ptr<Data> data, const f32 scale)
+{
+	// Assign members
+	this->data = data;
+	this->scale = scale;
+
+	// Same defaults of the built-in fonts
+	kerningWidth = 0;
+	kerningHeight = 0;
+	invisibleCharacters = L" ";
+
+	// Initialize counters
+	layoutHits = 0;
+	layoutMisses = 0;
+}
+
+void SdfFont::transform(f32* values, const s32 count, const s32 stride)
+{
+	std::vector<f32> f(count);
+	std::vector<s32> v(count);
+	std::vector<f32> z(count + 1);
+
+	for (s32 q = 0; q < count; ++q)
+	{
+		f[q] = values[q * stride];
+	}
+
+	// Lower envelope of the parabolas rooted at every sample
+	s32 k = 0;
+	v[0] = 0;
+	z[0] = -std::numeric_limits<f32>::max();
+	z[1] = std::numeric_limits<f32>::max();
+
+	for (s32 q = 1; q < count; ++q)
+	{
+		f32 s = ((f[q] + (f32)(q * q)) - (f[v[k]] + (f32)(v[k] * v[k]))) / (f32)(2 * q - 2 * v[k]);
+		while (s <= z[k])
+		{
+			--k;
+			s = ((f[q] + (f32)(q * q)) - (f[v[k]] + (f32)(v[k] * v[k]))) / (f32)(2 * q - 2 * v[k]);
+		}
+
+		++k;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = std::numeric_limits<f32>::max();
+	}
+
+	// Sample the envelope
+	k = 0;
+	for (s32 q = 0; q < count; ++q)
+	{
+		while (z[k + 1] < (f32)q)
+		{
+			++k;
+		}
+		values[q * stride] = (f32)((q - v[k]) * (q - v[k])) + f[v[k]];
+	}
+}
+
+std::vector<f32> SdfFont::computeDistanceField(IImage* image, const recti& rect, const s32 spread)
+{
+	const s32 w = rect.getWidth() + spread * 2;
+	const s32 h = rect.getHeight() + spread * 2;
+
+	// Bigger than any distance inside the area
+	const f32 far = (f32)(w * w + h * h);
+
+	// Squared distances to the nearest pixel inside and outside of the glyph
+	std::vector<f32> toInside(w * h);
+	std::vector<f32> toOutside(w * h);
+
+	for (s32 y = 0; y < h; ++y)
+	{
+		for (s32 x = 0; x < w; ++x)
+		{
+			const s32 sx = rect.UpperLeftCorner.X + x - spread;
+			const s32 sy = rect.UpperLeftCorner.Y + y - spread;
+			const bool inside = sx >= rect.UpperLeftCorner.X && sy >= rect.UpperLeftCorner.Y && sx < rect.LowerRightCorner.X && sy < rect.LowerRightCorner.Y && image->getPixel(sx, sy).getAlpha() >= 128;
+
+			toInside[y * w + x] = inside ? 0.0f : far;
+			toOutside[y * w + x] = inside ? far : 0.0f;
+		}
+	}
+
+	// Separable transform, rows first, then columns
+	for (std::vector<f32>* values : { &toInside, &toOutside })
+	{
+		for (s32 y = 0; y < h; ++y)
+		{
+			transform(values->data() + y * w, w, 1);
+		}
+		for (s32 x = 0; x < w; ++x)
+		{
+			transform(values->data() + x, h, w);
+		}
+	}
+
+	// Signed distance, positive inside
+	std::vector<f32> field(w * h);
+	for (s32 i = 0; i < w * h; ++i)
+	{
+		field[i] = std::sqrt(toOutside[i]) - std::sqrt(toInside[i]);
+	}
+	return field;
+}
+
+SdfFont* SdfFont::createFromBitmapFont(IrrlichtDevice* device, const std::string& path, SpriteBatch* batch, const s32 material, const u32 spread, const u32 downsample)
+{
+	IVideoDriver* driver = device->getVideoDriver();
+
+	// Structure for a glyph of the bitmap font
+	struct SourceGlyph
+	{
+		wchar_t character;
+		u32 page;
+		recti rect;
+	};
+
+	io::IXMLReader* reader = device->getFileSystem()->createXMLReader(path.c_str());
+	if (reader == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Pages are next to the XML file
+	const std::string folder = path.substr(0, path.find_last_of('/') + 1);
+
+	// Read pages and glyph areas
+	std::vector<IImage*> pages;
+	std::vector<SourceGlyph> sourceGlyphs;
+
+	while (reader->read())
+	{
+		if (reader->getNodeType() != io::EXN_ELEMENT)
+		{
+			continue;
+		}
+
+		const stringw name = reader->getNodeName();
+		if (name == L"Texture")
+		{
+			const u32 index = (u32)reader->getAttributeValueAsInt(L"index");
+			const stringc filename = reader->getAttributeValue(L"filename");
+
+			if (pages.size() <= index)
+			{
+				pages.resize(index + 1, nullptr);
+			}
+			pages[index] = driver->createImageFromFile((folder + filename.c_str()).c_str());
+		}
+		else if (name == L"c")
+		{
+			const wchar_t* character = reader->getAttributeValue(L"c");
+			const wchar_t* area = reader->getAttributeValue(L"r");
+
+			SourceGlyph glyph;
+			glyph.character = character != nullptr ? character[0] : 0;
+			glyph.page = (u32)reader->getAttributeValueAsInt(L"i");
+
+			s32 x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+			if (area != nullptr)
+			{
+				swscanf(area, L"%d, %d, %d, %d", &x1, &y1, &x2, &y2);
+			}
+			glyph.rect = recti(x1, y1, x2, y2);
+
+			sourceGlyphs.push_back(glyph);
+		}
+	}
+	reader->drop();
+
+	// Convert glyphs into distance fields, stored at reduced resolution
+	const s32 factor = (s32)std::max(downsample, 1u);
+	const s32 padding = (s32)spread / factor;
+
+	std::vector<dimension2di> cellSizes;
+	std::vector<std::vector<u8>> cells;
+
+	for (const SourceGlyph& glyph : sourceGlyphs)
+	{
+		IImage* page = glyph.page < pages.size() ? pages[glyph.page] : nullptr;
+		const dimension2di cellSize((glyph.rect.getWidth() + factor - 1) / factor + padding * 2, (glyph.rect.getHeight() + factor - 1) / factor + padding * 2);
+		std::vector<u8> cell(cellSize.Width * cellSize.Height, 0);
+
+		if (page != nullptr)
+		{
+			const s32 fieldSpread = padding * factor;
+			const std::vector<f32> field = computeDistanceField(page, glyph.rect, fieldSpread);
+			const s32 fieldWidth = glyph.rect.getWidth() + fieldSpread * 2;
+			const s32 fieldHeight = glyph.rect.getHeight() + fieldSpread * 2;
+
+			// Every stored pixel is the average of the distances it covers
+			for (s32 y = 0; y < cellSize.Height; ++y)
+			{
+				for (s32 x = 0; x < cellSize.Width; ++x)
+				{
+					f32 sum = 0.0f;
+					s32 samples = 0;
+
+					for (s32 fy = y * factor; fy < std::min((y + 1) * factor, fieldHeight); ++fy)
+					{
+						for (s32 fx = x * factor; fx < std::min((x + 1) * factor, fieldWidth); ++fx)
+						{
+							sum += field[fy * fieldWidth + fx];
+							++samples;
+						}
+					}
+
+					// Outline is mapped to 0.5, and the spread to the full range
+					const f32 distance = samples > 0 ? sum / (f32)samples : -(f32)fieldSpread;
+					const f32 value = core::clamp(0.5f + distance / (f32)(fieldSpread * 2), 0.0f, 1.0f);
+					cell[y * cellSize.Width + x] = (u8)(value * 255.0f);
+				}
+			}
+		}
+
+		cellSizes.push_back(cellSize);
+		cells.push_back(std::move(cell));
+	}
+
+	for (IImage* page : pages)
+	{
+		if (page != nullptr)
+		{
+			page->drop();
+		}
+	}
+
+	// Pack cells tallest first, on the smallest texture which holds all of them
+	std::vector<u32> order(cells.size());
+	for (u32 i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&cellSizes](const u32 a, const u32 b)
+	{
+		return cellSizes[a].Height > cellSizes[b].Height;
+	});
+
+	const dimension2du atlasSizes[] = {
+		dimension2du(512, 512), dimension2du(1024, 1024), dimension2du(2048, 1024), dimension2du(2048, 2048), dimension2du(4096, 4096)
+	};
+
+	dimension2du atlasSize;
+	std::vector<vector2di> positions(cells.size());
+
+	for (const dimension2du& size : atlasSizes)
+	{
+		s32 x = 0;
+		s32 y = 0;
+		s32 shelfHeight = 0;
+		bool fits = true;
+
+		for (const u32 i : order)
+		{
+			// One pixel between cells, so bilinear filtering doesn't bleed between neighbours
+			const s32 w = cellSizes[i].Width + 1;
+			const s32 h = cellSizes[i].Height + 1;
+
+			if (x + w > (s32)size.Width)
+			{
+				x = 0;
+				y += shelfHeight;
+				shelfHeight = 0;
+			}
+			if (y + h > (s32)size.Height)
+			{
+				fits = false;
+				break;
+			}
+
+			positions[i] = vector2di(x, y);
+			x += w;
+			shelfHeight = std::max(shelfHeight, h);
+		}
+
+		atlasSize = size;
+		if (fits)
+		{
+			break;
+		}
+	}
+
+	// Write distances into the alpha channel
+	IImage* image = driver->createImage(ECF_A8R8G8B8, atlasSize);
+	image->fill(SColor(0, 255, 255, 255));
+
+	for (u32 i = 0; i < cells.size(); ++i)
+	{
+		for (s32 y = 0; y < cellSizes[i].Height; ++y)
+		{
+			for (s32 x = 0; x < cellSizes[i].Width; ++x)
+			{
+				const s32 px = positions[i].X + x;
+				const s32 py = positions[i].Y + y;
+				if (px < (s32)atlasSize.Width && py < (s32)atlasSize.Height)
+				{
+					image->setPixel(px, py, SColor(cells[i][y * cellSizes[i].Width + x], 255, 255, 255));
+				}
+			}
+		}
+	}
+
+	// Create texture, without mipmaps since glyphs are drawn around their own size
+	const bool mipMaps = driver->getTextureCreationFlag(ETCF_CREATE_MIP_MAPS);
+	driver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, false);
+
+	std::shared_ptr<Data> data = std::make_shared<Data>();
+	data->texture = driver->addTexture(("sdf:" + path).c_str(), image);
+	image->drop();
+
+	driver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, mipMaps);
+
+	// Store glyph metrics, measured in pixels of the bitmap font
+	data->material = material;
+	data->batch = batch;
+	data->spread = (f32)(padding * factor);
+	data->lineHeight = 0.0f;
+	data->asciiGlyphs.fill(-1);
+
+	for (u32 i = 0; i < sourceGlyphs.size(); ++i)
+	{
+		const vector2df position((f32)positions[i].X, (f32)positions[i].Y);
+		const vector2df cellSize((f32)cellSizes[i].Width, (f32)cellSizes[i].Height);
+		const vector2df textureSize((f32)atlasSize.Width, (f32)atlasSize.Height);
+
+		Glyph glyph;
+		glyph.uv = rectf(position / textureSize, (position + cellSize) / textureSize);
+		glyph.size = dimension2df((f32)sourceGlyphs[i].rect.getWidth(), (f32)sourceGlyphs[i].rect.getHeight());
+		glyph.cellSize = dimension2df(cellSize.X * (f32)factor, cellSize.Y * (f32)factor);
+		data->glyphs.push_back(glyph);
+
+		data->lineHeight = std::max(data->lineHeight, glyph.size.Height);
+
+		// First glyph wins, like the built-in fonts do
+		const wchar_t character = sourceGlyphs[i].character;
+		if ((u32)character < data->asciiGlyphs.size())
+		{
+			if (data->asciiGlyphs[character] == -1)
+			{
+				data->asciiGlyphs[character] = (s32)i;
+			}
+		}
+		else if (data->glyphIndices.find(character) == data->glyphIndices.end())
+		{
+			data->glyphIndices[character] = i;
+		}
+	}
+
+	#if NDEBUG || _DEBUG
+	printf("SdfFont - Converted %u glyphs of %s into a %ux%u texture\n", (u32)data->glyphs.size(), path.c_str(), atlasSize.Width, atlasSize.Height);
+	#endif
+
+	// Fonts without glyphs can't be drawn
+	if (data->glyphs.empty())
+	{
+		return nullptr;
+	}
+	return new SdfFont(data, 1.0f);
+}
+
+SdfFont* SdfFont::createScaled(const f32 scale)
+{
+	return new SdfFont(data, scale);
+}
+
+const SdfFont::Glyph& SdfFont::getGlyph(const wchar_t character) const
+{
+	if ((u32)character < data->asciiGlyphs.size())
+	{
+		const s32 index = data->asciiGlyphs[character];
+		return data->glyphs[index >= 0 ? index : 0];
+	}
+
+	const auto& iterator = data->glyphIndices.find(character);
+	return data->glyphs[iterator != data->glyphIndices.end() ? iterator->second : 0];
+}
+
+const SdfFont::Layout& SdfFont::getLayout(const wchar_t* text) const
+{
+	const std::wstring_view view(text != nullptr ? text : L"");
+	const size_t hash = std::hash<std::wstring_view>()(view);
+
+	// Check for memoized layout
+	{
+		const auto& iterator = layouts.find(hash);
+		if (iterator != layouts.end() && iterator->second.text == view)
+		{
+			++layoutHits;
+			return iterator->second;
+		}
+	}
+	++layoutMisses;
+
+	// Start over when too many strings have been seen
+	if (layouts.size() >= MAX_LAYOUTS)
+	{
+		layouts.clear();
+	}
+
+	Layout& layout = layouts[hash];
+	layout.text = view;
+	layout.quads.clear();
+
+	// Place glyphs
+	const f32 lineHeight = data->lineHeight * scale;
+	const f32 spread = data->spread * scale;
+	f32 x = 0.0f;
+	f32 y = 0.0f;
+	f32 width = 0.0f;
+
+	for (size_t i = 0; i < view.size(); ++i)
+	{
+		const wchar_t character = view[i];
+
+		// New line, counting "\r\n" only once
+		if (character == L'\r' || character == L'\n')
+		{
+			if (character == L'\r' && i + 1 < view.size() && view[i + 1] == L'\n')
+			{
+				++i;
+			}
+
+			width = std::max(width, x);
+			x = 0.0f;
+			y += lineHeight + (f32)kerningHeight;
+			continue;
+		}
+
+		const Glyph& glyph = getGlyph(character);
+
+		if (invisibleCharacters.find(character) == std::wstring::npos)
+		{
+			Quad quad;
+			quad.rect = rectf(x - spread, y - spread, x - spread + glyph.cellSize.Width * scale, y - spread + glyph.cellSize.Height * scale);
+			quad.uv = glyph.uv;
+			layout.quads.push_back(quad);
+		}
+
+		x += glyph.size.Width * scale + (f32)kerningWidth;
+	}
+
+	width = std::max(width, x);
+	layout.size = dimension2du((u32)std::ceil(width), (u32)std::ceil(y + lineHeight));
+
+	return layout;
+}
+
+void SdfFont::draw(const stringw& text, const recti& position, SColor color, bool hcenter, bool vcenter, const recti* clip)
+{
+	const Layout& layout = getLayout(text.c_str());
+
+	// Align the whole text inside the rectangle
+	vector2df offset((f32)position.UpperLeftCorner.X, (f32)position.UpperLeftCorner.Y);
+	if (hcenter)
+	{
+		offset.X += (f32)((position.getWidth() - (s32)layout.size.Width) / 2);
+	}
+	if (vcenter)
+	{
+		offset.Y += (f32)((position.getHeight() - (s32)layout.size.Height) / 2);
+	}
+
+	// Queue glyphs, which share the same texture
+	for (const Quad& quad : layout.quads)
+	{
+		const rectf rect(quad.rect.UpperLeftCorner + offset, quad.rect.LowerRightCorner + offset);
+		data->batch->draw(data->texture, rect, quad.uv, color, clip, data->material);
+	}
+}
+
+dimension2du SdfFont::getDimension(const wchar_t* text) const
+{
+	return getLayout(text).size;
+}
+
+s32 SdfFont::getCharacterFromPos(const wchar_t* text, s32 pixel_x) const
+{
+	if (text == nullptr)
+	{
+		return -1;
+	}
+
+	f32 x = 0.0f;
+	for (s32 i = 0; text[i] != 0; ++i)
+	{
+		x += getGlyph(text[i]).size.Width * scale + (f32)kerningWidth;
+		if (x >= (f32)pixel_x)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+EGUI_FONT_TYPE SdfFont::getType() const
+{
+	return EGFT_CUSTOM;
+}
+
+void SdfFont::setKerningWidth(s32 kerning)
+{
+	kerningWidth = kerning;
+	layouts.clear();
+}
+
+void SdfFont::setKerningHeight(s32 kerning)
+{
+	kerningHeight = kerning;
+	layouts.clear();
+}
+
+s32 SdfFont::getKerningWidth(const wchar_t* thisLetter, const wchar_t* previousLetter) const
+{
+	return kerningWidth;
+}
+
+s32 SdfFont::getKerningHeight() const
+{
+	return kerningHeight;
+}
+
+void SdfFont::setInvisibleCharacters(const wchar_t* s)
+{
+	invisibleCharacters = s != nullptr ? s : L"";
+	layouts.clear();
+}
+
+u32 SdfFont::getLayoutHits()
+{
+	return layoutHits;
+}
+
+u32 SdfFont::getLayoutMisses()
+{
+	return layoutMisses;
+}
\ No newline at end of file
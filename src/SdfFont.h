@@ -0,0 +1,157 @@
+#ifndef SDFFONT_H
+#define SDFFONT_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <irrlicht.h>
+
+#include "SpriteBatch.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+using namespace gui;
+
+class SdfFont : public IGUIFont
+{
+protected:
+
+	// Maximum amount of memoized layouts, so formatted numbers can't grow the cache forever
+	static const u32 MAX_LAYOUTS;
+
+	// Structure for a single glyph, whose sizes are measured in pixels of the source bitmap font
+	struct Glyph
+	{
+		rectf uv;
+		dimension2df size;
+		dimension2df cellSize;
+	};
+
+	// Structure for data shared by all of the scaled instances of the same font
+	struct Data
+	{
+		ITexture* texture;
+		s32 material;
+		SpriteBatch* batch;
+		f32 spread;
+		f32 lineHeight;
+		std::vector<Glyph> glyphs;
+		std::array<s32, 128> asciiGlyphs;
+		std::unordered_map<wchar_t, u32> glyphIndices;
+	};
+
+	// Structure for a positioned glyph quad, relative to the upper left corner of the text
+	struct Quad
+	{
+		rectf rect;
+		rectf uv;
+	};
+
+	// Structure for the memoized layout of a string
+	struct Layout
+	{
+		std::wstring text;
+		dimension2du size;
+		std::vector<Quad> quads;
+	};
+
+	// Shared font data
+	std::shared_ptr<Data> data;
+
+	// Scale from the source bitmap font to this instance
+	f32 scale;
+
+	// Kerning and invisible characters, like the ones of the built-in fonts
+	s32 kerningWidth;
+	s32 kerningHeight;
+	std::wstring invisibleCharacters;
+
+	// Memoized layouts, by hash of their text
+	mutable std::unordered_map<size_t, Layout> layouts;
+
+	// Counters for memoized layouts
+	mutable u32 layoutHits;
+	mutable u32 layoutMisses;
+
+	// Constructor, used by factory methods
+	SdfFont(std::shared_ptr<Data> data, const f32 scale);
+
+	/**
+		Compute the signed distance field of a glyph, at the resolution of the source image.
+
+		@param image the page of the bitmap font.
+		@param rect the area of the glyph inside the page.
+		@param spread the maximum distance, in pixels, which is encoded around the outline.
+
+		@return distances for an area as big as the glyph plus the spread on every side. Positive values are inside the glyph.
+	*/
+	static std::vector<f32> computeDistanceField(IImage* image, const recti& rect, const s32 spread);
+
+	/**
+		Squared euclidean distance transform of a single row or column, by Felzenszwalb and Huttenlocher.
+
+		@param values squared distances, which are replaced by the transformed ones.
+		@param count the amount of values.
+		@param stride the distance between two consecutive values.
+	*/
+	static void transform(f32* values, const s32 count, const s32 stride);
+
+	// Get glyph for a character, falling back to the first glyph of the font
+	const Glyph& getGlyph(const wchar_t character) const;
+
+	// Get memoized layout for a text, building it when required
+	const Layout& getLayout(const wchar_t* text) const;
+
+public:
+
+	/**
+		Create a font from an XML bitmap font, converting its glyphs into signed distance fields
+		which are packed into a single texture. Pages of the bitmap font are read only once.
+
+		@param device the Irrlicht device.
+		@param path the path of the XML file of the bitmap font.
+		@param batch the sprite batch where glyphs are queued.
+		@param material the material for the glyphs, which must turn distances into alpha.
+		@param spread the maximum distance, in pixels of the bitmap font, which is encoded around every glyph.
+		@param downsample the factor the source resolution is divided by.
+
+		@return the new font, or "nullptr" if the bitmap font can't be read.
+	*/
+	static SdfFont* createFromBitmapFont(IrrlichtDevice* device, const std::string& path, SpriteBatch* batch, const s32 material, const u32 spread, const u32 downsample);
+
+	/**
+		Create another instance of the font, sharing the same texture and glyph metrics.
+
+		@param scale the scale relative to the source bitmap font.
+
+		@return the new font.
+	*/
+	SdfFont* createScaled(const f32 scale);
+
+	/**
+		Queue the glyphs of a text into the sprite batch. The batch must be flushed to display them.
+		Arguments are the same as the ones of the built-in fonts.
+	*/
+	virtual void draw(const stringw& text, const recti& position, SColor color, bool hcenter = false, bool vcenter = false, const recti* clip = 0);
+
+	// Font methods, which read memoized layouts
+	virtual dimension2du getDimension(const wchar_t* text) const;
+	virtual s32 getCharacterFromPos(const wchar_t* text, s32 pixel_x) const;
+	virtual EGUI_FONT_TYPE getType() const;
+	virtual void setKerningWidth(s32 kerning);
+	virtual void setKerningHeight(s32 kerning);
+	virtual s32 getKerningWidth(const wchar_t* thisLetter = 0, const wchar_t* previousLetter = 0) const;
+	virtual s32 getKerningHeight() const;
+	virtual void setInvisibleCharacters(const wchar_t* s);
+
+	// Amount of texts served from memoized layouts
+	u32 getLayoutHits();
+
+	// Amount of texts whose layout has been built
+	u32 getLayoutMisses();
+};
+
+#endif // SDFFONT_H
\ No newline at end of file
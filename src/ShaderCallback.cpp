@@ -1,21 +1,76 @@
 #include "ShaderCallback.h"
 
+u32 ShaderCallback::frame = 0;
+
+ShaderCallback::ShaderCallback()
+{
+	// Locations are resolved on first use, when the program is bound
+	constantsResolved = false;
+	uploadedFrame = 0;
+
+	mWorldId = -1;
+	mWorldViewId = -1;
+	mWorldViewProjId = -1;
+	texId = -1;
+}
+
+void ShaderCallback::beginFrame()
+{
+	// Zero is reserved for callbacks which never uploaded anything
+	++frame;
+	if (frame == 0)
+	{
+		frame = 1;
+	}
+}
+
+void ShaderCallback::resolveConstants(video::IMaterialRendererServices* services)
+{
+	mWorldId = services->getVertexShaderConstantID("mWorld");
+	mWorldViewId = services->getVertexShaderConstantID("mWorldView");
+	mWorldViewProjId = services->getVertexShaderConstantID("mWorldViewProj");
+	texId = services->getPixelShaderConstantID("tex");
+}
+
+void ShaderCallback::setFrameConstants(video::IMaterialRendererServices* services)
+{
+	// Set fragment shader constants
+	s32 layer0 = 0;
+	services->setPixelShaderConstant(texId, &layer0, 1);
+}
+
 void ShaderCallback::OnSetConstants(video::IMaterialRendererServices* services, s32 userData)
 {
+	// Resolve uniform locations once per program
+	if (!constantsResolved)
+	{
+		resolveConstants(services);
+		constantsResolved = true;
+	}
+
+	// Upload per-frame constants on the first draw of the frame
+	if (uploadedFrame != frame)
+	{
+		setFrameConstants(services);
+		uploadedFrame = frame;
+	}
+
+	// Programs without transforms, like screen quads, have nothing else to upload
+	if (mWorldId == -1 && mWorldViewId == -1 && mWorldViewProjId == -1)
+	{
+		return;
+	}
+
 	// Get video driver
 	video::IVideoDriver* driver = services->getVideoDriver();
 
-	// Set clip matrix
-	core::matrix4 mProj = driver->getTransform(video::ETS_PROJECTION);
-	core::matrix4 mView = driver->getTransform(video::ETS_VIEW);
-	core::matrix4 mWorld = driver->getTransform(video::ETS_WORLD);
+	// Combine matrices on the CPU, so vertex shaders don't do it for every vertex
+	const core::matrix4& mWorld = driver->getTransform(video::ETS_WORLD);
+	const core::matrix4 mWorldView = driver->getTransform(video::ETS_VIEW) * mWorld;
+	const core::matrix4 mWorldViewProj = driver->getTransform(video::ETS_PROJECTION) * mWorldView;
 
 	// Pass matrices to shader
-	services->setVertexShaderConstant("mWorld", mWorld.pointer(), 16);
-	services->setVertexShaderConstant("mView", mView.pointer(), 16);
-	services->setVertexShaderConstant("mProj", mProj.pointer(), 16);
-
-	// Set fragment shader constants
-	s32 layer0 = 0;
-	services->setPixelShaderConstant("tex", &layer0, 1);
+	services->setVertexShaderConstant(mWorldId, mWorld.pointer(), 16);
+	services->setVertexShaderConstant(mWorldViewId, mWorldView.pointer(), 16);
+	services->setVertexShaderConstant(mWorldViewProjId, mWorldViewProj.pointer(), 16);
 }
@@ -7,8 +7,54 @@ using namespace irr;
 
 class ShaderCallback : public video::IShaderConstantSetCallBack
 {
+protected:
+
+	// Frame counter, shared by all of the callbacks
+	static u32 frame;
+
+	// Frame when per-frame constants have been uploaded for the last time
+	u32 uploadedFrame;
+
+	// Uniform locations are resolved once per program
+	bool constantsResolved;
+
+	// Uniform locations for common constants
+	s32 mWorldId;
+	s32 mWorldViewId;
+	s32 mWorldViewProjId;
+	s32 texId;
+
+	/**
+		Resolve uniform locations through the constant ID API. It's called only once, the first time the
+		program is used, since every callback instance belongs to a single program. Subclasses overriding
+		this method must call the parent one.
+
+		@param services the "IMaterialRendererServices" instance passed as argument by "OnSetConstants".
+	*/
+	virtual void resolveConstants(video::IMaterialRendererServices* services);
+
+	/**
+		Upload values which are the same for all of the objects drawn during a frame, such as camera data
+		and texture layers. It's called by the first draw of every frame, since the program keeps the values
+		of its uniforms. Subclasses overriding this method must call the parent one.
+
+		@param services the "IMaterialRendererServices" instance passed as argument by "OnSetConstants".
+	*/
+	virtual void setFrameConstants(video::IMaterialRendererServices* services);
+
 public:
 
+	// Constructor
+	ShaderCallback();
+
+	// Start a new frame, so per-frame constants are uploaded again
+	static void beginFrame();
+
+	/**
+		Resolve uniform locations and upload per-frame constants when required, then upload the world
+		matrix along with the world-view and world-view-projection ones, which are combined on the CPU.
+		Subclasses must call this method before uploading their own per-draw constants.
+	*/
 	virtual void OnSetConstants(video::IMaterialRendererServices* services, s32 userData);
 };
 
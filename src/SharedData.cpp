@@ -7,6 +7,8 @@
 #include "SoundManager.h"
 #include "RoomManager.h"
 #include "GUIImageSceneNode.h"
+#include "MaterialCache.h"
+#include "ShaderCallback.h"
 
 const std::string SharedData::ROOM_OBJECT_KEY = "SharedData";
 
@@ -33,6 +35,12 @@ SharedData::SharedData()
 	levelPointsValue = 0.0f;
 	globalPointsValue = 0.0f;
 	guiRtt = nullptr;
+	titleFont = nullptr;
+	smallTitleFont = nullptr;
+	guiRttDirty = true;
+
+	hourglassDrawnRatio = -1.0f;
+	hourglassDrawnRotation = -1.0f;
 
 	// Initialize texts for game over
 	{
@@ -50,6 +58,16 @@ SharedData::SharedData()
 		textGroups[KEY_TEXT_LEVEL_PASSED] = textLevelPassed;
 	}
 
+	// Initialize prefixes for level score
+	{
+		std::vector<std::wstring> textLevelScore;
+		textLevelScore.push_back(L"Level Passed: ");
+		textLevelScore.push_back(L"Level Failed: ");
+		textLevelScore.push_back(L"Level Points: ");
+		textLevelScore.push_back(L"Total Points: ");
+		textGroups[KEY_TEXT_LEVEL_SCORE] = textLevelScore;
+	}
+
 	// Load sounds
 	sounds[KEY_SOUND_SELECT] = SoundManager::singleton->getSound(KEY_SOUND_SELECT);
 	sounds[KEY_SOUND_CLOCK_A] = SoundManager::singleton->getSound(KEY_SOUND_CLOCK_A);
@@ -60,6 +78,19 @@ SharedData::SharedData()
 	initGameScoreValue(KEY_SCORE_POINTS_TOTAL, 0);
 }
 
+SharedData::~SharedData()
+{
+	// Release fonts, which are kept alive by texts too
+	if (titleFont != nullptr)
+	{
+		titleFont->drop();
+	}
+	if (smallTitleFont != nullptr)
+	{
+		smallTitleFont->drop();
+	}
+}
+
 void SharedData::update(f32 deltaTime)
 {
 	// Assign delta time
@@ -203,6 +234,20 @@ void SharedData::update(f32 deltaTime)
 			recti r(0, y, windowSize.X, y + 128);
 			gameOverRects.push_back(r);
 		}
+
+		// Game Over menu selection, hovered entry is computed while building the GUI
+		if (EventManager::singleton->keyStates[KEY_LBUTTON] == KEY_RELEASED)
+		{
+			if (gameOverSelection == 0)
+			{
+				const auto functionToTrigger = isLevelPassed ? &SharedData::jumpToNextLevel : &SharedData::restartRoom;
+				startFade(true, std::bind(functionToTrigger, this));
+			}
+			else if (gameOverSelection == 1)
+			{
+				startFade(true, std::bind(&SharedData::jumpToMenuRoom, this));
+			}
+		}
 	}
 	// Check if pause key is pressed
 	else if (EventManager::singleton->keyStates[KEY_RETURN] == KEY_PRESSED)
@@ -227,25 +272,124 @@ void SharedData::update(f32 deltaTime)
 
 void SharedData::loadAssets()
 {
-	// Load font
-	font = guienv->getFont("fonts/titles.xml");
-
-	// Load textures
-	guiTextures[KEY_GUI_COIN] = driver->getTexture("textures/gui_coin.png");
-	guiTextures[KEY_GUI_KEY] = driver->getTexture("textures/gui_key.png");
-	guiTextures[KEY_GUI_RECTANGLE] = driver->getTexture("textures/gui_rectangle.png");
-	guiTextures[KEY_GUI_MOUSE] = driver->getTexture("textures/gui_mouse.png");
-	guiTextures[KEY_GUI_HOURGLASS] = driver->getTexture("textures/gui_hourglass.png");
-	guiTextures[KEY_GUI_HOURGLASS_SAND_TOP] = driver->getTexture("textures/gui_hourglass_sand_top.png");
-	guiTextures[KEY_GUI_HOURGLASS_SAND_BOTTOM] = driver->getTexture("textures/gui_hourglass_sand_bottom.png");
-	guiTextures[KEY_GUI_APPLE] = driver->getTexture("textures/gui_apple.png");
-	guiTextures[KEY_GUI_BANANA] = driver->getTexture("textures/gui_banana.png");
-	guiTextures[KEY_GUI_STRAWBERRY] = driver->getTexture("textures/gui_strawberry.png");
-	guiTextures[KEY_GUI_WATERMELON] = driver->getTexture("textures/gui_watermelon.png");
-	guiTextures[KEY_GUI_PINEAPPLE] = driver->getTexture("textures/gui_pineapple.png");
+	// Create pool for render targets
+	renderTargetPool = std::make_unique<RenderTargetPool>(driver);
+
+	// Create atlas for GUI textures
+	guiAtlas = std::make_unique<TextureAtlas>(driver, "guiAtlas", 1024, 2);
+
+	// Load textures, packing the ones drawn as GUI images
+	const auto loadTexture = [this](const u8 key, const std::string& path, const bool packed)
+	{
+		guiTextures[key] = driver->getTexture(path.c_str());
+		if (packed)
+		{
+			guiAtlas->add(guiTextures[key], path);
+		}
+	};
+
+	loadTexture(KEY_GUI_COIN, "textures/gui_coin.png", true);
+	loadTexture(KEY_GUI_KEY, "textures/gui_key.png", true);
+	loadTexture(KEY_GUI_RECTANGLE, "textures/gui_rectangle.png", true);
+	loadTexture(KEY_GUI_MOUSE, "textures/gui_mouse.png", true);
+	loadTexture(KEY_GUI_APPLE, "textures/gui_apple.png", true);
+	loadTexture(KEY_GUI_BANANA, "textures/gui_banana.png", true);
+	loadTexture(KEY_GUI_STRAWBERRY, "textures/gui_strawberry.png", true);
+	loadTexture(KEY_GUI_WATERMELON, "textures/gui_watermelon.png", true);
+	loadTexture(KEY_GUI_PINEAPPLE, "textures/gui_pineapple.png", true);
+
+	// Hourglass parts are composed into their own render target, so they are never drawn as GUI images
+	loadTexture(KEY_GUI_HOURGLASS, "textures/gui_hourglass.png", false);
+	loadTexture(KEY_GUI_HOURGLASS_SAND_TOP, "textures/gui_hourglass_sand_top.png", false);
+	loadTexture(KEY_GUI_HOURGLASS_SAND_BOTTOM, "textures/gui_hourglass_sand_bottom.png", false);
+
+	// Pack atlas, then create batch for GUI images
+	guiAtlas->build();
+	spriteBatch = std::make_unique<SpriteBatch>(driver, guiAtlas.get());
+
+	// Convert title font into a distance field, whose single texture serves every resolution
+	{
+		const s32 material = MaterialCache::singleton->getMaterial<ShaderCallback>("shaders/sdf.vs", "shaders/sdf.fs", EMT_TRANSPARENT_VERTEX_ALPHA);
+		titleFont = SdfFont::createFromBitmapFont(device, "fonts/titles.xml", spriteBatch.get(), material, 8, 2);
+		smallTitleFont = titleFont != nullptr ? titleFont->createScaled(0.5f) : nullptr;
+	}
+
+	// Create retained GUI
+	createGUI();
 }
 
-void SharedData::buildGameScore()
+void SharedData::createGUI()
+{
+	// Create layer, whose elements are kept alive for the whole application
+	guiLayer = std::make_unique<GuiLayer>();
+
+	// Group for in-level HUD
+	scoreGroup = guiLayer->addGroup();
+
+	/*
+		Elements don't overlap, so atlas images are created first, then the hourglass and the texts.
+		This way, all of the icons are drawn by a single draw call.
+	*/
+
+	// Coin
+	coinImage = guiLayer->addImage(guiTextures[KEY_GUI_COIN], getIconRect(guiTextures[KEY_GUI_COIN], vector2di(32, 32)), scoreGroup);
+
+	// Fruits
+	{
+		u8 fruitKeys[] = {
+			KEY_GUI_APPLE, KEY_GUI_BANANA, KEY_GUI_STRAWBERRY, KEY_GUI_WATERMELON, KEY_GUI_PINEAPPLE
+		};
+
+		for (u8 i = 0; i < 5; ++i)
+		{
+			fruitImages[i] = guiLayer->addImage(guiTextures[fruitKeys[i]], Utility::getSourceRect(guiTextures[fruitKeys[i]]), scoreGroup);
+		}
+	}
+
+	// Hourglass
+	hourglassImage = guiLayer->addImage(nullptr, recti(), scoreGroup);
+
+	// Coin amount and remaining time
+	coinText = guiLayer->addText(L"", recti(192, 32, 512, 160), titleFont, EGUIA_UPPERLEFT, EGUIA_CENTER, scoreGroup);
+	timeText = guiLayer->addText(L"", recti(), titleFont, EGUIA_CENTER, EGUIA_CENTER, scoreGroup);
+
+	// Score points
+	for (u8 i = 0; i < 2; ++i)
+	{
+		pointTexts[i] = guiLayer->addText(L"", recti(), titleFont, EGUIA_UPPERLEFT, EGUIA_CENTER, scoreGroup);
+	}
+
+	// Group for Game Over screen, on top of the HUD
+	gameOverGroup = guiLayer->addGroup();
+
+	gameOverBackground = guiLayer->addImage(guiTextures[KEY_GUI_RECTANGLE], recti(), gameOverGroup);
+	gameOverBackground->setScaleImage(true);
+
+	for (u8 i = 0; i < 2; ++i)
+	{
+		gameOverTexts[i] = guiLayer->addText(L"", recti(), titleFont, EGUIA_CENTER, EGUIA_CENTER, gameOverGroup);
+	}
+
+	for (u8 i = 0; i < 3; ++i)
+	{
+		gameOverStats[i] = guiLayer->addText(L"", recti(), titleFont, EGUIA_CENTER, EGUIA_CENTER, gameOverGroup);
+	}
+
+	gameOverMouse = guiLayer->addImage(guiTextures[KEY_GUI_MOUSE], Utility::getSourceRect(guiTextures[KEY_GUI_MOUSE]), gameOverGroup);
+
+	// Fade transition over all
+	fadeImage = guiLayer->addImage(guiTextures[KEY_GUI_RECTANGLE], recti(), nullptr);
+	fadeImage->setScaleImage(true);
+}
+
+recti SharedData::getIconRect(ITexture* texture, const vector2di& position)
+{
+	// Icons are never bigger than 128 pixels per side
+	const dimension2du size = texture->getOriginalSize();
+	return recti(position, dimension2di(core::min_((s32)size.Width, 128), core::min_((s32)size.Height, 128)));
+}
+
+void SharedData::updateGameScore()
 {
 	// Get window size
 	const vector2di windowSize = Utility::getWindowSize<s32>(driver);
@@ -253,58 +397,69 @@ void SharedData::buildGameScore()
 	// Get alpha value for Level HUD
 	const s32 alpha = (s32)(255.0f - gameOverAlpha * 255.0f);
 
-	// Draw coin amount
+	// Update coin amount
 	{
 		// Get picked coin amount
 		s32 amount = getGameScoreValue(KEY_SCORE_COIN);
+		guiLayer->setVisible(coinImage, amount >= 0);
+		guiLayer->setVisible(coinText, amount >= 0);
+
 		if (amount >= 0)
 		{
 			// Common color
 			const SColor color(alpha, 255, 255, 255);
 
-			// Draw coin
-			IGUIImage* image = guienv->addImage(guiTextures[KEY_GUI_COIN], vector2di(32, 32));
-			image->setMaxSize(dimension2du(128, 128));
-			image->setColor(color);
+			// Update coin
+			guiLayer->setColor(coinImage, color);
 
-			// Draw counter
-			IGUIStaticText* text = guienv->addStaticText(std::to_wstring(amount).c_str(), recti(192, 32, 512, 160));
-			text->setOverrideFont(font);
-			text->setOverrideColor(color);
-			text->setTextAlignment(EGUIA_UPPERLEFT, EGUIA_CENTER);
+			// Update counter
+			guiLayer->setNumber(coinText, amount);
+			guiLayer->setColor(coinText, color);
 		}
 	}
 
-	// Draw key amount
+	// Update key amount
 	{
 		// Get picked key amount
 		s32 amount = getGameScoreValue(KEY_SCORE_KEY_TOTAL);
-		if (amount >= 0)
+
+		// Get picked key amount
+		s32 pickedAmount = getGameScoreValue(KEY_SCORE_KEY_PICKED);
+
+		// Create missing keys, behind the other elements of the HUD
+		while ((s32)keyImages.size() < amount)
 		{
-			// Get picked key amount
-			s32 pickedAmount = getGameScoreValue(KEY_SCORE_KEY_PICKED);
+			IGUIImage* image = guiLayer->addImage(guiTextures[KEY_GUI_KEY], recti(), scoreGroup);
+			scoreGroup->sendToBack(image);
+			keyImages.push_back(image);
+		}
 
-			// Draw keys
-			for (u8 i = 0; i < amount; ++i)
+		// Update keys
+		for (u32 i = 0; i < keyImages.size(); ++i)
+		{
+			IGUIImage* image = keyImages[i];
+			guiLayer->setVisible(image, (s32)i < amount);
+
+			if ((s32)i < amount)
 			{
 				// Compute coords for image
 				const s32 x = 32 + 96 * i;
 				const s32 y = windowSize.Y - 160;
-
-				// Draw key
-				IGUIImage* image = guienv->addImage(guiTextures[KEY_GUI_KEY], vector2di(x, y));
-				image->setMaxSize(dimension2du(128, 128));
+				guiLayer->setRect(image, getIconRect(guiTextures[KEY_GUI_KEY], vector2di(x, y)));
 
 				// Darken the image only if it hasn't been picked yet
-				const u32 cc = i >= pickedAmount ? 0 : 255;
-				image->setColor(SColor(alpha, cc, cc, cc));
+				const u32 cc = (s32)i >= pickedAmount ? 0 : 255;
+				guiLayer->setColor(image, SColor(alpha, cc, cc, cc));
 			}
 		}
 	}
 
-	// Draw time
+	// Update time
 	{
 		s32 amount = getGameScoreValue(KEY_SCORE_TIME);
+		guiLayer->setVisible(hourglassImage, amount >= 0);
+		guiLayer->setVisible(timeText, amount >= 0 && amount <= 20);
+
 		if (amount >= 0)
 		{
 			// Get maximum time
@@ -313,84 +468,28 @@ void SharedData::buildGameScore()
 			// Get time ratio
 			f32 ratio = (f32)amount / (f32)maxTime;
 
-			// Compute coords for image
-			dimension2du imageSize = guiTextures[KEY_GUI_HOURGLASS]->getOriginalSize();
-			dimension2du size(192 * imageSize.Width / imageSize.Height, 192);
-
-			vector2df hudSize;
+			// Get pooled render targets for the hourglass
+			bool sandReallocated = false;
+			bool hourglassReallocated = false;
+			ITexture* sandRtt = renderTargetPool->acquire("hourglassSandRtt", dimension2du(128, 256), ECF_A8R8G8B8, &sandReallocated);
+			ITexture* hourglassRtt = renderTargetPool->acquire("hourglassRtt", dimension2du(256, 256), ECF_A8R8G8B8, &hourglassReallocated);
 
-			// Render sand on separate texture
-			frameResources[KEY_GUI_HOURGLASS] = driver->addRenderTargetTexture(dimension2d<u32>(128, 256));
+			// Hourglass is composed on render targets, which aren't available on every driver
+			if (sandRtt == nullptr || hourglassRtt == nullptr)
 			{
-				driver->setRenderTarget(frameResources[KEY_GUI_HOURGLASS]);
-
-				dimension2du size = frameResources[KEY_GUI_HOURGLASS]->getSize();
-
-				// Data for later
-				recti destRect;
-
-				// Top part
+				guiLayer->setVisible(hourglassImage, false);
+				guiLayer->setVisible(timeText, false);
+			}
+			else
+			{
+				// Compute common size, from the top part of the sand
+				vector2df hudSize;
 				{
-					// Compute source rect
 					const recti sourceRect = Utility::getSourceRect(guiTextures[KEY_GUI_HOURGLASS_SAND_TOP]);
-
-					// Compute common width
 					hudSize.Y = 192.0f;
 					hudSize.X = (f32)sourceRect.getWidth() / (f32)sourceRect.getHeight() * hudSize.Y;
-
-					// Compute common destination rect
-					destRect = recti(vector2di(0), size);
-
-					// Compute clip rect
-					f32 height = (f32)destRect.getHeight() * 0.5f;
-					const recti clipRect(0, (s32)(height * (1.0f - ratio)), destRect.getWidth(), destRect.getHeight());
-
-					// Draw rectangle
-					driver->draw2DImage(guiTextures[KEY_GUI_HOURGLASS_SAND_TOP], destRect, sourceRect, &clipRect, 0, true);
-				}
-
-				// Bottom part
-				{
-					// Compute source rect
-					const recti sourceRect = Utility::getSourceRect(guiTextures[KEY_GUI_HOURGLASS_SAND_BOTTOM]);
-
-					// Compute common destination rect
-					f32 height = (f32)destRect.getHeight() * 0.5f;
-					const recti clipRect(0, (s32)height + (s32)(height * ratio), destRect.getWidth(), destRect.getHeight());
-
-					// Draw rectangle
-					driver->draw2DImage(guiTextures[KEY_GUI_HOURGLASS_SAND_BOTTOM], destRect, sourceRect, &clipRect, 0, true);
-				}
-
-				// Front part
-				{
-					const recti sourceRect = Utility::getSourceRect(guiTextures[KEY_GUI_HOURGLASS]);
-					driver->draw2DImage(guiTextures[KEY_GUI_HOURGLASS], destRect, sourceRect, 0, 0, true);
 				}
 
-				// Restore old render target
-				driver->setRenderTarget(0, false, false);
-			}
-
-			// Render hourglass on separate texture
-			frameResources[KEY_GUI_HOURGLASS_SAND_TOP] = driver->addRenderTargetTexture(dimension2d<u32>(256, 256));
-			{
-				driver->setRenderTarget(frameResources[KEY_GUI_HOURGLASS_SAND_TOP]);
-
-				// Get container size
-				size = (dimension2df)frameResources[KEY_GUI_HOURGLASS_SAND_TOP]->getSize();
-
-				const vector3df containerSize((f32)size.Width, (f32)size.Height, 1.0f);
-				const vector3df halfSize = containerSize * 0.5f - vector3df(hudSize.X, hudSize.Y, 0.0f) * 0.5f;
-
-				vector3df vertices[] =
-				{
-					vector3df(0) + halfSize,
-					vector3df(hudSize.X, 0, 0) + halfSize,
-					vector3df(0, hudSize.Y, 0) + halfSize,
-					vector3df(hudSize.X, hudSize.Y, 0) + halfSize
-				};
-
 				// Rotation animation
 				f32 rotationValue;
 				{
@@ -398,35 +497,107 @@ void SharedData::buildGameScore()
 					rotationValue = degToRad(rotationValue * 180.0f);
 				}
 
-				// Draw hourglass on a separate quad
-				GUIImageSceneNode imageNode(smgr->getRootSceneNode(), smgr, -1);
-				imageNode.setVertices(containerSize, vertices[0], vertices[1], vertices[2], vertices[3], &vector3df(containerSize.X * 0.5f, containerSize.Y * 0.5f, 0.0f), &vector3df(0, 0, rotationValue));
-				imageNode.getMaterial(0).setTexture(0, frameResources[KEY_GUI_HOURGLASS]);
-				imageNode.getMaterial(0).setFlag(EMF_BLEND_OPERATION, true);
-				imageNode.render();
-				imageNode.remove();
+				// Render targets keep their content, so they are updated only when the hourglass has changed
+				if (sandReallocated || hourglassReallocated || ratio != hourglassDrawnRatio || rotationValue != hourglassDrawnRotation)
+				{
+					hourglassDrawnRatio = ratio;
+					hourglassDrawnRotation = rotationValue;
+
+					// Render sand on separate texture
+					{
+						driver->setRenderTarget(sandRtt);
+
+						dimension2du size = sandRtt->getSize();
+
+						// Compute common destination rect
+						const recti destRect = recti(vector2di(0), size);
+
+						// Top part
+						{
+							// Compute source rect
+							const recti sourceRect = Utility::getSourceRect(guiTextures[KEY_GUI_HOURGLASS_SAND_TOP]);
+
+							// Compute clip rect
+							f32 height = (f32)destRect.getHeight() * 0.5f;
+							const recti clipRect(0, (s32)(height * (1.0f - ratio)), destRect.getWidth(), destRect.getHeight());
+
+							// Draw rectangle
+							driver->draw2DImage(guiTextures[KEY_GUI_HOURGLASS_SAND_TOP], destRect, sourceRect, &clipRect, 0, true);
+						}
+
+						// Bottom part
+						{
+							// Compute source rect
+							const recti sourceRect = Utility::getSourceRect(guiTextures[KEY_GUI_HOURGLASS_SAND_BOTTOM]);
+
+							// Compute common destination rect
+							f32 height = (f32)destRect.getHeight() * 0.5f;
+							const recti clipRect(0, (s32)height + (s32)(height * ratio), destRect.getWidth(), destRect.getHeight());
+
+							// Draw rectangle
+							driver->draw2DImage(guiTextures[KEY_GUI_HOURGLASS_SAND_BOTTOM], destRect, sourceRect, &clipRect, 0, true);
+						}
+
+						// Front part
+						{
+							const recti sourceRect = Utility::getSourceRect(guiTextures[KEY_GUI_HOURGLASS]);
+							driver->draw2DImage(guiTextures[KEY_GUI_HOURGLASS], destRect, sourceRect, 0, 0, true);
+						}
+
+						// Restore old render target
+						driver->setRenderTarget(0, false, false);
+					}
+
+					// Render hourglass on separate texture
+					{
+						driver->setRenderTarget(hourglassRtt);
+
+						// Get container size
+						const dimension2df size = (dimension2df)hourglassRtt->getSize();
+
+						const vector3df containerSize(size.Width, size.Height, 1.0f);
+						const vector3df halfSize = containerSize * 0.5f - vector3df(hudSize.X, hudSize.Y, 0.0f) * 0.5f;
+
+						vector3df vertices[] =
+						{
+							vector3df(0) + halfSize,
+							vector3df(hudSize.X, 0, 0) + halfSize,
+							vector3df(0, hudSize.Y, 0) + halfSize,
+							vector3df(hudSize.X, hudSize.Y, 0) + halfSize
+						};
+
+						// Draw hourglass on a separate quad
+						GUIImageSceneNode imageNode(smgr->getRootSceneNode(), smgr, -1);
+						imageNode.setVertices(containerSize, vertices[0], vertices[1], vertices[2], vertices[3], &vector3df(containerSize.X * 0.5f, containerSize.Y * 0.5f, 0.0f), &vector3df(0, 0, rotationValue));
+						imageNode.getMaterial(0).setTexture(0, sandRtt);
+						imageNode.getMaterial(0).setFlag(EMF_BLEND_OPERATION, true);
+						imageNode.render();
+						imageNode.remove();
+
+						// Restore old render target
+						driver->setRenderTarget(0, false, false);
+					}
+				}
 
-				// Restore old render target
-				driver->setRenderTarget(0, false, false);
-			}
+				// Compute final position
+				const dimension2di size = (dimension2di)hourglassRtt->getSize();
+				const vector2di position(windowSize.X - size.Width, windowSize.Y - size.Height);
 
-			// Compute final position
-			const vector2di position(windowSize.X - size.Width, windowSize.Y - size.Height);
+				// Update full hourglass
+				guiLayer->setImage(hourglassImage, hourglassRtt);
+				guiLayer->setRect(hourglassImage, recti(position, size));
+				guiLayer->setColor(hourglassImage, SColor(alpha, 255, 255, 255));
 
-			// Draw full hourglass
-			IGUIImage* image = guienv->addImage(frameResources[KEY_GUI_HOURGLASS_SAND_TOP], position);
-			image->setColor(SColor(alpha, 255, 255, 255));
-			
-			// Draw remaining time
-			if (amount <= 20)
-			{
-				f32 coeff = 1.0f - (f32)amount / 20.0f;
-				u32 timeAlpha = std::min(std::max((s32)((coeff * 510.0f) * (1.0f - gameOverAlpha)), 0), 255);
+				// Update remaining time
+				if (amount <= 20)
+				{
+					f32 coeff = 1.0f - (f32)amount / 20.0f;
+					u32 timeAlpha = std::min(std::max((s32)((coeff * 510.0f) * (1.0f - gameOverAlpha)), 0), 255);
 
-				IGUIStaticText* text = guienv->addStaticText(std::to_wstring(amount).c_str(), recti(position, size));
-				text->setOverrideFont(font);
-				text->setOverrideColor(SColor(timeAlpha, 255, 255, 255));
-				text->setTextAlignment(EGUIA_CENTER, EGUIA_CENTER);
+					guiLayer->setNumber(timeText, amount);
+					guiLayer->setRect(timeText, recti(position, size));
+					guiLayer->setColor(timeText, SColor(timeAlpha, 255, 255, 255));
+				}
 			}
 		}
 	}
@@ -437,7 +608,7 @@ void SharedData::buildGameScore()
 		Utility::animateFloatValue(deltaTime, &levelPointsValue, points);
 	}
 
-	// Draw score points
+	// Update score points
 	for (int i = 0; i < 2; ++i)
 	{
 		// Get value to display
@@ -447,33 +618,28 @@ void SharedData::buildGameScore()
 		s32 y = i ? 192 : 112;
 		SColor color = i ? SColor(alpha, 255, 255, 255) : SColor(alpha, 192, 192, 192);
 
-		// Draw counter
-		IGUIStaticText* text = guienv->addStaticText(std::to_wstring(amount).c_str(), recti(windowSize.X / 8 * 3, windowSize.Y - y, windowSize.X, windowSize.Y - y + 96));
-		text->setOverrideFont(font);
-		text->setOverrideColor(color);
-		text->setTextAlignment(EGUIA_UPPERLEFT, EGUIA_CENTER);
+		// Update counter
+		guiLayer->setNumber(pointTexts[i], amount);
+		guiLayer->setRect(pointTexts[i], recti(windowSize.X / 8 * 3, windowSize.Y - y, windowSize.X, windowSize.Y - y + 96));
+		guiLayer->setColor(pointTexts[i], color);
 	}
 
-	// Draw fruits
+	// Update fruits
+	for (int i = 0; i < 5; ++i)
 	{
-		u8 fruitKeys[] = {
-			KEY_GUI_APPLE, KEY_GUI_BANANA, KEY_GUI_STRAWBERRY, KEY_GUI_WATERMELON, KEY_GUI_PINEAPPLE
-		};
-
-		for (int i = 0; i < 5; ++i)
-		{
-			s32 x = 640 - i * 128;
-			s32 color = getGameScoreValue(KEY_SCORE_FRUITS) > i ? 255 : 0;
+		s32 x = 640 - i * 128;
+		s32 color = getGameScoreValue(KEY_SCORE_FRUITS) > i ? 255 : 0;
 
-			IGUIImage* image = guienv->addImage(guiTextures[fruitKeys[i]], vector2di(windowSize.X - x, 8));
-			image->setColor(SColor(alpha, color, color, color));
-		}
+		const dimension2du size = fruitImages[i]->getImage()->getOriginalSize();
+		guiLayer->setRect(fruitImages[i], recti(vector2di(windowSize.X - x, 8), dimension2di(size)));
+		guiLayer->setColor(fruitImages[i], SColor(alpha, color, color, color));
 	}
 }
 
-void SharedData::buildGameOver()
+void SharedData::updateGameOver()
 {
 	// Check if Game Over screen has been triggered
+	guiLayer->setVisible(gameOverGroup, gameOverAlpha > 0);
 	if (gameOverAlpha <= 0)
 	{
 		return;
@@ -495,13 +661,11 @@ void SharedData::buildGameOver()
 		(u32)(gameOverAlpha * 255.0f)
 	};
 
-	// Draw background image
-	IGUIImage* image = guienv->addImage(guiTextures[KEY_GUI_RECTANGLE], vector2di(0, 0));
-	image->setMinSize(Utility::getWindowSize<u32>(driver));
-	image->setScaleImage(true);
-	image->setColor(SColor(alpha[0], 0, 0, 0));
+	// Update background image
+	guiLayer->setRect(gameOverBackground, recti(vector2di(0), Utility::getWindowSize<s32>(driver)));
+	guiLayer->setColor(gameOverBackground, SColor(alpha[0], 0, 0, 0));
 
-	// Calculate text rectangles, then draw them
+	// Update text rectangles
 	s8 currentSelection = -1;
 	const auto& texts = textGroups[isLevelPassed ? KEY_TEXT_LEVEL_PASSED : KEY_TEXT_GAME_OVER];
 
@@ -520,11 +684,10 @@ void SharedData::buildGameOver()
 			currentSelection = i;
 		}
 
-		// Draw text
-		IGUIStaticText* text = guienv->addStaticText(texts.at(i).c_str(), gameOverRects[i]);
-		text->setOverrideFont(font);
-		text->setOverrideColor(color);
-		text->setTextAlignment(EGUIA_CENTER, EGUIA_CENTER);
+		// Update text
+		guiLayer->setText(gameOverTexts[i], texts.at(i).c_str());
+		guiLayer->setRect(gameOverTexts[i], gameOverRects[i]);
+		guiLayer->setColor(gameOverTexts[i], color);
 	}
 
 	// Commit menu selection
@@ -537,58 +700,35 @@ void SharedData::buildGameOver()
 	}
 	gameOverSelection = currentSelection;
 
-	// Draw completion percentage
+	// Update completion percentage
+	const auto& prefixes = textGroups[KEY_TEXT_LEVEL_SCORE];
+
 	for (int i = 0; i < 3; ++i)
 	{
 		s32 y = (s32)(windowSize.Y * 0.1f) + 128 * i;
 
-		std::wstring str;
-		SColor color;
-
 		if (i == 0)
 		{
-			const std::wstring prefix = isLevelPassed ? L"Level Passed: " : L"Level Failed: ";
-			color = isLevelPassed ? SColor(alpha[1], 0, 255, 0) : SColor(alpha[1], 255, 64, 64);
-
 			const f32 percentage = std::floor((f32)gameScores[KEY_SCORE_ITEMS_PICKED].value / (f32)gameScores[KEY_SCORE_ITEMS_MAX].value * 100.0f);
-			str = prefix + std::to_wstring((s32)percentage) + L"%";
+			guiLayer->setNumber(gameOverStats[i], (s32)percentage, prefixes.at(isLevelPassed ? 0 : 1), L"%");
+			guiLayer->setColor(gameOverStats[i], isLevelPassed ? SColor(alpha[1], 0, 255, 0) : SColor(alpha[1], 255, 64, 64));
 		}
 		else if (i == 1)
 		{
-			str = L"Level Points: " + std::to_wstring(getGameScoreValue(KEY_SCORE_POINTS));
-			color = SColor(255, 255, 255, 0);
+			guiLayer->setNumber(gameOverStats[i], getGameScoreValue(KEY_SCORE_POINTS), prefixes.at(2));
+			guiLayer->setColor(gameOverStats[i], SColor(255, 255, 255, 0));
 		}
 		else if (i == 2)
 		{
-			str = L"Total Points: " + std::to_wstring((s32)globalPointsValue);
-			color = SColor(255, 192, 192, 192);
+			guiLayer->setNumber(gameOverStats[i], (s32)globalPointsValue, prefixes.at(3));
+			guiLayer->setColor(gameOverStats[i], SColor(255, 192, 192, 192));
 		}
 
-		IGUIStaticText* text = guienv->addStaticText(str.c_str(), recti(0, y, (s32)windowSize.X, y + 96));
-		text->setTextAlignment(EGUIA_CENTER, EGUIA_CENTER);
-		text->setOverrideColor(color);
-		text->setOverrideFont(font);
+		guiLayer->setRect(gameOverStats[i], recti(0, y, (s32)windowSize.X, y + 96));
 	}
 
-	// Game Over menu selection
-	if (EventManager::singleton->keyStates[KEY_LBUTTON] == KEY_RELEASED)
-	{
-		if (gameOverSelection == 0)
-		{
-			const auto functionToTrigger = isLevelPassed ? &SharedData::jumpToNextLevel : &SharedData::restartRoom;
-			startFade(true, std::bind(functionToTrigger, this));
-		}
-		else if (gameOverSelection == 1)
-		{
-			startFade(true, std::bind(&SharedData::jumpToMenuRoom, this));
-		}
-	}
-
-	// Draw mouse pointer
-	ITexture* mouse = guiTextures[KEY_GUI_MOUSE];
-	const recti r = Utility::getSourceRect(mouse) + EventManager::singleton->mousePosition;
-	image = guienv->addImage(r);
-	image->setImage(mouse);
+	// Move mouse pointer
+	guiLayer->setRect(gameOverMouse, Utility::getSourceRect(guiTextures[KEY_GUI_MOUSE]) + EventManager::singleton->mousePosition);
 }
 
 void SharedData::jumpToNextLevel()
@@ -652,18 +792,17 @@ void SharedData::resetState()
 	triggerPostProcessingCallback(KEY_PP_WAVE, data);
 }
 
-void SharedData::buildFadeTransition()
+void SharedData::updateFadeTransition()
 {
+	guiLayer->setVisible(fadeImage, fadeValue > 0.0f);
 	if (fadeValue > 0.0f)
 	{
 		// Get window size
 		recti windowRect(vector2di(0), Utility::getWindowSize<s32>(driver));
 
 		// Cover the rectangle for entire window
-		IGUIImage* image = guienv->addImage(windowRect);
-		image->setColor(SColor((s32)(fadeValue * 255.0f), 255, 255, 255));
-		image->setImage(guiTextures[KEY_GUI_RECTANGLE]);
-		image->setScaleImage(true);
+		guiLayer->setRect(fadeImage, windowRect);
+		guiLayer->setColor(fadeImage, SColor((s32)(fadeValue * 255.0f), 255, 255, 255));
 	}
 }
 
@@ -742,20 +881,30 @@ void SharedData::startFade(bool in, std::function<void(void)> fadeCallback)
 	startFade(in, fadeCallback, fadeValue);
 }
 
-void SharedData::buildGUI()
+void SharedData::updateGUI()
 {
-	// Draw in-level HUD
-	if (RoomManager::singleton->isCurrentRoomALevel())
+	// Update in-level HUD
+	const bool isLevel = RoomManager::singleton->isCurrentRoomALevel();
+	guiLayer->setVisible(scoreGroup, isLevel);
+	guiLayer->setVisible(gameOverGroup, isLevel && gameOverAlpha > 0);
+
+	if (isLevel)
 	{
 		// Game score first
-		buildGameScore();
+		updateGameScore();
 
 		// Game over screen on top
-		buildGameOver();
+		updateGameOver();
 	}
 
 	// Fade transition over all
-	buildFadeTransition();
+	updateFadeTransition();
+}
+
+void SharedData::drawGUI()
+{
+	// Back buffer is cleared every frame, so the layer is always drawn, without being rebuilt
+	guiLayer->draw();
 }
 
 void SharedData::displayLevelEnd()
@@ -779,15 +928,6 @@ void SharedData::displayExit()
 	exitTimer = std::make_unique<Alarm>(750.0f);
 }
 
-void SharedData::disposeResourcesAtFrameEnd()
-{
-	for (auto& entry : frameResources)
-	{
-		driver->removeTexture(entry.second);
-	}
-	frameResources.clear();
-}
-
 void SharedData::setPostProcessingCallback(u8 key, std::function<void(const nlohmann::json&)> callback)
 {
 	if (callback == nullptr)
@@ -28,6 +28,7 @@
 
 #define KEY_TEXT_GAME_OVER		0
 #define KEY_TEXT_LEVEL_PASSED	1
+#define KEY_TEXT_LEVEL_SCORE	2
 
 #define KEY_PP_WAVE		0
 #define KEY_PP_RIPPLE	1
@@ -42,6 +43,11 @@
 
 #include "EngineObject.h"
 #include "Alarm.h"
+#include "RenderTargetPool.h"
+#include "GuiLayer.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
+#include "SdfFont.h"
 
 class SharedData : public EngineObject
 {
@@ -82,6 +88,10 @@ protected:
 	// Hourglass
 	f32 hourglassRotation = 0.0f;
 
+	// Hourglass state held by its render targets
+	f32 hourglassDrawnRatio;
+	f32 hourglassDrawnRotation;
+
 	// Variables for fade transition
 	s8 fadeType;
 	std::function<void(void)> fadeCallback;
@@ -89,21 +99,10 @@ protected:
 	// Alarm for time counter
 	std::unique_ptr<Alarm> timeAlarm;
 
-	// Font for GUI
-	IGUIFont* font;
-
 	// Level score points value for animation purposes
 	f32 levelPointsValue;
 	f32 globalPointsValue;
 
-	/*
-		This map holds all the textures that must be disposed
-		at the end of the frame, otherwise severe memory leaks
-		will occur, causing memory usage to jump high, leading
-		to an unavoidable evitably crash of the application.
-	*/
-	std::unordered_map<u8, ITexture*> frameResources;
-
 	// Map to hold post processing effect
 	std::unordered_map<u8, std::function<void(const nlohmann::json&)>> ppCallbacks;
 
@@ -116,14 +115,52 @@ protected:
 	// Map for game scores and related data
 	std::unordered_map<s32, ScoreValue> gameScores;
 
-	// Build fade for transition
-	void buildFadeTransition();
+	// Retained GUI, whose elements are created once and updated every frame
+	std::unique_ptr<GuiLayer> guiLayer;
+
+	// Groups for in-level HUD and for Game Over screen
+	IGUIElement* scoreGroup;
+	IGUIElement* gameOverGroup;
+
+	// Elements of in-level HUD
+	IGUIImage* coinImage;
+	IGUIStaticText* coinText;
+	std::vector<IGUIImage*> keyImages;
+	IGUIImage* hourglassImage;
+	IGUIStaticText* timeText;
+	IGUIStaticText* pointTexts[2];
+	IGUIImage* fruitImages[5];
+
+	// Elements of Game Over screen
+	IGUIImage* gameOverBackground;
+	IGUIStaticText* gameOverTexts[2];
+	IGUIStaticText* gameOverStats[3];
+	IGUIImage* gameOverMouse;
+
+	// Element for fade transition
+	IGUIImage* fadeImage;
+
+	// Create all of the retained GUI elements
+	void createGUI();
+
+	/**
+		Get rectangle for a HUD icon, which is never bigger than 128 pixels per side.
+
+		@param texture the texture of the icon.
+		@param position the upper left corner of the icon.
+
+		@return the rectangle for the icon.
+	*/
+	recti getIconRect(ITexture* texture, const vector2di& position);
+
+	// Update fade for transition
+	void updateFadeTransition();
 
-	// Build GUI from game score
-	void buildGameScore();
+	// Update GUI from game score
+	void updateGameScore();
 
-	// Build GUI for Game Over screen
-	void buildGameOver();
+	// Update GUI for Game Over screen
+	void updateGameOver();
 
 	// Restart room method
 	void restartRoom();
@@ -152,6 +189,12 @@ public:
 	*/
 	ITexture* guiRtt;
 
+	/*
+		GUI RTT keeps its content between frames, so it's cleared only when this flag is set,
+		which happens when the texture has been reallocated or when the HUD drawing on it has gone.
+	*/
+	bool guiRttDirty;
+
 	/*
 		Global render target.
 		In before, this memeber was in the Engine class. Then it has been moved here because
@@ -160,8 +203,30 @@ public:
 	*/
 	irr::core::array<IRenderTarget> sceneRtts;
 
-	// Constructor
+	/*
+		Pool for all of the render targets used by the application. Textures are kept alive
+		between frames and they are reallocated only when the requested size changes, instead
+		of being destroyed and re-created every frame.
+	*/
+	std::unique_ptr<RenderTargetPool> renderTargetPool;
+
+	/*
+		Atlas for GUI textures, packed when assets are loaded, and sprite batch which draws
+		all of the consecutive GUI images sharing the same atlas page with a single draw call.
+	*/
+	std::unique_ptr<TextureAtlas> guiAtlas;
+	std::unique_ptr<SpriteBatch> spriteBatch;
+
+	/*
+		Fonts for titles. Both of them share the same distance field texture, which is built from the
+		bitmap font when assets are loaded, so the small font doesn't need its own pages anymore.
+	*/
+	SdfFont* titleFont;
+	SdfFont* smallTitleFont;
+
+	// Constructor and deconstructor
 	SharedData();
+	~SharedData();
 
 	// Fade transition alpha value
 	f32 fadeValue;
@@ -192,8 +257,11 @@ public:
 
 	void startFade(bool in, std::function<void(void)> fadeCallback);
 
-	// Build GUI from game score
-	void buildGUI();
+	// Update GUI from game score
+	void updateGUI();
+
+	// Draw GUI on the current render target
+	void drawGUI();
 
 	// Display game over GUI menu
 	void displayLevelEnd();
@@ -201,9 +269,6 @@ public:
 	// Display exit menu
 	void displayExit();
 
-	// Dispose unneeded resource at frame end
-	void disposeResourcesAtFrameEnd();
-
 	/*
 		Set function for post processing effect.
 		Supply nullptr for callback to erase the desired key.
@@ -0,0 +1,96 @@
+#include "SimulationClock.h"
+
+const f32 SimulationClock::DEFAULT_TICK_RATE = 60.0f;
+const f32 SimulationClock::DEFAULT_MAX_FRAME_TIME = 250.0f;
+const u32 SimulationClock::DEFAULT_MAX_TICKS_PER_FRAME = 8;
+
+SimulationClock::SimulationClock(f32 tickRate)
+{
+	// Initialize variables
+	maxFrameTime = DEFAULT_MAX_FRAME_TIME;
+	maxTicksPerFrame = DEFAULT_MAX_TICKS_PER_FRAME;
+	fixedFrameTime = 0.0f;
+	setTickRate(tickRate);
+	reset();
+}
+
+void SimulationClock::reset()
+{
+	started = false;
+	accumulator = 0.0;
+	frameDelta = 0.0f;
+}
+
+void SimulationClock::setTickRate(f32 tickRate)
+{
+	tickDelta = 1000.0f / tickRate;
+}
+
+void SimulationClock::setFixedFrameTime(f32 frameTime)
+{
+	fixedFrameTime = frameTime;
+}
+
+u32 SimulationClock::advance()
+{
+	// Use fixed time, if requested
+	if (fixedFrameTime > 0.0f)
+	{
+		return advanceBy(fixedFrameTime);
+	}
+
+	// Measure elapsed time
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	f32 elapsed = 0.0f;
+
+	if (started)
+	{
+		elapsed = std::chrono::duration<f32, std::milli>(now - lastTime).count();
+	}
+	lastTime = now;
+	started = true;
+
+	return advanceBy(elapsed);
+}
+
+u32 SimulationClock::advanceBy(f32 elapsed)
+{
+	// Clamp long frames (debugger breaks, window dragging, etc...)
+	if (elapsed > maxFrameTime)
+	{
+		elapsed = maxFrameTime;
+	}
+	frameDelta = elapsed;
+	accumulator += elapsed;
+
+	// Count ticks to be simulated
+	u32 ticks = 0;
+	while (accumulator >= tickDelta && ticks < maxTicksPerFrame)
+	{
+		accumulator -= tickDelta;
+		++ticks;
+	}
+
+	// Drop the time which can't be simulated without falling behind
+	if (accumulator >= tickDelta)
+	{
+		accumulator = 0.0;
+	}
+
+	return ticks;
+}
+
+f32 SimulationClock::getTickDelta()
+{
+	return tickDelta;
+}
+
+f32 SimulationClock::getFrameDelta()
+{
+	return frameDelta;
+}
+
+f32 SimulationClock::getInterpolation()
+{
+	return (f32)(accumulator / tickDelta);
+}
\ No newline at end of file
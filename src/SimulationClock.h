@@ -0,0 +1,81 @@
+#ifndef SIMULATIONCLOCK_H
+#define SIMULATIONCLOCK_H
+
+#include <chrono>
+#include <irrlicht.h>
+
+using namespace irr;
+
+class SimulationClock
+{
+protected:
+
+	// High resolution timestamp of the last advance
+	std::chrono::steady_clock::time_point lastTime;
+	bool started;
+
+	// Accumulated time not yet consumed by simulation ticks, in milliseconds
+	f64 accumulator;
+
+	// Fixed tick duration, in milliseconds
+	f32 tickDelta;
+
+	// Real time elapsed during the last frame, in milliseconds
+	f32 frameDelta;
+
+	// Frame time used in place of the measured one, when greater than zero
+	f32 fixedFrameTime;
+
+	// Spiral-of-death protection
+	f32 maxFrameTime;
+	u32 maxTicksPerFrame;
+
+public:
+
+	// Default values
+	static const f32 DEFAULT_TICK_RATE;
+	static const f32 DEFAULT_MAX_FRAME_TIME;
+	static const u32 DEFAULT_MAX_TICKS_PER_FRAME;
+
+	// Constructor
+	SimulationClock(f32 tickRate = DEFAULT_TICK_RATE);
+
+	// Forget any elapsed time, so next frame starts from scratch
+	void reset();
+
+	// Set amount of simulation ticks per second
+	void setTickRate(f32 tickRate);
+
+	// Make every frame last the given time, in milliseconds, regardless of the real time. Pass 0 to measure real time again
+	void setFixedFrameTime(f32 frameTime);
+
+	/**
+		Measure the real time elapsed since the last call with a high resolution timer,
+		and accumulate it. When a fixed frame time is set, that time is accumulated instead.
+
+		@return the number of fixed ticks to be simulated during this frame.
+	*/
+	u32 advance();
+
+	/**
+		Accumulate the given amount of time, instead of the measured one. Elapsed time is clamped
+		to the maximum frame time, and ticks which exceed the maximum amount per frame are dropped,
+		so a slow frame can't make the following ones even slower.
+
+		@param elapsed the time elapsed since the last frame, in milliseconds.
+
+		@return the number of fixed ticks to be simulated during this frame.
+	*/
+	u32 advanceBy(f32 elapsed);
+
+	// Fixed tick duration, in milliseconds
+	f32 getTickDelta();
+
+	// Real time elapsed during the last frame, in milliseconds
+	f32 getFrameDelta();
+
+	// Fraction of tick left in the accumulator, used to interpolate between the previous and the current state
+	f32 getInterpolation();
+};
+
+#endif // SIMULATIONCLOCK_H
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "RoomManager.h"
 #include "Player.h"
 #include "Camera.h"
+#include "MaterialCache.h"
 
 using nlohmann::json;
 
@@ -93,27 +94,17 @@ Solid::Solid(std::optional<std::array<f32, 4>> & delayedParams, const f32 breakS
 		{
 			texture = driver->getTexture("textures/block.png");
 
-			// Create shader for glass
-			SpecializedShaderCallback* ssc = new SpecializedShaderCallback(this);
-			IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-
-			material = gpu->addHighLevelShaderMaterialFromFiles("shaders/glass.vs", "shaders/glass.fs", ssc, EMT_TRANSPARENT_VERTEX_ALPHA);
-
-			ssc->drop();
+			// Get shader for glass
+			material = MaterialCache::singleton->getMaterial<SpecializedShaderCallback>("shaders/glass.vs", "shaders/glass.fs", EMT_TRANSPARENT_VERTEX_ALPHA, true);
 		}
 		else
 		{
 			texture = driver->getTexture("textures/block.png");
 
-			// Create shader for delayed block
+			// Get shader for delayed block
 			if (delayedParams != std::nullopt)
 			{
-				SpecializedShaderCallback* ssc = new SpecializedShaderCallback(this);
-
-				IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-				material = gpu->addHighLevelShaderMaterialFromFiles("shaders/standard.vs", "shaders/delayed.fs", ssc, EMT_TRANSPARENT_VERTEX_ALPHA);
-
-				ssc->drop();
+				material = MaterialCache::singleton->getMaterial<SpecializedShaderCallback>("shaders/standard.vs", "shaders/delayed.fs", EMT_TRANSPARENT_VERTEX_ALPHA);
 			}
 			else
 			{
@@ -139,13 +130,8 @@ Solid::Solid(std::optional<std::array<f32, 4>> & delayedParams, const f32 breakS
 				// Load texture for normal mapping
 				normalMap = driver->getTexture("textures/block_nm.png");
 
-				// Create shader for normal mapping
-				SpecializedShaderCallback* ssc = new SpecializedShaderCallback(this);
-
-				IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-				material = gpu->addHighLevelShaderMaterialFromFiles("shaders/standard.vs", "shaders/standard.fs", ssc);
-
-				ssc->drop();
+				// Get shader for normal mapping
+				material = MaterialCache::singleton->getMaterial<SpecializedShaderCallback>("shaders/standard.vs", "shaders/standard.fs");
 			}
 		}
 
@@ -162,6 +148,9 @@ Solid::Solid(std::optional<std::array<f32, 4>> & delayedParams, const f32 breakS
 	model->material = material;
 	models.push_back(model);
 
+	// Plain blocks never move nor change, so they can be merged into the static batch
+	model->isStatic = breakState < 0.0f && springTension < 0.0f && invisibleToggle < 0 && delayedParams == std::nullopt;
+
 	if (normalMap != nullptr)
 	{
 		model->addTexture(1, normalMap);
@@ -179,6 +168,7 @@ Solid::Solid(std::optional<std::array<f32, 4>> & delayedParams, const f32 breakS
 	this->delayedParams = delayedParams;
 	this->springAngle = 0.0f;
 	this->delayedAlarm = nullptr;
+	this->playerContact = nullptr;
 
 	// Check if block is a spring
 	if (springTension >= 0.0f)
@@ -226,13 +216,8 @@ void Solid::update()
 			// Execute behaviour
 			else
 			{
-				// Check collision on top against player
-				const aabbox3df bbox = models.at(0)->mesh->getBoundingBox();
-				aabbox3df rect(bbox);
-				Utility::getVerticalAABBox(bbox, rect, 1.0f, 0.05f);
-
-				Collision collision = checkBoundingBoxCollision<Player>(RoomManager::singleton->gameObjects, rect);
-				if (collision.engineObject != nullptr)
+				// Check if player has been found on top by the last contact pass
+				if (playerContact != nullptr)
 				{
 					// Increment state
 					breakState += 0.02f * deltaTime;
@@ -275,17 +260,11 @@ void Solid::update()
 		// Compute total angle for spring animation
 		const f32 totalSpringAngle = 30.0f + 60.0f * springTension;
 
-		// Compute collision bbox
-		const aabbox3df bbox = getBoundingBox();
-		aabbox3df rect(bbox);
-		Utility::getVerticalAABBox(bbox, rect, 1.1f);
-
-		// Check collision against player
-		Collision collision = checkBoundingBoxCollision<Player>(RoomManager::singleton->gameObjects, rect);
-		if (collision.engineObject != nullptr)
+		// Check if player has been found on top by the last contact pass
+		if (playerContact != nullptr)
 		{
-			// Cast to player object
-			const std::shared_ptr<Player> player = collision.getGameObject<Player>();
+			// Get player object
+			const std::shared_ptr<Player> player = playerContact;
 
 			// Adjust spring tension effect based on player position
 			const f32 diff = std::max(std::abs(player->position.X - position.X) - 10.0f, 0.0f) / 10.0f;
@@ -310,29 +289,6 @@ void Solid::update()
 			}
 		}
 	}
-}
-
-void Solid::draw()
-{
-	// Update model
-	if (models.size() >= 1)
-	{
-		std::shared_ptr<Model> model = models.at(0);
-		model->position = position;
-	}
-
-	// Update spring model
-	if (models.size() >= 2)
-	{
-		const f32 factor = std::sin(degToRad(springAngle));
-
-		std::shared_ptr<Model> model = models.at(1);
-		model->position = position + vector3df(0, 8 + factor * 4, 0);
-
-		model = models.at(2);
-		model->position = position + vector3df(0, -9.5f, 0);
-		model->scale = vector3df(1, 1.0f + factor * 0.2f, 1);
-	}
 
 	// Check if block is delayed
 	if (delayedParams != std::nullopt)
@@ -393,6 +349,75 @@ void Solid::draw()
 	{
 		delayedAlarm = nullptr;
 	}
+
+	// Player must be found again by the next contact pass
+	playerContact = nullptr;
+}
+
+void Solid::onContact(const Collision& contact, const u8 state)
+{
+	// Only breakable and spring blocks react, while still having their model
+	if (state == CONTACT_EXIT || (breakState < 0.0f && springTension < 0.0f) || models.size() == 0)
+	{
+		return;
+	}
+
+	// Check if contact is against player
+	const std::shared_ptr<GameObject> other = contact.getGameObject<GameObject>();
+	if (!(other->collisionMask & (1 << COLLISION_LAYER_PLAYER)))
+	{
+		return;
+	}
+
+	// Breakable blocks are stepped on around the center of their top, while springs on the whole top
+	aabbox3df rect;
+	if (breakState >= 0.0f)
+	{
+		const aabbox3df bbox = models.at(0)->mesh->getBoundingBox();
+		rect = bbox;
+		Utility::getVerticalAABBox(bbox, rect, 1.0f, 0.05f);
+	}
+	else
+	{
+		const aabbox3df bbox = getBoundingBox();
+		rect = bbox;
+		Utility::getVerticalAABBox(bbox, rect, 1.1f);
+	}
+	Utility::transformAABBox(rect, position);
+
+	// Keep player for the next update
+	if (rect.intersectsWithBox(contact.otherBoundingBox))
+	{
+		playerContact = contact.getGameObject<Player>();
+	}
+}
+
+s32 Solid::getCollisionLayer()
+{
+	return COLLISION_LAYER_SOLID;
+}
+
+void Solid::draw()
+{
+	// Update model
+	if (models.size() >= 1)
+	{
+		std::shared_ptr<Model> model = models.at(0);
+		model->position = getDrawPosition();
+	}
+
+	// Update spring model
+	if (models.size() >= 2)
+	{
+		const f32 factor = std::sin(degToRad(springAngle));
+
+		std::shared_ptr<Model> model = models.at(1);
+		model->position = getDrawPosition() + vector3df(0, 8 + factor * 4, 0);
+
+		model = models.at(2);
+		model->position = getDrawPosition() + vector3df(0, -9.5f, 0);
+		model->scale = vector3df(1, 1.0f + factor * 0.2f, 1);
+	}
 }
 
 aabbox3df Solid::getBoundingBox()
@@ -400,6 +425,101 @@ aabbox3df Solid::getBoundingBox()
 	return boundingBox;
 }
 
+bool Solid::isUpdateThreadSafe()
+{
+	return breakState < 0.0f && springTension < 0.0f;
+}
+
+bool Solid::canSleep()
+{
+	// Broken blocks must finish their animation, so they are destroyed
+	return breakState < BREAKING_THRESHOLD && models.size() > 0;
+}
+
+f32 Solid::getWakeDelay()
+{
+	// Delayed blocks are woken to switch with a real update
+	if (delayedParams != std::nullopt)
+	{
+		const std::array<f32, 4>& item = delayedParams.value();
+		if (delayedAlarm != nullptr)
+		{
+			return delayedAlarm->getTime();
+		}
+		else if (std::get<0>(item) == 0)
+		{
+			return std::get<1>(item);
+		}
+		else if (std::get<0>(item) == 1)
+		{
+			return std::get<2>(item);
+		}
+	}
+	return -1;
+}
+
+void Solid::onSleep()
+{
+	// Player may have been moved away while stepping on this block
+	if (breakState >= 0.0f)
+	{
+		sounds[KEY_SOUND_BREAKING]->stop();
+	}
+	playerContact = nullptr;
+}
+
+void Solid::onWake(const f32 elapsed, const u32 ticks)
+{
+	// Release spring, since the player was far
+	if (springTension >= 0.0f)
+	{
+		const f32 totalSpringAngle = 30.0f + 60.0f * springTension;
+		springAngle = std::min(springAngle + 0.25f * elapsed, totalSpringAngle);
+	}
+
+	// Fade delayed block towards its current state, whose timer can't have triggered. Steps are replayed, so
+	// the block becomes solid and switches on the same tick
+	if (delayedParams != std::nullopt)
+	{
+		std::array<f32, 4>& item = delayedParams.value();
+
+		if (std::get<0>(item) == 0)
+		{
+			for (u32 i = 0; i < ticks && std::get<3>(item) < 1.0f; ++i)
+			{
+				std::get<3>(item) += 0.001f * deltaTime;
+				if (std::get<3>(item) > 1.0f)
+				{
+					std::get<3>(item) = 1.0f;
+				}
+			}
+
+			if (delayedAlarm == nullptr)
+			{
+				delayedAlarm = std::make_unique<Alarm>(std::get<1>(item));
+			}
+			delayedAlarm->stepDecrement(deltaTime, ticks);
+		}
+		else if (std::get<0>(item) == 1)
+		{
+			for (u32 i = 0; i < ticks && std::get<3>(item) > 0.0f; ++i)
+			{
+				std::get<3>(item) -= 0.001f * deltaTime;
+				if (std::get<3>(item) < 0.0f)
+				{
+					std::get<3>(item) = 0.0f;
+				}
+			}
+
+			if (delayedAlarm == nullptr)
+			{
+				delayedAlarm = std::make_unique<Alarm>(std::get<2>(item));
+			}
+			delayedAlarm->stepDecrement(deltaTime, ticks);
+		}
+	}
+}
+
 bool Solid::isSolid()
 {
 	if (delayedParams != std::nullopt)
@@ -409,9 +529,54 @@ bool Solid::isSolid()
 	return breakState < BREAKING_THRESHOLD;
 }
 
-Solid::SpecializedShaderCallback::SpecializedShaderCallback(Solid* solid)
+u8 Solid::getTileFlags()
+{
+	u8 flags = 0;
+	flags |= breakState >= 0.0f ? TILE_BREAKABLE : 0;
+	flags |= springTension >= 0.0f ? TILE_SPRING : 0;
+	flags |= delayedParams != std::nullopt ? TILE_DELAYED : 0;
+	flags |= invisibleToggle >= 0 ? TILE_INVISIBLE : 0;
+	return flags;
+}
+
+Solid::SpecializedShaderCallback::SpecializedShaderCallback()
 {
-	this->solid = solid;
+	alphaMapId = -1;
+	timeId = -1;
+	lookAtId = -1;
+	fadeWhenFarId = -1;
+}
+
+void Solid::SpecializedShaderCallback::resolveConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::resolveConstants(services);
+	normalMapping.resolve(services);
+
+	alphaMapId = services->getPixelShaderConstantID("alphaMap");
+	timeId = services->getPixelShaderConstantID("time");
+	lookAtId = services->getVertexShaderConstantID("lookAt");
+	fadeWhenFarId = services->getVertexShaderConstantID("fadeWhenFar");
+}
+
+void Solid::SpecializedShaderCallback::setFrameConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::setFrameConstants(services);
+	normalMapping.setFrameConstants(services);
+
+	// Set texture layer for delayed blocks
+	s32 layer1 = 1;
+	services->setPixelShaderConstant(alphaMapId, &layer1, 1);
+
+	// Set camera data for invisible blocks
+	const vector3df p = Camera::singleton->getLookAt();
+	services->setVertexShaderConstant(lookAtId, &p.X, 3);
+
+	// Only the program without alpha map uses "time" as timer, since delayed blocks use it for their state
+	if (alphaMapId == -1)
+	{
+		s32 time = (s32)device->getTimer()->getTime();
+		services->setPixelShaderConstant(timeId, &time, 1);
+	}
 }
 
 void Solid::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServices* services, s32 userData)
@@ -419,32 +584,26 @@ void Solid::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServices*
 	// Execute parent method
 	ShaderCallback::OnSetConstants(services, userData);
 
-	// Set shader values
-	s32 layer0 = 0;
-	services->setPixelShaderConstant("tex", (s32*)&layer0, 1);
+	// Get block being drawn
+	Solid* solid = static_cast<Solid*>(instance);
+	if (solid == nullptr)
+	{
+		return;
+	}
 
 	// Block is delayed
 	if (solid->delayedParams != std::nullopt)
 	{
-		s32 layer1 = 1;
-		services->setPixelShaderConstant("alphaMap", (s32*)&layer1, 1);
-
 		std::array<f32, 4>& item = solid->delayedParams.value();
-		services->setPixelShaderConstant("time", &std::get<3>(item), 1);
+		services->setPixelShaderConstant(timeId, &std::get<3>(item), 1);
 	}
 	// Block is invisible
 	else
 	{
 		// Apply normal map if required
-		solid->applyNormalMapping(services, solid->models.at(0));
-
-		const vector3df p = Camera::singleton->getLookAt();
-		services->setVertexShaderConstant("lookAt", &p.X, 3);
+		solid->applyNormalMapping(services, normalMapping, solid->models.at(0));
 
 		f32 fadeWhenFar = solid->invisibleToggle == 1 ? 1.0f : 0.0f;
-		services->setVertexShaderConstant("fadeWhenFar", &fadeWhenFar, 1);
-
-		s32 time = (s32)device->getTimer()->getTime();
-		services->setPixelShaderConstant("time", &time, 1);
+		services->setVertexShaderConstant(fadeWhenFarId, &fadeWhenFar, 1);
 	}
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include "GameObject.h"
 #include "ShaderCallback.h"
 #include "Alarm.h"
+#include "TileMap.h"
+
+class Player;
 
 class Solid : public GameObject
 {
@@ -27,6 +30,9 @@ protected:
 	std::optional<std::array<f32, 4>> delayedParams;
 	std::unique_ptr<Alarm> delayedAlarm;
 
+	// Player found on top by the last contact pass, for breakable and spring blocks
+	std::shared_ptr<Player> playerContact;
+
 public:
 	/*
 		Constructor for Solid class. Don't pass any parameter (or pass the default ones) to
@@ -55,20 +61,45 @@ public:
 	void draw();
 	aabbox3df getBoundingBox();
 
+	// Collision layer
+	s32 getCollisionLayer();
+
+	// Find player on top, for breakable and spring blocks
+	void onContact(const Collision& contact, const u8 state);
+
+	// Plain and delayed blocks only step their own timers
+	bool isUpdateThreadSafe();
+
+	// Far blocks sleep until delayed ones switch, catching up on their animations when woken
+	bool canSleep();
+	f32 getWakeDelay();
+	void onSleep();
+	void onWake(const f32 elapsed, const u32 ticks);
+
 	// Create specialized instance
 	static std::shared_ptr<Solid> createInstance(const nlohmann::json &jsonData);
 	
 	// Behaviour
 	bool isSolid();
 
+	// Get the "TILE_*" flags describing this block, for the tilemap of the room
+	u8 getTileFlags();
+
 	// ShaderCallBack
-	class SpecializedShaderCallback : public ShaderCallback
+	class SpecializedShaderCallback : public InstanceShaderCallback
 	{
 	protected:
-		Solid* solid;
+		NormalMappingConstants normalMapping;
+		s32 alphaMapId;
+		s32 timeId;
+		s32 lookAtId;
+		s32 fadeWhenFarId;
+
+		virtual void resolveConstants(IMaterialRendererServices* services);
+		virtual void setFrameConstants(IMaterialRendererServices* services);
 
 	public:
-		SpecializedShaderCallback(Solid* solid);
+		SpecializedShaderCallback();
 		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
 	};
 };
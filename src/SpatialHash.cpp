@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cmath>
+#include "SpatialHash.h"
+#include "GameObject.h"
+
+const u32 SpatialHash::MAX_ENTRY_CELLS = 64;
+
+SpatialHash::SpatialHash(const f32 cellSize)
+{
+	// Assign members
+	this->cellSize = cellSize;
+
+	// Initialize variables
+	nextSequence = 0;
+	resetCounters();
+}
+
+u64 SpatialHash::getCellKey(const s32 x, const s32 y)
+{
+	return ((u64)(u32)x << 32) | (u64)(u32)y;
+}
+
+vector2di SpatialHash::getCell(const f32 x, const f32 y)
+{
+	return vector2di((s32)std::floor(x / cellSize), (s32)std::floor(y / cellSize));
+}
+
+void SpatialHash::link(Entry* entry)
+{
+	// Big entries are kept aside, instead of being copied into a lot of cells
+	const u64 width = (u64)(entry->maxCell.X - entry->minCell.X) + 1;
+	const u64 height = (u64)(entry->maxCell.Y - entry->minCell.Y) + 1;
+	entry->oversized = width * height > MAX_ENTRY_CELLS;
+
+	if (entry->oversized)
+	{
+		oversizedCell.entries.push_back(entry);
+		oversizedCell.boxes.push(entry->box);
+	}
+	else
+	{
+		for (s32 y = entry->minCell.Y; y <= entry->maxCell.Y; ++y)
+		{
+			for (s32 x = entry->minCell.X; x <= entry->maxCell.X; ++x)
+			{
+				Cell& cell = cells[getCellKey(x, y)];
+				cell.entries.push_back(entry);
+				cell.boxes.push(entry->box);
+			}
+		}
+	}
+
+	entry->linked = true;
+}
+
+bool SpatialHash::erase(Cell& cell, Entry* entry)
+{
+	// Swap with the last element, since order inside a cell doesn't matter
+	const auto& iterator = std::find(cell.entries.begin(), cell.entries.end(), entry);
+	if (iterator != cell.entries.end())
+	{
+		cell.boxes.swapRemove((u32)(iterator - cell.entries.begin()));
+		*iterator = cell.entries.back();
+		cell.entries.pop_back();
+	}
+
+	return cell.entries.empty();
+}
+
+void SpatialHash::unlink(Entry* entry)
+{
+	if (!entry->linked)
+	{
+		return;
+	}
+
+	if (entry->oversized)
+	{
+		erase(oversizedCell, entry);
+	}
+	else
+	{
+		for (s32 y = entry->minCell.Y; y <= entry->maxCell.Y; ++y)
+		{
+			for (s32 x = entry->minCell.X; x <= entry->maxCell.X; ++x)
+			{
+				// Release empty cells, so rooms walked by moving objects don't grow the map
+				const auto& iterator = cells.find(getCellKey(x, y));
+				if (iterator != cells.end() && erase(iterator->second, entry))
+				{
+					cells.erase(iterator);
+				}
+			}
+		}
+	}
+
+	entry->linked = false;
+}
+
+void SpatialHash::collect(Cell& cell, const aabbox3df& box, std::vector<const Entry*>& result)
+{
+	const u32 count = (u32)cell.entries.size();
+	visitedEntries += count;
+
+	// Test all of the boxes of the cell at once, then walk the bits of the hits
+	cell.boxes.intersect(box, mask);
+
+	for (u32 i = 0; i < count; i += 32)
+	{
+		u32 bits = mask[i >> 5];
+		for (u32 j = i; bits != 0; ++j, bits >>= 1)
+		{
+			Entry* entry = cell.entries[j];
+			if ((bits & 1) && queryStamp.mark(entry->queryStamp))
+			{
+				result.push_back(entry);
+			}
+		}
+	}
+}
+
+void SpatialHash::clear()
+{
+	entries.clear();
+	cells.clear();
+	oversizedCell.entries.clear();
+	oversizedCell.boxes.clear();
+	nextSequence = 0;
+}
+
+void SpatialHash::insert(const std::shared_ptr<GameObject>& gameObject)
+{
+	Entry& entry = entries[gameObject.get()];
+	entry.gameObject = gameObject;
+	entry.sequence = nextSequence++;
+	entry.linked = false;
+	entry.oversized = false;
+	entry.queryStamp = 0;
+}
+
+void SpatialHash::update(GameObject* gameObject, const aabbox3df& box)
+{
+	const auto& iterator = entries.find(gameObject);
+	if (iterator == entries.end())
+	{
+		return;
+	}
+
+	// Entry is already linked to the cells of the same box
+	Entry* entry = &iterator->second;
+	if (entry->linked && entry->box == box)
+	{
+		return;
+	}
+
+	const vector2di minCell = getCell(box.MinEdge.X, box.MinEdge.Y);
+	const vector2di maxCell = getCell(box.MaxEdge.X, box.MaxEdge.Y);
+
+	// Refresh the stored boxes in place, when the box is still covering the same cells
+	if (entry->linked && entry->minCell == minCell && entry->maxCell == maxCell)
+	{
+		entry->box = box;
+
+		if (entry->oversized)
+		{
+			const auto& index = std::find(oversizedCell.entries.begin(), oversizedCell.entries.end(), entry);
+			oversizedCell.boxes.set((u32)(index - oversizedCell.entries.begin()), box);
+			return;
+		}
+
+		for (s32 y = minCell.Y; y <= maxCell.Y; ++y)
+		{
+			for (s32 x = minCell.X; x <= maxCell.X; ++x)
+			{
+				Cell& cell = cells[getCellKey(x, y)];
+				const auto& index = std::find(cell.entries.begin(), cell.entries.end(), entry);
+				cell.boxes.set((u32)(index - cell.entries.begin()), box);
+			}
+		}
+		return;
+	}
+
+	// Otherwise relink it
+	unlink(entry);
+	entry->box = box;
+	entry->minCell = minCell;
+	entry->maxCell = maxCell;
+	link(entry);
+}
+
+void SpatialHash::remove(GameObject* gameObject)
+{
+	const auto& iterator = entries.find(gameObject);
+	if (iterator == entries.end())
+	{
+		return;
+	}
+
+	unlink(&iterator->second);
+	entries.erase(iterator);
+}
+
+void SpatialHash::query(const aabbox3df& box, std::vector<const Entry*>& result)
+{
+	// Start a new query, so entries found by the previous ones can be collected again
+	queryStamp.next([this]()
+	{
+		for (auto& pair : entries)
+		{
+			pair.second.queryStamp = 0;
+		}
+	});
+	++queries;
+
+	const size_t first = result.size();
+	const vector2di minCell = getCell(box.MinEdge.X, box.MinEdge.Y);
+	const vector2di maxCell = getCell(box.MaxEdge.X, box.MaxEdge.Y);
+	const u64 width = (u64)(maxCell.X - minCell.X) + 1;
+	const u64 height = (u64)(maxCell.Y - minCell.Y) + 1;
+
+	// Visit the cells covered by the box, or all of the non-empty cells when they are fewer
+	if (width * height <= (u64)cells.size())
+	{
+		for (s32 y = minCell.Y; y <= maxCell.Y; ++y)
+		{
+			for (s32 x = minCell.X; x <= maxCell.X; ++x)
+			{
+				++visitedCells;
+
+				const auto& iterator = cells.find(getCellKey(x, y));
+				if (iterator != cells.end())
+				{
+					collect(iterator->second, box, result);
+				}
+			}
+		}
+	}
+	else
+	{
+		for (auto& pair : cells)
+		{
+			++visitedCells;
+
+			const s32 x = (s32)(u32)(pair.first >> 32);
+			const s32 y = (s32)(u32)pair.first;
+			if (x >= minCell.X && x <= maxCell.X && y >= minCell.Y && y <= maxCell.Y)
+			{
+				collect(pair.second, box, result);
+			}
+		}
+	}
+
+	// Big entries are tested by every query
+	collect(oversizedCell, box, result);
+
+	// Follow registration order, which is the same of the game objects vector
+	std::sort(result.begin() + first, result.end(), [](const Entry* a, const Entry* b)
+	{
+		return a->sequence < b->sequence;
+	});
+}
+
+void SpatialHash::getEntries(std::vector<const Entry*>& result)
+{
+	const size_t first = result.size();
+
+	for (const auto& pair : entries)
+	{
+		if (pair.second.linked)
+		{
+			result.push_back(&pair.second);
+		}
+	}
+
+	std::sort(result.begin() + first, result.end(), [](const Entry* a, const Entry* b)
+	{
+		return a->sequence < b->sequence;
+	});
+}
+
+u32 SpatialHash::getEntryCount()
+{
+	return (u32)entries.size();
+}
+
+u32 SpatialHash::getCellCount()
+{
+	return (u32)cells.size();
+}
+
+f64 SpatialHash::getAverageVisitedCells()
+{
+	return queries > 0 ? (f64)visitedCells / (f64)queries : 0.0;
+}
+
+f64 SpatialHash::getAverageVisitedEntries()
+{
+	return queries > 0 ? (f64)visitedEntries / (f64)queries : 0.0;
+}
+
+void SpatialHash::resetCounters()
+{
+	queries = 0;
+	visitedCells = 0;
+	visitedEntries = 0;
+}
\ No newline at end of file
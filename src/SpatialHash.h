@@ -0,0 +1,145 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <irrlicht.h>
+
+#include "BoxArray.h"
+#include "QueryStamp.h"
+
+using namespace irr;
+using namespace core;
+
+class GameObject;
+
+class SpatialHash
+{
+public:
+
+	// Structure for a registered game object
+	struct Entry
+	{
+		std::shared_ptr<GameObject> gameObject;
+		u32 sequence;
+		aabbox3df box;
+		vector2di minCell;
+		vector2di maxCell;
+		bool linked;
+		bool oversized;
+		u32 queryStamp;
+	};
+
+protected:
+
+	// Structure for the entries overlapping a cell, whose boxes are stored in the same order
+	struct Cell
+	{
+		std::vector<Entry*> entries;
+		BoxArray boxes;
+	};
+
+	// Maximum amount of cells covered by a single entry. Bigger ones are checked by every query
+	static const u32 MAX_ENTRY_CELLS;
+
+	// Size of every cell, in world units per side. Depth is ignored, since rooms are laid on the XY plane
+	f32 cellSize;
+
+	// Map to hold entries, by their game object. Nodes are never moved, so cells can point to them
+	std::unordered_map<GameObject*, Entry> entries;
+
+	// Map to hold the entries overlapping every non-empty cell, by packed cell coordinates
+	std::unordered_map<u64, Cell> cells;
+
+	// Entries which cover too many cells
+	Cell oversizedCell;
+
+	// Hit mask of the last tested cell, with one bit per entry in the same order
+	std::vector<u32> mask;
+
+	// Sequence for the next registered game object, so queries can follow registration order
+	u32 nextSequence;
+
+	// Stamp of the running query, so entries found in more than one cell are collected once
+	QueryStamp queryStamp;
+
+	// Counters
+	u32 queries;
+	u64 visitedCells;
+	u64 visitedEntries;
+
+	// Pack cell coordinates into a key
+	static u64 getCellKey(const s32 x, const s32 y);
+
+	// Get the cell holding a point
+	vector2di getCell(const f32 x, const f32 y);
+
+	// Add entry to the cells covered by its box
+	void link(Entry* entry);
+
+	// Remove entry from the cells covered by its box
+	void unlink(Entry* entry);
+
+	// Remove entry from a cell, returning true if the cell is left empty
+	static bool erase(Cell& cell, Entry* entry);
+
+	// Collect the entries of a cell whose boxes intersect the one of the running query
+	void collect(Cell& cell, const aabbox3df& box, std::vector<const Entry*>& result);
+
+public:
+
+	// Constructor
+	SpatialHash(const f32 cellSize);
+
+	// Remove all of the entries
+	void clear();
+
+	/**
+		Register a game object. It is not found by queries until its box is set with "update".
+
+		@param gameObject the game object. Registration order decides the order of query results.
+	*/
+	void insert(const std::shared_ptr<GameObject>& gameObject);
+
+	/**
+		Set the world bounding box of a registered game object. Nothing is done when the box is
+		unchanged, while cells are only relinked when the box moves into different ones.
+
+		@param gameObject the game object.
+		@param box the world bounding box.
+	*/
+	void update(GameObject* gameObject, const aabbox3df& box);
+
+	// Unregister a game object
+	void remove(GameObject* gameObject);
+
+	/**
+		Collect the entries whose boxes intersect a box. Only the cells covered by the box are visited,
+		and their boxes are tested several at a time by "BoxArray".
+
+		@param box the world box to look around.
+		@param result the vector where entries are appended, sorted by registration order.
+	*/
+	void query(const aabbox3df& box, std::vector<const Entry*>& result);
+
+	// Collect all of the entries whose box has been set, sorted by registration order
+	void getEntries(std::vector<const Entry*>& result);
+
+	// Amount of registered game objects
+	u32 getEntryCount();
+
+	// Amount of non-empty cells
+	u32 getCellCount();
+
+	// Average amount of cells visited by a query, since the last counter reset
+	f64 getAverageVisitedCells();
+
+	// Average amount of boxes tested by a query, since the last counter reset
+	f64 getAverageVisitedEntries();
+
+	// Reset query counters
+	void resetCounters();
+};
+
+#endif // SPATIALHASH_H
\ No newline at end of file
@@ -70,6 +70,7 @@ Spikes::Spikes(s8 initialMode, f32 delay) : GameObject()
 		model->addTexture(1, normalMap);
 		model->material = getCommonBasicMaterial(EMT_SOLID);
 		model->normalMapping.textureIndex = 1;
+		model->isStatic = true;
 		models.push_back(model);
 	}
 	else
@@ -143,8 +144,8 @@ void Spikes::update()
 			mode = 0;
 			timer->setTime(1500);
 
-			// Play spatial sound
-			playAudio(KEY_SOUND_SPIKE_OUT, &position);
+			// Play spatial sound on commit
+			pendingSound = KEY_SOUND_SPIKE_OUT;
 		}
 		else
 		{
@@ -152,8 +153,8 @@ void Spikes::update()
 			mode = 1;
 			timer->setTime(2250);
 
-			// Play spatial sound
-			playAudio(KEY_SOUND_SPIKE_IN, &position);
+			// Play spatial sound on commit
+			pendingSound = KEY_SOUND_SPIKE_IN;
 		}
 	}
 
@@ -176,17 +177,87 @@ void Spikes::update()
 	}
 }
 
+bool Spikes::isUpdateThreadSafe()
+{
+	return true;
+}
+
+void Spikes::commit()
+{
+	// Play deferred sound
+	if (pendingSound.length() > 0)
+	{
+		playAudio(pendingSound, &position);
+		pendingSound.clear();
+	}
+}
+
+bool Spikes::canSleep()
+{
+	return true;
+}
+
+f32 Spikes::getWakeDelay()
+{
+	// Static spikes never change
+	if (timer == nullptr)
+	{
+		return -1;
+	}
+	return timer->getTime();
+}
+
+void Spikes::onWake(const f32 elapsed, const u32 ticks)
+{
+	if (timer == nullptr)
+	{
+		return;
+	}
+
+	// Mode can't have switched, since spikes are woken before. Steps are replayed, so switches happen on the same tick
+	timer->stepDecrement(deltaTime, ticks);
+
+	// Move tip towards the position of the current mode, until it stops
+	if (mode)
+	{
+		for (u32 i = 0; i < ticks && tipY < 1; ++i)
+		{
+			tipY += deltaTime * 0.0015f;
+			if (tipY > 1)
+			{
+				tipY = 1;
+			}
+		}
+	}
+	else
+	{
+		for (u32 i = 0; i < ticks && tipY > 0; ++i)
+		{
+			tipY -= deltaTime * 0.01f;
+			if (tipY < 0)
+			{
+				tipY = 0;
+			}
+		}
+	}
+}
+
+s32 Spikes::getCollisionLayer()
+{
+	return COLLISION_LAYER_SPIKES;
+}
+
 void Spikes::draw()
 {
 	// Update model
 	std::shared_ptr<Model> model = models.at(0);
-	model->position = position;
+	model->position = getDrawPosition();
 	model->scale = vector3df(1);
 
 	if (models.size() > 1)
 	{
 		model = models.at(1);
-		model->position = position + vector3df(0, 3 - TIP_HEIGHT * tipY, 0);
+		model->position = getDrawPosition() + vector3df(0, 3 - TIP_HEIGHT * tipY, 0);
 	}
 }
 
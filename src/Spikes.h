@@ -14,6 +14,9 @@ protected:
 	s8 mode;
 	f32 tipY;
 
+	// Sound to be played on commit
+	std::string pendingSound;
+
 public:
 	// Constructor
 	Spikes();
@@ -26,6 +29,18 @@ public:
 	void update();
 	void draw();
 
+	// Collision layer
+	s32 getCollisionLayer();
+
+	// Sounds triggered by "update" are deferred to "commit"
+	bool isUpdateThreadSafe();
+	void commit();
+
+	// Far spikes sleep until their next switch, catching up on their tip when woken earlier
+	bool canSleep();
+	f32 getWakeDelay();
+	void onWake(const f32 elapsed, const u32 ticks);
+
 	// Speicalized methods
 	s8 isHarmful();
 };
@@ -0,0 +1,184 @@
+#include "SpriteBatch.h"
+
+const u32 SpriteBatch::MAX_QUADS = 16384;
+
+SpriteBatch::SpriteBatch(IVideoDriver* driver, TextureAtlas* atlas)
+{
+	// Assign members
+	this->driver = driver;
+	this->atlas = atlas;
+
+	// Vertex color is multiplied by texture, alpha included, like GUI images do
+	material.Lighting = false;
+	material.BackfaceCulling = false;
+	material.ZBuffer = ECFN_ALWAYS;
+	material.ZWriteEnable = false;
+	material.MaterialType = EMT_ONETEXTURE_BLEND;
+	material.MaterialTypeParam = pack_textureBlendFunc(EBF_SRC_ALPHA, EBF_ONE_MINUS_SRC_ALPHA, EMFN_MODULATE_1X, EAS_TEXTURE | EAS_VERTEX_COLOR);
+	material.TextureLayer[0].BilinearFilter = true;
+	material.TextureLayer[0].TextureWrapU = ETC_CLAMP_TO_EDGE;
+	material.TextureLayer[0].TextureWrapV = ETC_CLAMP_TO_EDGE;
+	material.UseMipMaps = false;
+
+	// Initialize variables
+	texture = nullptr;
+	materialType = -1;
+	vertices.reserve(256);
+	indices.reserve(384);
+
+	frameDrawCalls = 0;
+	frameSprites = 0;
+	lastFrameDrawCalls = 0;
+	lastFrameSprites = 0;
+}
+
+void SpriteBatch::draw(ITexture* texture, const recti& destRect, const recti& sourceRect, const SColor& color, const recti* clipRect)
+{
+	if (texture == nullptr)
+	{
+		return;
+	}
+
+	// Map source to the atlas page, when packed
+	ITexture* page = texture;
+	rectf uv;
+	{
+		const TextureAtlas::Region* region = atlas != nullptr ? atlas->getRegion(texture) : nullptr;
+		const dimension2df size = region != nullptr ? dimension2df((f32)region->size.Width, (f32)region->size.Height) : dimension2df(texture->getOriginalSize());
+		const rectf area = region != nullptr ? region->uv : rectf(0.0f, 0.0f, 1.0f, 1.0f);
+
+		if (region != nullptr)
+		{
+			page = region->page;
+		}
+
+		uv = rectf(
+			area.UpperLeftCorner.X + (f32)sourceRect.UpperLeftCorner.X / size.Width * area.getWidth(),
+			area.UpperLeftCorner.Y + (f32)sourceRect.UpperLeftCorner.Y / size.Height * area.getHeight(),
+			area.UpperLeftCorner.X + (f32)sourceRect.LowerRightCorner.X / size.Width * area.getWidth(),
+			area.UpperLeftCorner.Y + (f32)sourceRect.LowerRightCorner.Y / size.Height * area.getHeight()
+		);
+
+		// Render targets are stored upside down by OpenGL
+		if (texture->isRenderTarget() && driver->getDriverType() == EDT_OPENGL)
+		{
+			uv.UpperLeftCorner.Y = 1.0f - uv.UpperLeftCorner.Y;
+			uv.LowerRightCorner.Y = 1.0f - uv.LowerRightCorner.Y;
+		}
+	}
+
+	const rectf dest((f32)destRect.UpperLeftCorner.X, (f32)destRect.UpperLeftCorner.Y, (f32)destRect.LowerRightCorner.X, (f32)destRect.LowerRightCorner.Y);
+	draw(page, dest, uv, color, clipRect, -1);
+}
+
+void SpriteBatch::draw(ITexture* texture, const rectf& destRect, const rectf& uv, const SColor& color, const recti* clipRect, const s32 materialType)
+{
+	if (texture == nullptr || destRect.getWidth() <= 0.0f || destRect.getHeight() <= 0.0f)
+	{
+		return;
+	}
+
+	// Clip destination, shrinking texture coordinates by the same proportion
+	rectf dest = destRect;
+	rectf coords = uv;
+
+	if (clipRect != nullptr)
+	{
+		dest.clipAgainst(rectf((f32)clipRect->UpperLeftCorner.X, (f32)clipRect->UpperLeftCorner.Y, (f32)clipRect->LowerRightCorner.X, (f32)clipRect->LowerRightCorner.Y));
+
+		if (dest.getWidth() <= 0.0f || dest.getHeight() <= 0.0f)
+		{
+			return;
+		}
+
+		const vector2df scale((uv.LowerRightCorner.X - uv.UpperLeftCorner.X) / destRect.getWidth(), (uv.LowerRightCorner.Y - uv.UpperLeftCorner.Y) / destRect.getHeight());
+		coords = rectf(
+			uv.UpperLeftCorner.X + (dest.UpperLeftCorner.X - destRect.UpperLeftCorner.X) * scale.X,
+			uv.UpperLeftCorner.Y + (dest.UpperLeftCorner.Y - destRect.UpperLeftCorner.Y) * scale.Y,
+			uv.LowerRightCorner.X - (destRect.LowerRightCorner.X - dest.LowerRightCorner.X) * scale.X,
+			uv.LowerRightCorner.Y - (destRect.LowerRightCorner.Y - dest.LowerRightCorner.Y) * scale.Y
+		);
+	}
+
+	// A texture or material change breaks the batch
+	if (texture != this->texture || materialType != this->materialType || vertices.size() >= MAX_QUADS * 4)
+	{
+		flush();
+		this->texture = texture;
+		this->materialType = materialType;
+	}
+
+	// Append quad
+	const u16 first = (u16)vertices.size();
+	const vector3df normal(0.0f, 0.0f, -1.0f);
+
+	vertices.push_back(S3DVertex(vector3df(dest.UpperLeftCorner.X, dest.UpperLeftCorner.Y, 0.0f), normal, color, vector2df(coords.UpperLeftCorner.X, coords.UpperLeftCorner.Y)));
+	vertices.push_back(S3DVertex(vector3df(dest.LowerRightCorner.X, dest.UpperLeftCorner.Y, 0.0f), normal, color, vector2df(coords.LowerRightCorner.X, coords.UpperLeftCorner.Y)));
+	vertices.push_back(S3DVertex(vector3df(dest.UpperLeftCorner.X, dest.LowerRightCorner.Y, 0.0f), normal, color, vector2df(coords.UpperLeftCorner.X, coords.LowerRightCorner.Y)));
+	vertices.push_back(S3DVertex(vector3df(dest.LowerRightCorner.X, dest.LowerRightCorner.Y, 0.0f), normal, color, vector2df(coords.LowerRightCorner.X, coords.LowerRightCorner.Y)));
+
+	const u16 quad[] = { 0, 1, 2, 3, 2, 1 };
+	for (const u16 index : quad)
+	{
+		indices.push_back(first + index);
+	}
+
+	++frameSprites;
+}
+
+void SpriteBatch::flush()
+{
+	if (indices.empty())
+	{
+		return;
+	}
+
+	// Convert pixels into clip space of the current render target
+	const dimension2df size(driver->getCurrentRenderTargetSize());
+	for (S3DVertex& vertex : vertices)
+	{
+		vertex.Pos.X = vertex.Pos.X / size.Width * 2.0f - 1.0f;
+		vertex.Pos.Y = 1.0f - vertex.Pos.Y / size.Height * 2.0f;
+	}
+
+	// Draw all of the quads at once, with the default blended material or with the requested one
+	SMaterial batchMaterial = material;
+	if (materialType != -1)
+	{
+		batchMaterial.MaterialType = (E_MATERIAL_TYPE)materialType;
+		batchMaterial.MaterialTypeParam = 0.0f;
+	}
+	batchMaterial.setTexture(0, texture);
+	driver->setMaterial(batchMaterial);
+
+	driver->setTransform(ETS_PROJECTION, IdentityMatrix);
+	driver->setTransform(ETS_VIEW, IdentityMatrix);
+	driver->setTransform(ETS_WORLD, IdentityMatrix);
+
+	driver->drawIndexedTriangleList(vertices.data(), vertices.size(), indices.data(), indices.size() / 3);
+	++frameDrawCalls;
+
+	// Keep buffers allocated for the next batch
+	vertices.clear();
+	indices.clear();
+	texture = nullptr;
+	materialType = -1;
+}
+
+void SpriteBatch::endFrame()
+{
+	lastFrameDrawCalls = frameDrawCalls;
+	lastFrameSprites = frameSprites;
+	frameDrawCalls = 0;
+	frameSprites = 0;
+}
+
+u32 SpriteBatch::getFrameDrawCalls()
+{
+	return lastFrameDrawCalls;
+}
+
+u32 SpriteBatch::getFrameSprites()
+{
+	return lastFrameSprites;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <vector>
+#include <irrlicht.h>
+
+#include "TextureAtlas.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+class SpriteBatch
+{
+protected:
+
+	// Maximum amount of quads held by a single draw, limited by 16 bit indices
+	static const u32 MAX_QUADS;
+
+	// Video driver which draws the quads
+	IVideoDriver* driver;
+
+	// Atlas where textures are looked up, so quads of different textures share the same page
+	TextureAtlas* atlas;
+
+	// Material used for all of the quads
+	SMaterial material;
+
+	// Texture and material type of the quads accumulated since the last flush
+	ITexture* texture;
+	s32 materialType;
+
+	// Dynamic buffers, whose positions are in pixels until they are flushed
+	std::vector<S3DVertex> vertices;
+	std::vector<u16> indices;
+
+	// Counters
+	u32 frameDrawCalls;
+	u32 frameSprites;
+	u32 lastFrameDrawCalls;
+	u32 lastFrameSprites;
+
+public:
+
+	// Constructor
+	SpriteBatch(IVideoDriver* driver, TextureAtlas* atlas);
+
+	/**
+		Queue a textured quad. Consecutive quads are drawn at once, as long as they share the same texture,
+		which happens for all of the textures packed into the same atlas page.
+
+		@param texture the original texture, which is replaced by its atlas page when packed.
+		@param destRect the destination rectangle, in pixels of the current render target.
+		@param sourceRect the source rectangle, in pixels of the original texture.
+		@param color the color multiplied by the texture, alpha included.
+		@param clipRect optional rectangle where the quad is clipped to.
+	*/
+	void draw(ITexture* texture, const recti& destRect, const recti& sourceRect, const SColor& color, const recti* clipRect = nullptr);
+
+	/**
+		Queue a quad whose texture coordinates are already known, such as a glyph of a font atlas.
+
+		@param texture the texture to be sampled.
+		@param destRect the destination rectangle, in pixels of the current render target.
+		@param uv the texture coordinates of the rectangle.
+		@param color the color multiplied by the texture, alpha included.
+		@param clipRect optional rectangle where the quad is clipped to.
+		@param materialType the material to draw the quad with. The default blended one is used when it's -1.
+	*/
+	void draw(ITexture* texture, const rectf& destRect, const rectf& uv, const SColor& color, const recti* clipRect = nullptr, const s32 materialType = -1);
+
+	// Draw all of the queued quads on the current render target
+	void flush();
+
+	// Close counters for the current frame
+	void endFrame();
+
+	// Draw calls issued during the last completed frame
+	u32 getFrameDrawCalls();
+
+	// Quads drawn during the last completed frame
+	u32 getFrameSprites();
+};
+
+#endif // SPRITEBATCH_H
\ No newline at end of file
@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cmath>
+
+#include "StaticBatch.h"
+#include "Camera.h"
+
+const f32 StaticBatch::CHUNK_SIZE = 160.0f;
+
+StaticBatch::StaticBatch()
+{
+	// Initialize variables
+	pending = false;
+	modelCount = 0;
+	bufferCount = 0;
+}
+
+StaticBatch::~StaticBatch()
+{
+	clear();
+}
+
+void StaticBatch::invalidate()
+{
+	clear();
+	pending = true;
+}
+
+void StaticBatch::clear()
+{
+	for (auto& entry : chunks)
+	{
+		releaseChunk(entry.second);
+
+		// Models still alive are drawn by their own scene node again
+		for (Member& member : entry.second.members)
+		{
+			std::shared_ptr<Model> model = member.model.lock();
+			if (model != nullptr)
+			{
+				model->setBatched(false);
+			}
+		}
+	}
+	chunks.clear();
+
+	pending = false;
+	modelCount = 0;
+	bufferCount = 0;
+}
+
+void StaticBatch::update(const std::vector<std::shared_ptr<GameObject>>& gameObjects, const bool debugDataVisible)
+{
+	// Collect static models of the loaded room
+	if (pending)
+	{
+		collect(gameObjects);
+	}
+
+	// Rebuild chunks whose models have changed or have been released
+	for (auto iterator = chunks.begin(); iterator != chunks.end();)
+	{
+		Chunk& chunk = iterator->second;
+
+		// Models left on their own scene node keep their changes for the engine
+		for (Member& member : chunk.members)
+		{
+			std::shared_ptr<Model> model = member.model.lock();
+			if (model == nullptr || (model->isBatched() && model->consumeBatchChanges()))
+			{
+				chunk.dirty = true;
+			}
+		}
+
+		if (chunk.dirty)
+		{
+			releaseChunk(chunk);
+			buildChunk(chunk);
+		}
+
+		// Drop chunks left without models
+		if (chunk.members.size() == 0)
+		{
+			iterator = chunks.erase(iterator);
+			continue;
+		}
+
+		// Debug informations
+		for (IMeshSceneNode* node : chunk.nodes)
+		{
+			node->setDebugDataVisible(debugDataVisible ? EDS_BBOX : EDS_OFF);
+		}
+
+		++iterator;
+	}
+}
+
+void StaticBatch::submit(RenderQueue* renderQueue)
+{
+	for (auto& entry : chunks)
+	{
+		for (IMeshSceneNode* node : entry.second.nodes)
+		{
+			// Geometry is already in world space
+			if (Camera::singleton->isVisible(node->getMesh()->getBoundingBox()))
+			{
+				renderQueue->add(node);
+			}
+		}
+	}
+}
+
+void StaticBatch::collect(const std::vector<std::shared_ptr<GameObject>>& gameObjects)
+{
+	for (const std::shared_ptr<GameObject>& go : gameObjects)
+	{
+		for (u32 i = 0; i < go->models.size(); ++i)
+		{
+			const std::shared_ptr<Model>& model = go->models.at(i);
+			if (!model->isStatic || model->mesh == nullptr)
+			{
+				continue;
+			}
+
+			// Find chunk from the model position
+			const std::tuple<s32, s32, s32> cell(
+				(s32)std::floor(model->position.X / CHUNK_SIZE),
+				(s32)std::floor(model->position.Y / CHUNK_SIZE),
+				(s32)std::floor(model->position.Z / CHUNK_SIZE)
+			);
+
+			// Chunk material is read from the first model by shared shader callbacks
+			model->shaderInstance = go->shaderInstance;
+
+			Chunk& chunk = chunks[cell];
+			chunk.members.push_back({ model, std::type_index(typeid(*go)), i });
+			chunk.dirty = true;
+		}
+	}
+
+	pending = false;
+
+	// Build everything now, so counters are ready for the report
+	for (auto& entry : chunks)
+	{
+		buildChunk(entry.second);
+	}
+
+	#if NDEBUG || _DEBUG
+	printf("StaticBatch - Merged %u models into %u mesh buffers over %u chunks\n", modelCount, bufferCount, (u32)chunks.size());
+	#endif
+}
+
+void StaticBatch::buildChunk(Chunk& chunk)
+{
+	// Geometry with the same owner class, model slot and textures shares the same material
+	typedef std::tuple<std::type_index, u32, std::vector<std::pair<u32, ITexture*>>> GroupKey;
+	std::map<GroupKey, Group> groups;
+
+	// Drop released models
+	const auto& iterator = std::remove_if(chunk.members.begin(), chunk.members.end(), [](const Member& member)
+	{
+		return member.model.expired();
+	});
+	chunk.members.erase(iterator, chunk.members.end());
+
+	// Models are counted again while they are merged
+	modelCount -= chunk.batchedCount;
+	chunk.batchedCount = 0;
+
+	for (Member& member : chunk.members)
+	{
+		std::shared_ptr<Model> model = member.model.lock();
+
+		// Keep the model on its own scene node when any of its mesh buffers can't be merged
+		IMesh* mesh = model->mesh->getMesh((s32)model->currentFrame);
+		if (!canBatch(mesh))
+		{
+			if (model->isBatched())
+			{
+				model->setBatched(false);
+			}
+			continue;
+		}
+
+		// Find group for this material
+		std::vector<std::pair<u32, ITexture*>> textures(model->textures.begin(), model->textures.end());
+		std::sort(textures.begin(), textures.end());
+
+		Group& group = groups[GroupKey(member.owner, member.index, textures)];
+		if (group.mesh == nullptr)
+		{
+			group.model = model;
+			group.mesh = new SMesh();
+		}
+
+		// Geometry is baked in world space
+		const matrix4 transform = model->getTransformation();
+
+		// Append all the mesh buffers for the current frame
+		for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* source = mesh->getMeshBuffer(i);
+
+			switch (source->getVertexType())
+			{
+			case EVT_STANDARD:
+				appendMeshBuffer(group.mesh, group.standard, source, transform);
+				break;
+
+			case EVT_2TCOORDS:
+				appendMeshBuffer(group.mesh, group.coords, source, transform);
+				break;
+
+			case EVT_TANGENTS:
+				appendMeshBuffer(group.mesh, group.tangents, source, transform);
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		// Geometry is now drawn by the chunk
+		if (!model->isBatched())
+		{
+			model->setBatched(true);
+		}
+		++chunk.batchedCount;
+	}
+	modelCount += chunk.batchedCount;
+
+	// Create one scene node for every material
+	for (auto& entry : groups)
+	{
+		Group& group = entry.second;
+		const std::shared_ptr<Model>& model = group.model;
+
+		// Apply the same material the model would have on its own scene node
+		for (u32 i = 0; i < group.mesh->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* buffer = group.mesh->getMeshBuffer(i);
+			SMaterial& material = buffer->getMaterial();
+
+			for (auto& texture : model->textures)
+			{
+				material.setTexture(texture.first, texture.second);
+			}
+			material.setFlag(EMF_LIGHTING, false);
+			material.setFlag(EMF_NORMALIZE_NORMALS, true);
+
+			if (model->material != -1)
+			{
+				material.MaterialType = (E_MATERIAL_TYPE)model->material;
+				material.MaterialTypeParam2 = (f32)model->shaderInstance;
+				material.setFlag(EMF_BLEND_OPERATION, true);
+			}
+
+			buffer->recalculateBoundingBox();
+		}
+		group.mesh->recalculateBoundingBox();
+
+		// Node is grabbed, so it survives until the chunk is released, while it's drawn by the render queue
+		IMeshSceneNode* node = smgr->addMeshSceneNode(group.mesh);
+		if (node != nullptr)
+		{
+			node->grab();
+			node->setVisible(false);
+			chunk.nodes.push_back(node);
+		}
+		group.mesh->drop();
+	}
+
+	chunk.dirty = false;
+}
+
+void StaticBatch::releaseChunk(Chunk& chunk)
+{
+	for (IMeshSceneNode* node : chunk.nodes)
+	{
+		// Update counters
+		bufferCount -= node->getMesh()->getMeshBufferCount();
+
+		node->remove();
+		node->drop();
+	}
+	chunk.nodes.clear();
+}
+
+bool StaticBatch::canBatch(IMesh* mesh)
+{
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* buffer = mesh->getMeshBuffer(i);
+		if (buffer->getIndexType() != EIT_16BIT)
+		{
+			return false;
+		}
+
+		const E_VERTEX_TYPE type = buffer->getVertexType();
+		if (type != EVT_STANDARD && type != EVT_2TCOORDS && type != EVT_TANGENTS)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void StaticBatch::transformVertex(S3DVertex& vertex, const matrix4& transform)
+{
+	transform.transformVect(vertex.Pos);
+	transform.rotateVect(vertex.Normal);
+	vertex.Normal.normalize();
+}
+
+void StaticBatch::transformVertex(S3DVertexTangents& vertex, const matrix4& transform)
+{
+	transform.transformVect(vertex.Pos);
+	transform.rotateVect(vertex.Normal);
+	transform.rotateVect(vertex.Tangent);
+	transform.rotateVect(vertex.Binormal);
+	vertex.Normal.normalize();
+	vertex.Tangent.normalize();
+	vertex.Binormal.normalize();
+}
+
+u32 StaticBatch::getModelCount()
+{
+	return modelCount;
+}
+
+u32 StaticBatch::getBufferCount()
+{
+	return bufferCount;
+}
+
+u32 StaticBatch::getChunkCount()
+{
+	return (u32)chunks.size();
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+#include "EngineObject.h"
+#include "GameObject.h"
+#include "RenderQueue.h"
+
+class StaticBatch : public EngineObject
+{
+protected:
+
+	// Edge length of the cubic cells which static geometry is split into, so every chunk can be culled on its own
+	static const f32 CHUNK_SIZE;
+
+	// Structure for a static model merged into a chunk
+	struct Member
+	{
+		std::weak_ptr<Model> model;
+		std::type_index owner;
+		u32 index;
+	};
+
+	// Structure for a single chunk, holding one scene node for every material
+	struct Chunk
+	{
+		std::vector<Member> members;
+		std::vector<IMeshSceneNode*> nodes;
+		bool dirty;
+		u32 batchedCount = 0;
+	};
+
+	// Structure for geometry sharing the same material, while a chunk is being built
+	struct Group
+	{
+		std::shared_ptr<Model> model;
+		SMesh* mesh = nullptr;
+		CMeshBuffer<S3DVertex>* standard = nullptr;
+		CMeshBuffer<S3DVertex2TCoords>* coords = nullptr;
+		CMeshBuffer<S3DVertexTangents>* tangents = nullptr;
+	};
+
+	// Map to hold chunks, by their cell coordinates
+	std::map<std::tuple<s32, s32, s32>, Chunk> chunks;
+
+	// Batch must be collected from the room on the next update
+	bool pending;
+
+	// Counters
+	u32 modelCount;
+	u32 bufferCount;
+
+	// Collect all the static models of the room into chunks
+	void collect(const std::vector<std::shared_ptr<GameObject>>& gameObjects);
+
+	// Merge geometry of the chunk members into one scene node for every material
+	void buildChunk(Chunk& chunk);
+
+	// Remove the scene nodes of the chunk
+	void releaseChunk(Chunk& chunk);
+
+	// Check if every mesh buffer can be merged, since a model can't be drawn partly by a chunk
+	static bool canBatch(IMesh* mesh);
+
+	// Transform vertex into world space
+	static void transformVertex(S3DVertex& vertex, const matrix4& transform);
+	static void transformVertex(S3DVertexTangents& vertex, const matrix4& transform);
+
+	/**
+		Append a mesh buffer transformed into world space to the target buffer. A new target buffer
+		is added to the mesh when there is none yet, or when 16-bit indices would overflow.
+
+		@param mesh the mesh where to add new target buffers.
+		@param target the buffer to append geometry to. It is replaced when a new buffer is added.
+		@param source the mesh buffer to be copied.
+		@param transform the world transformation of the model.
+	*/
+	template <typename T>
+	void appendMeshBuffer(SMesh* mesh, CMeshBuffer<T>*& target, IMeshBuffer* source, const matrix4& transform)
+	{
+		// Start a new buffer when needed
+		const u32 vertexCount = source->getVertexCount();
+		if (target == nullptr || target->Vertices.size() + vertexCount > 65535)
+		{
+			target = new CMeshBuffer<T>();
+			target->Material = source->getMaterial();
+			target->setHardwareMappingHint(EHM_STATIC);
+			mesh->addMeshBuffer(target);
+			target->drop();
+			++bufferCount;
+		}
+
+		// Copy vertices in world space
+		const u32 base = target->Vertices.size();
+		const T* vertices = (const T*)source->getVertices();
+
+		for (u32 i = 0; i < vertexCount; ++i)
+		{
+			T vertex = vertices[i];
+			transformVertex(vertex, transform);
+			target->Vertices.push_back(vertex);
+		}
+
+		// Copy indices, shifted to the appended vertices
+		const u16* indices = source->getIndices();
+
+		for (u32 i = 0; i < source->getIndexCount(); ++i)
+		{
+			target->Indices.push_back((u16)(base + indices[i]));
+		}
+	}
+
+public:
+
+	// Constructor and deconstructor
+	StaticBatch();
+	~StaticBatch();
+
+	// Release the current batch and collect static models from the room on the next update
+	void invalidate();
+
+	// Release all of the chunks, giving their models back to the engine
+	void clear();
+
+	/**
+		Build the batch if it has been invalidated, then rebuild the chunks whose models have changed
+		or have been destroyed. Must be called after "draw", so models have their final transform.
+
+		@param gameObjects the game objects of the current room.
+		@param debugDataVisible true to show bounding boxes of chunk nodes.
+	*/
+	void update(const std::vector<std::shared_ptr<GameObject>>& gameObjects, const bool debugDataVisible);
+
+	/**
+		Queue the chunk nodes which can be seen by the camera.
+
+		@param renderQueue the queue where to add the visible chunk nodes.
+	*/
+	void submit(RenderQueue* renderQueue);
+
+	// Amount of models merged into the batch
+	u32 getModelCount();
+
+	// Amount of mesh buffers drawn for the whole batch
+	u32 getBufferCount();
+
+	// Amount of chunks
+	u32 getChunkCount();
+};
+
+#endif // STATICBATCH_H
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Sweep.h"
+#include "GameObject.h"
+
+const f32 Sweep::EPSILON = 0.001f;
+
+Collision Sweep::getCollision(const Obstacle& obstacle, const aabbox3df& box, const f32 time, const vector3df& normal)
+{
+	Collision collision;
+	collision.engineObject = obstacle.gameObject;
+	collision.mainBoundingBox = box;
+	collision.otherBoundingBox = obstacle.box;
+	collision.time = time;
+	collision.normal = normal;
+	return collision;
+}
+
+void Sweep::addObstacle(const std::shared_ptr<GameObject>& gameObject, const aabbox3df& box, const std::function<bool(GameObject* go)>& check)
+{
+	if (gameObject->destroy || gameObject->models.size() == 0)
+	{
+		return;
+	}
+	else if (check != nullptr && !check(gameObject.get()))
+	{
+		return;
+	}
+
+	Obstacle obstacle;
+	obstacle.gameObject = gameObject;
+	obstacle.box = box;
+	obstacles.push_back(obstacle);
+}
+
+void Sweep::collect(SpatialHash* layer, TileMap* tileMap, const aabbox3df& box, const vector3df& motion, const f32 margin, const std::function<bool(GameObject* go)>& check)
+{
+	obstacles.clear();
+	candidates.clear();
+	spans.clear();
+
+	// Query the area covered by the whole motion
+	aabbox3df area(box);
+	area.addInternalBox(aabbox3df(box.MinEdge + motion, box.MaxEdge + motion));
+	area.MinEdge -= vector3df(margin);
+	area.MaxEdge += vector3df(margin);
+
+	// Keep the spans which can be hit, checking the first game object of merged ones
+	if (tileMap != nullptr)
+	{
+		tileMap->querySpans(area, spans);
+
+		for (const TileMap::Span* span : spans)
+		{
+			addObstacle(span->gameObject, span->box, check);
+		}
+	}
+
+	// Keep the candidates which can be hit, with their registered world bounding box
+	layer->query(area, candidates);
+
+	for (const SpatialHash::Entry* entry : candidates)
+	{
+		addObstacle(entry->gameObject, entry->box, check);
+	}
+}
+
+Collision Sweep::cast(const aabbox3df& box, const vector3df& motion)
+{
+	const f32 infinity = std::numeric_limits<f32>::infinity();
+
+	Collision collision;
+	const Obstacle* nearest = nullptr;
+
+	// Nothing can be hit without moving
+	if (motion.X == 0.0f && motion.Y == 0.0f)
+	{
+		return collision;
+	}
+
+	for (const Obstacle& obstacle : obstacles)
+	{
+		const aabbox3df& other = obstacle.box;
+
+		// Depth is not swept, so boxes must already overlap on it
+		if (box.MaxEdge.Z < other.MinEdge.Z || box.MinEdge.Z > other.MaxEdge.Z)
+		{
+			continue;
+		}
+
+		// Compute entry and exit times on both axes, with the slab method
+		f32 entryTimes[2], exitTimes[2];
+		bool blocked = true;
+
+		for (u32 axis = 0; axis < 2; ++axis)
+		{
+			const f32 delta = axis ? motion.Y : motion.X;
+			const f32 boxMin = axis ? box.MinEdge.Y : box.MinEdge.X;
+			const f32 boxMax = axis ? box.MaxEdge.Y : box.MaxEdge.X;
+			const f32 otherMin = axis ? other.MinEdge.Y : other.MinEdge.X;
+			const f32 otherMax = axis ? other.MaxEdge.Y : other.MaxEdge.X;
+
+			if (delta > 0.0f)
+			{
+				entryTimes[axis] = (otherMin - boxMax) / delta;
+				exitTimes[axis] = (otherMax - boxMin) / delta;
+			}
+			else if (delta < 0.0f)
+			{
+				entryTimes[axis] = (otherMax - boxMin) / delta;
+				exitTimes[axis] = (otherMin - boxMax) / delta;
+			}
+			// Boxes which are only touching on a still axis slide along each other
+			else if (boxMax - EPSILON > otherMin && boxMin + EPSILON < otherMax)
+			{
+				entryTimes[axis] = -infinity;
+				exitTimes[axis] = infinity;
+			}
+			else
+			{
+				blocked = false;
+			}
+		}
+
+		if (!blocked)
+		{
+			continue;
+		}
+
+		// The last axis to start overlapping is the hit one
+		const u32 axis = entryTimes[1] > entryTimes[0] ? 1 : 0;
+		const f32 delta = axis ? motion.Y : motion.X;
+
+		if (entryTimes[axis] >= std::min(exitTimes[0], exitTimes[1]))
+		{
+			continue;
+		}
+
+		// Ignore obstacles the box was already deep into, allowing a tolerance for flush contacts
+		if (entryTimes[axis] * std::abs(delta) < -EPSILON)
+		{
+			continue;
+		}
+
+		// Keep the earliest obstacle, or the first one of the room on equal times
+		const f32 time = std::max(entryTimes[axis], 0.0f);
+		if (time > collision.time || (nearest != nullptr && time == collision.time))
+		{
+			continue;
+		}
+
+		nearest = &obstacle;
+		collision.time = time;
+		collision.normal = axis ? vector3df(0.0f, delta > 0.0f ? -1.0f : 1.0f, 0.0f) : vector3df(delta > 0.0f ? -1.0f : 1.0f, 0.0f, 0.0f);
+	}
+
+	return nearest != nullptr ? getCollision(*nearest, box, collision.time, collision.normal) : collision;
+}
+
+Collision Sweep::findSupport(const aabbox3df& box, const f32 distance)
+{
+	const Obstacle* support = nullptr;
+
+	for (const Obstacle& obstacle : obstacles)
+	{
+		const aabbox3df& other = obstacle.box;
+
+		// Obstacle must be below the box, and overlap it on the other axes
+		const f32 gap = box.MinEdge.Y - other.MaxEdge.Y;
+		if (gap < -EPSILON || gap > distance)
+		{
+			continue;
+		}
+		else if (box.MaxEdge.X - EPSILON <= other.MinEdge.X || box.MinEdge.X + EPSILON >= other.MaxEdge.X)
+		{
+			continue;
+		}
+		else if (box.MaxEdge.Z < other.MinEdge.Z || box.MinEdge.Z > other.MaxEdge.Z)
+		{
+			continue;
+		}
+
+		if (support == nullptr || other.MaxEdge.Y > support->box.MaxEdge.Y)
+		{
+			support = &obstacle;
+		}
+	}
+
+	return support != nullptr ? getCollision(*support, box, 0.0f, vector3df(0.0f, 1.0f, 0.0f)) : Collision();
+}
\ No newline at end of file
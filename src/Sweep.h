@@ -0,0 +1,85 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <irrlicht.h>
+
+#include "Collision.h"
+#include "SpatialHash.h"
+#include "TileMap.h"
+
+using namespace irr;
+using namespace core;
+
+class GameObject;
+
+class Sweep
+{
+protected:
+
+	// Structure for a box which can be hit by the sweep
+	struct Obstacle
+	{
+		std::shared_ptr<GameObject> gameObject;
+		aabbox3df box;
+	};
+
+	// Overlap below this distance is treated as touching, so boxes can slide along flush surfaces
+	static const f32 EPSILON;
+
+	// Obstacles collected by the last broadphase query, in the same order of the room
+	std::vector<Obstacle> obstacles;
+
+	// Candidates found by the last broadphase and tilemap queries, before being checked as obstacles
+	std::vector<const SpatialHash::Entry*> candidates;
+	std::vector<const TileMap::Span*> spans;
+
+	// Keep a candidate which can be hit
+	void addObstacle(const std::shared_ptr<GameObject>& gameObject, const aabbox3df& box, const std::function<bool(GameObject* go)>& check);
+
+	// Build collision information for an obstacle
+	static Collision getCollision(const Obstacle& obstacle, const aabbox3df& box, const f32 time, const vector3df& normal);
+
+public:
+
+	/**
+		Collect the obstacles around the whole motion of a box, with a single broadphase query and a
+		lookup of the tiles covered by the motion. Sweeps and support checks of the same tick are then
+		performed on them.
+
+		@param layer the broadphase of the collision layer to be swept against.
+		@param tileMap optional tilemap to be swept against, whose spans come before the layer obstacles.
+		@param box the world box at the beginning of the motion.
+		@param motion the motion of the box.
+		@param margin the distance the query is enlarged by, on every side.
+		@param check optional check for candidates, such as solidity.
+	*/
+	void collect(SpatialHash* layer, TileMap* tileMap, const aabbox3df& box, const vector3df& motion, const f32 margin, const std::function<bool(GameObject* go)>& check = nullptr);
+
+	/**
+		Sweep a box along a motion on the XY plane, against the collected obstacles. Obstacles already
+		overlapping the box are ignored, so it can always move out of them.
+
+		@param box the world box at the beginning of the motion.
+		@param motion the motion of the box. Depth is ignored, since rooms are laid on the XY plane.
+
+		@return the collision with the earliest obstacle, whose "time" is the fraction of the motion before
+		the impact and whose "normal" points away from the hit face. The engine object is "nullptr" if
+		the whole motion is free, in which case "time" is 1.
+	*/
+	Collision cast(const aabbox3df& box, const vector3df& motion);
+
+	/**
+		Find the collected obstacle the box is resting on.
+
+		@param box the world box.
+		@param distance the maximum gap between the bottom of the box and the top of the obstacle.
+
+		@return the collision with the highest supporting obstacle, or an empty one if there is none.
+	*/
+	Collision findSupport(const aabbox3df& box, const f32 distance);
+};
+
+#endif // SWEEP_H
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Teleporter.h"
+#include "MaterialCache.h"
 
 using nlohmann::json;
 
@@ -63,13 +64,8 @@ std::shared_ptr<Teleporter> Teleporter::createInstance(const nlohmann::json &jso
 
 Teleporter::Teleporter(const vector3df & warp, const SColorf & color) : GameObject()
 {
-	// Create custom material from shader
-	SpecializedShaderCallback* ssc = new SpecializedShaderCallback(this);
-
-	IGPUProgrammingServices* gpu = driver->getGPUProgrammingServices();
-	customMaterial = gpu->addHighLevelShaderMaterialFromFiles("shaders/standard.vs", "shaders/teleporter.fs", ssc);
-
-	ssc->drop();
+	// Get custom material from shader
+	customMaterial = MaterialCache::singleton->getMaterial<SpecializedShaderCallback>("shaders/standard.vs", "shaders/teleporter.fs");
 
 	// Load mesh and texture
 	IAnimatedMesh* mesh = smgr->getMesh("models/teleporter.obj");
@@ -93,16 +89,42 @@ void Teleporter::update()
 	angle += 0.1570f * deltaTime;
 }
 
+bool Teleporter::isUpdateThreadSafe()
+{
+	return true;
+}
+
+bool Teleporter::canSleep()
+{
+	return true;
+}
+
+void Teleporter::onWake(const f32 elapsed, const u32 ticks)
+{
+	angle += 0.1570f * elapsed;
+}
+
+s32 Teleporter::getCollisionLayer()
+{
+	return COLLISION_LAYER_TELEPORTER;
+}
+
 void Teleporter::draw()
 {
 	std::shared_ptr<Model> &model = models.at(0);
-	model->position = position;
+	model->position = getDrawPosition();
 	model->rotation = vector3df(0, angle, 0);
 }
 
-Teleporter::SpecializedShaderCallback::SpecializedShaderCallback(Teleporter* teleporter)
+Teleporter::SpecializedShaderCallback::SpecializedShaderCallback()
 {
-	this->teleporter = teleporter;
+	colorId = -1;
+}
+
+void Teleporter::SpecializedShaderCallback::resolveConstants(IMaterialRendererServices* services)
+{
+	ShaderCallback::resolveConstants(services);
+	colorId = services->getPixelShaderConstantID("color");
 }
 
 void Teleporter::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServices* services, s32 userData)
@@ -110,10 +132,13 @@ void Teleporter::SpecializedShaderCallback::OnSetConstants(IMaterialRendererServ
 	// Execute parent method
 	ShaderCallback::OnSetConstants(services, userData);
 
-	// Set texture layer
-	s32 layer0 = 0;
-	services->setPixelShaderConstant("tex", (s32*)&layer0, 1);
+	// Get teleporter being drawn
+	Teleporter* teleporter = static_cast<Teleporter*>(instance);
+	if (teleporter == nullptr)
+	{
+		return;
+	}
 
 	// Set color
-	services->setPixelShaderConstant("color", &teleporter->color.r, 3);
+	services->setPixelShaderConstant(colorId, &teleporter->color.r, 3);
 }
\ No newline at end of file
@@ -16,17 +16,6 @@ protected:
 	f32 angle;
 	SColorf color;
 
-	// ShaderCallBack
-	class SpecializedShaderCallback : public ShaderCallback
-	{
-	protected:
-		Teleporter* teleporter;
-
-	public:
-		SpecializedShaderCallback(Teleporter* teleporter);
-		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
-	};
-
 public:
 
 	// Constructor
@@ -39,8 +28,31 @@ public:
 	void update();
 	void draw();
 
+	// Collision layer
+	s32 getCollisionLayer();
+
+	// Teleporter only animates itself
+	bool isUpdateThreadSafe();
+
+	// Far teleporters sleep, catching up on their spin when woken
+	bool canSleep();
+	void onWake(const f32 elapsed, const u32 ticks);
+
 	// Create specialized instance
 	static std::shared_ptr<Teleporter> createInstance(const nlohmann::json &jsonData);
+
+	// ShaderCallBack
+	class SpecializedShaderCallback : public InstanceShaderCallback
+	{
+	protected:
+		s32 colorId;
+
+		virtual void resolveConstants(IMaterialRendererServices* services);
+
+	public:
+		SpecializedShaderCallback();
+		virtual void OnSetConstants(IMaterialRendererServices* services, s32 userData);
+	};
 };
 
 #endif // TELEPORTER_H
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include <algorithm>
+
+#include "TextureAtlas.h"
+
+TextureAtlas::TextureAtlas(IVideoDriver* driver, const std::string& name, const u32 pageSize, const u32 padding)
+{
+	// Assign members
+	this->driver = driver;
+	this->name = name;
+	this->pageSize = pageSize;
+	this->padding = padding;
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	for (ITexture* page : pages)
+	{
+		driver->removeTexture(page);
+	}
+}
+
+void TextureAtlas::add(ITexture* texture, const std::string& path)
+{
+	if (texture == nullptr)
+	{
+		return;
+	}
+
+	Source source;
+	source.texture = texture;
+	source.path = path;
+	sources.push_back(source);
+}
+
+void TextureAtlas::blit(IImage* image, IImage* page, const vector2di& position)
+{
+	// Copy pixels
+	image->copyTo(page, position);
+
+	// Replicate border pixels into the padding
+	const dimension2du size = image->getDimension();
+	const s32 p = (s32)padding;
+
+	for (s32 y = -p; y < (s32)size.Height + p; ++y)
+	{
+		for (s32 x = -p; x < (s32)size.Width + p; ++x)
+		{
+			if (x >= 0 && y >= 0 && x < (s32)size.Width && y < (s32)size.Height)
+			{
+				continue;
+			}
+
+			const u32 sx = (u32)core::clamp(x, 0, (s32)size.Width - 1);
+			const u32 sy = (u32)core::clamp(y, 0, (s32)size.Height - 1);
+			page->setPixel(position.X + x, position.Y + y, image->getPixel(sx, sy));
+		}
+	}
+}
+
+void TextureAtlas::build()
+{
+	// Load images
+	std::vector<IImage*> images;
+	for (const Source& source : sources)
+	{
+		images.push_back(driver->createImageFromFile(source.path.c_str()));
+	}
+
+	// Pack tallest images first, so shelves waste less space
+	std::vector<u32> order;
+	for (u32 i = 0; i < images.size(); ++i)
+	{
+		if (images[i] != nullptr)
+		{
+			order.push_back(i);
+		}
+	}
+	std::stable_sort(order.begin(), order.end(), [&images](const u32 a, const u32 b)
+	{
+		return images[a]->getDimension().Height > images[b]->getDimension().Height;
+	});
+
+	// Shelf packing, which keeps the page index of every packed image
+	std::vector<IImage*> pageImages;
+	std::vector<s32> imagePages(images.size(), -1);
+	s32 x = 0;
+	s32 y = 0;
+	s32 shelfHeight = 0;
+
+	for (const u32 i : order)
+	{
+		IImage* image = images[i];
+		const dimension2du size = image->getDimension();
+		const s32 w = (s32)(size.Width + padding * 2);
+		const s32 h = (s32)(size.Height + padding * 2);
+
+		// Image can't fit even into an empty page
+		if (w > (s32)pageSize || h > (s32)pageSize)
+		{
+			#if NDEBUG || _DEBUG
+			printf("TextureAtlas - %s is too big for %s\n", sources[i].path.c_str(), name.c_str());
+			#endif
+			continue;
+		}
+
+		// Move to next shelf
+		if (x + w > (s32)pageSize)
+		{
+			x = 0;
+			y += shelfHeight;
+			shelfHeight = 0;
+		}
+
+		// Move to next page
+		if (pageImages.empty() || y + h > (s32)pageSize)
+		{
+			IImage* page = driver->createImage(ECF_A8R8G8B8, dimension2du(pageSize, pageSize));
+			page->fill(SColor(0, 0, 0, 0));
+			pageImages.push_back(page);
+
+			x = 0;
+			y = 0;
+			shelfHeight = 0;
+		}
+
+		// Copy image into page
+		const vector2di position(x + (s32)padding, y + (s32)padding);
+		blit(image, pageImages.back(), position);
+
+		// Store region, whose page is assigned once the textures have been created
+		Region region;
+		region.page = nullptr;
+		region.size = size;
+		region.uv = rectf(
+			(f32)position.X / (f32)pageSize, (f32)position.Y / (f32)pageSize,
+			(f32)(position.X + (s32)size.Width) / (f32)pageSize, (f32)(position.Y + (s32)size.Height) / (f32)pageSize
+		);
+		regions[sources[i].texture] = region;
+		imagePages[i] = (s32)pageImages.size() - 1;
+
+		x += w;
+		shelfHeight = std::max(shelfHeight, h);
+	}
+
+	// Create page textures, without mipmaps since they are drawn at their own size
+	const bool mipMaps = driver->getTextureCreationFlag(ETCF_CREATE_MIP_MAPS);
+	driver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, false);
+
+	const u32 firstPage = (u32)pages.size();
+	for (u32 i = 0; i < pageImages.size(); ++i)
+	{
+		const std::string pageName = name + std::to_string(firstPage + i);
+		pages.push_back(driver->addTexture(pageName.c_str(), pageImages[i]));
+		pageImages[i]->drop();
+	}
+
+	driver->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, mipMaps);
+
+	// Resolve pages of the new regions
+	for (u32 i = 0; i < imagePages.size(); ++i)
+	{
+		if (imagePages[i] >= 0)
+		{
+			regions[sources[i].texture].page = pages[firstPage + imagePages[i]];
+		}
+	}
+
+	// Release images
+	for (IImage* image : images)
+	{
+		if (image != nullptr)
+		{
+			image->drop();
+		}
+	}
+	sources.clear();
+
+	#if NDEBUG || _DEBUG
+	printf("TextureAtlas - %s packed %u textures into %u pages\n", name.c_str(), (u32)regions.size(), (u32)pages.size());
+	#endif
+}
+
+const TextureAtlas::Region* TextureAtlas::getRegion(ITexture* texture)
+{
+	const auto& iterator = regions.find(texture);
+	return iterator != regions.end() ? &iterator->second : nullptr;
+}
+
+u32 TextureAtlas::getPageCount()
+{
+	return (u32)pages.size();
+}
\ No newline at end of file
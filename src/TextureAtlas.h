@@ -0,0 +1,97 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <irrlicht.h>
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+class TextureAtlas
+{
+public:
+
+	// Structure for the area of a packed texture
+	struct Region
+	{
+		ITexture* page;
+		rectf uv;
+		dimension2du size;
+	};
+
+protected:
+
+	// Structure for a texture waiting to be packed
+	struct Source
+	{
+		ITexture* texture;
+		std::string path;
+	};
+
+	// Video driver which owns the pages
+	IVideoDriver* driver;
+
+	// Name prefix for the page textures
+	std::string name;
+
+	// Size of every page, in pixels per side
+	u32 pageSize;
+
+	// Pixels replicated around every packed texture, so bilinear filtering doesn't bleed between neighbours
+	u32 padding;
+
+	// Textures added since the last build
+	std::vector<Source> sources;
+
+	// Page textures
+	std::vector<ITexture*> pages;
+
+	// Map to hold packed areas, by their original texture
+	std::unordered_map<ITexture*, Region> regions;
+
+	/**
+		Copy an image into a page, replicating its border pixels into the padding.
+
+		@param image the image to be copied.
+		@param page the page image.
+		@param position the upper left corner of the image inside the page.
+	*/
+	void blit(IImage* image, IImage* page, const vector2di& position);
+
+public:
+
+	// Constructor and deconstructor
+	TextureAtlas(IVideoDriver* driver, const std::string& name, const u32 pageSize, const u32 padding);
+	~TextureAtlas();
+
+	/**
+		Queue a texture to be packed by the next build.
+
+		@param texture the texture already loaded by the driver, which is used as key for the region.
+		@param path the path of the image file, which is loaded again to read its pixels.
+	*/
+	void add(ITexture* texture, const std::string& path);
+
+	/**
+		Pack all of the queued textures into pages, tallest first, on horizontal shelves.
+		Images which don't fit into an empty page are left out, so they are drawn with their own texture.
+	*/
+	void build();
+
+	/**
+		Get the packed area for a texture.
+
+		@param texture the original texture.
+
+		@return pointer to the region, or "nullptr" if the texture is not in the atlas.
+	*/
+	const Region* getRegion(ITexture* texture);
+
+	// Amount of page textures
+	u32 getPageCount();
+};
+
+#endif // TEXTUREATLAS_H
\ No newline at end of file
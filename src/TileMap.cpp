@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <cmath>
+#include "TileMap.h"
+#include "GameObject.h"
+
+const f32 TileMap::TILE_SIZE = 20.0f;
+const u32 TileMap::MAX_TILES = 1 << 18;
+const u32 TileMap::NO_SPAN = 0xFFFFFFFF;
+
+TileMap::TileMap()
+{
+	clear();
+}
+
+u64 TileMap::getTileKey(const s32 x, const s32 y)
+{
+	return ((u64)(u32)x << 32) | (u64)(u32)y;
+}
+
+s32 TileMap::getTileCoord(const f32 value)
+{
+	// Tiles are centered on multiples of their size
+	return (s32)std::floor((value + TILE_SIZE * 0.5f) / TILE_SIZE);
+}
+
+bool TileMap::getTileRange(const aabbox3df& box, vector2di& minTile, vector2di& maxTile)
+{
+	minTile = vector2di(getTileCoord(box.MinEdge.X), getTileCoord(box.MinEdge.Y)) - origin;
+	maxTile = vector2di(getTileCoord(box.MaxEdge.X), getTileCoord(box.MaxEdge.Y)) - origin;
+
+	if (maxTile.X < 0 || maxTile.Y < 0 || minTile.X >= (s32)width || minTile.Y >= (s32)height)
+	{
+		return false;
+	}
+
+	minTile.X = std::max(minTile.X, 0);
+	minTile.Y = std::max(minTile.Y, 0);
+	maxTile.X = std::min(maxTile.X, (s32)width - 1);
+	maxTile.Y = std::min(maxTile.Y, (s32)height - 1);
+	return true;
+}
+
+void TileMap::mergeRow(const s32 y, const s32 minX, const s32 maxX)
+{
+	for (s32 x = minX; x <= maxX; ++x)
+	{
+		Tile& tile = tiles[y * width + x];
+		if (tile.gameObject == nullptr)
+		{
+			continue;
+		}
+
+		Span span;
+		span.gameObject = tile.gameObject;
+		span.box = tile.box;
+		span.flags = tile.flags;
+		span.queryStamp = 0;
+		tile.span = (u32)spans.size();
+
+		// Extend over the following tiles, as long as neither of them can change
+		while (!(span.flags & TILE_UNMERGEABLE) && x < maxX)
+		{
+			Tile& next = tiles[y * width + x + 1];
+			if (next.gameObject == nullptr || (next.flags & TILE_UNMERGEABLE))
+			{
+				break;
+			}
+			else if (next.box.MinEdge.Z != span.box.MinEdge.Z || next.box.MaxEdge.Z != span.box.MaxEdge.Z)
+			{
+				break;
+			}
+
+			span.box.addInternalBox(next.box);
+			span.flags |= next.flags;
+			next.span = (u32)spans.size();
+			++x;
+		}
+
+		spans.push_back(span);
+	}
+}
+
+void TileMap::clear()
+{
+	origin = vector2di(0);
+	width = 0;
+	height = 0;
+	tiles.clear();
+	spans.clear();
+	pending.clear();
+	built = false;
+	tileCount = 0;
+	queryStamp.reset();
+}
+
+bool TileMap::add(const std::shared_ptr<GameObject>& gameObject, const u8 flags)
+{
+	if (built || gameObject->models.size() == 0)
+	{
+		return false;
+	}
+
+	// Game object must be centered on a tile
+	const vector3df& position = gameObject->position;
+	const s32 x = (s32)std::round(position.X / TILE_SIZE);
+	const s32 y = (s32)std::round(position.Y / TILE_SIZE);
+
+	if (std::abs(position.X - x * TILE_SIZE) > 0.001f || std::abs(position.Y - y * TILE_SIZE) > 0.001f)
+	{
+		return false;
+	}
+
+	// And fill it exactly
+	const aabbox3df& box = gameObject->getWorldBoundingBox();
+	const vector3df extent = box.getExtent();
+	const vector3df center = box.getCenter();
+
+	if (std::abs(extent.X - TILE_SIZE) > 0.001f || std::abs(extent.Y - TILE_SIZE) > 0.001f)
+	{
+		return false;
+	}
+	else if (std::abs(center.X - position.X) > 0.001f || std::abs(center.Y - position.Y) > 0.001f)
+	{
+		return false;
+	}
+
+	// Grid must stay small enough
+	const vector2di minTile = pending.size() ? vector2di(std::min(pendingMin.X, x), std::min(pendingMin.Y, y)) : vector2di(x, y);
+	const vector2di maxTile = pending.size() ? vector2di(std::max(pendingMax.X, x), std::max(pendingMax.Y, y)) : vector2di(x, y);
+
+	if ((u64)(maxTile.X - minTile.X + 1) * (u64)(maxTile.Y - minTile.Y + 1) > MAX_TILES)
+	{
+		return false;
+	}
+
+	// Cell must be still empty
+	Tile tile;
+	tile.gameObject = gameObject;
+	tile.box = box;
+	tile.span = NO_SPAN;
+	tile.flags = flags;
+
+	if (!pending.emplace(getTileKey(x, y), tile).second)
+	{
+		return false;
+	}
+
+	pendingMin = minTile;
+	pendingMax = maxTile;
+	return true;
+}
+
+void TileMap::build()
+{
+	built = true;
+
+	if (pending.size() == 0)
+	{
+		return;
+	}
+
+	// Allocate grid, where tiles are empty by default
+	origin = pendingMin;
+	width = pendingMax.X - pendingMin.X + 1;
+	height = pendingMax.Y - pendingMin.Y + 1;
+
+	Tile empty;
+	empty.gameObject = nullptr;
+	empty.span = NO_SPAN;
+	empty.flags = 0;
+	tiles.assign(width * height, empty);
+
+	// Place added tiles
+	for (const auto& pair : pending)
+	{
+		const s32 x = (s32)(u32)(pair.first >> 32) - origin.X;
+		const s32 y = (s32)(u32)pair.first - origin.Y;
+		tiles[y * width + x] = pair.second;
+	}
+
+	tileCount = (u32)pending.size();
+	pending.clear();
+
+	// Merge rows
+	for (u32 y = 0; y < height; ++y)
+	{
+		mergeRow(y, 0, width - 1);
+	}
+}
+
+bool TileMap::remove(GameObject* gameObject)
+{
+	const s32 x = getTileCoord(gameObject->position.X) - origin.X;
+	const s32 y = getTileCoord(gameObject->position.Y) - origin.Y;
+
+	if (x < 0 || y < 0 || x >= (s32)width || y >= (s32)height)
+	{
+		return false;
+	}
+
+	Tile& tile = tiles[y * width + x];
+	if (tile.gameObject.get() != gameObject)
+	{
+		return false;
+	}
+
+	// Find the tiles sharing the same span
+	const u32 span = tile.span;
+	s32 minX = x;
+	s32 maxX = x;
+
+	while (minX > 0 && tiles[y * width + minX - 1].span == span)
+	{
+		--minX;
+	}
+	while (maxX < (s32)width - 1 && tiles[y * width + maxX + 1].span == span)
+	{
+		++maxX;
+	}
+
+	// Empty the tile, then merge what is left on both sides of it
+	tile.gameObject = nullptr;
+	tile.span = NO_SPAN;
+	tile.flags = 0;
+	spans[span].gameObject = nullptr;
+	--tileCount;
+
+	mergeRow(y, minX, x - 1);
+	mergeRow(y, x + 1, maxX);
+	return true;
+}
+
+const TileMap::Tile* TileMap::getTile(const s32 x, const s32 y)
+{
+	const s32 localX = x - origin.X;
+	const s32 localY = y - origin.Y;
+
+	if (localX < 0 || localY < 0 || localX >= (s32)width || localY >= (s32)height)
+	{
+		return nullptr;
+	}
+
+	const Tile* tile = &tiles[localY * width + localX];
+	return tile->gameObject != nullptr ? tile : nullptr;
+}
+
+void TileMap::querySpans(const aabbox3df& box, std::vector<const Span*>& result)
+{
+	vector2di minTile, maxTile;
+	if (!getTileRange(box, minTile, maxTile))
+	{
+		return;
+	}
+
+	// Start a new query, so spans covering more than one of the tiles are collected once
+	queryStamp.next([this]()
+	{
+		for (Span& span : spans)
+		{
+			span.queryStamp = 0;
+		}
+	});
+
+	for (s32 y = minTile.Y; y <= maxTile.Y; ++y)
+	{
+		for (s32 x = minTile.X; x <= maxTile.X; ++x)
+		{
+			const Tile& tile = tiles[y * width + x];
+			if (tile.gameObject == nullptr)
+			{
+				continue;
+			}
+
+			Span& span = spans[tile.span];
+			if (span.box.intersectsWithBox(box) && queryStamp.mark(span.queryStamp))
+			{
+				result.push_back(&span);
+			}
+		}
+	}
+}
+
+void TileMap::queryTiles(const aabbox3df& box, const u8 flags, std::vector<const Tile*>& result)
+{
+	vector2di minTile, maxTile;
+	if (!getTileRange(box, minTile, maxTile))
+	{
+		return;
+	}
+
+	for (s32 y = minTile.Y; y <= maxTile.Y; ++y)
+	{
+		for (s32 x = minTile.X; x <= maxTile.X; ++x)
+		{
+			const Tile& tile = tiles[y * width + x];
+			if (tile.gameObject != nullptr && (tile.flags & flags) && tile.box.intersectsWithBox(box))
+			{
+				result.push_back(&tile);
+			}
+		}
+	}
+}
+
+u32 TileMap::getTileCount()
+{
+	return tileCount;
+}
+
+u32 TileMap::getSpanCount()
+{
+	u32 count = 0;
+	for (const Span& span : spans)
+	{
+		count += span.gameObject != nullptr ? 1 : 0;
+	}
+	return count;
+}
+
+u32 TileMap::getWidth()
+{
+	return width;
+}
+
+u32 TileMap::getHeight()
+{
+	return height;
+}
\ No newline at end of file
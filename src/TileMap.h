@@ -0,0 +1,166 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+// Flags of a tile, describing the behaviour of its solid block
+#define TILE_BREAKABLE 1
+#define TILE_SPRING 2
+#define TILE_DELAYED 4
+#define TILE_INVISIBLE 8
+
+// Tiles whose solidity or box can change on their own, which are never merged into spans
+#define TILE_UNMERGEABLE (TILE_BREAKABLE | TILE_SPRING | TILE_DELAYED)
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <irrlicht.h>
+
+#include "QueryStamp.h"
+
+using namespace irr;
+using namespace core;
+
+class GameObject;
+
+class TileMap
+{
+public:
+
+	// Structure for a cell of the grid, which is empty when it has no game object
+	struct Tile
+	{
+		std::shared_ptr<GameObject> gameObject;
+		aabbox3df box;
+		u32 span;
+		u8 flags;
+	};
+
+	// Structure for a run of adjacent tiles on the same row, which collide as a single box
+	struct Span
+	{
+		std::shared_ptr<GameObject> gameObject;
+		aabbox3df box;
+		u8 flags;
+		u32 queryStamp;
+	};
+
+protected:
+
+	// Size of every tile, in world units per side, which is the same of a block
+	static const f32 TILE_SIZE;
+
+	// Maximum amount of tiles of the grid, so sparse rooms can't allocate too much memory
+	static const u32 MAX_TILES;
+
+	// Index of spans for empty tiles
+	static const u32 NO_SPAN;
+
+	// Coordinates of the first tile, and size of the grid in tiles
+	vector2di origin;
+	u32 width;
+	u32 height;
+
+	// Tiles of the grid, row by row from the bottom
+	std::vector<Tile> tiles;
+
+	// Spans of the grid. Spans split by a removal are left unused
+	std::vector<Span> spans;
+
+	// Tiles added since the last build, by packed coordinates, with the area they cover
+	std::unordered_map<u64, Tile> pending;
+	vector2di pendingMin;
+	vector2di pendingMax;
+
+	// Grid can't be changed by "add" anymore
+	bool built;
+
+	// Amount of non-empty tiles
+	u32 tileCount;
+
+	// Stamp of the running query, so spans covering more than one tile are collected once
+	QueryStamp queryStamp;
+
+	// Pack tile coordinates into a key
+	static u64 getTileKey(const s32 x, const s32 y);
+
+	// Get the coordinates of the tile holding a point
+	static s32 getTileCoord(const f32 value);
+
+	// Get the tiles covered by a box, clamped to the grid, returning false if the box is outside of it
+	bool getTileRange(const aabbox3df& box, vector2di& minTile, vector2di& maxTile);
+
+	// Build the spans of a range of tiles of a row, in grid coordinates
+	void mergeRow(const s32 y, const s32 minX, const s32 maxX);
+
+public:
+
+	// Constructor
+	TileMap();
+
+	// Remove all of the tiles, so a new room can be added
+	void clear();
+
+	/**
+		Add a game object as a tile, if it fills exactly one cell of the grid and the cell is still empty.
+		Tiles can only be added before "build" is called.
+
+		@param gameObject the game object, which must be already placed in the room.
+		@param flags the "TILE_*" flags describing its behaviour.
+
+		@return true if the game object has become a tile, false if it must collide as a game object.
+	*/
+	bool add(const std::shared_ptr<GameObject>& gameObject, const u8 flags);
+
+	// Allocate the grid for the added tiles, merging adjacent tiles into spans
+	void build();
+
+	/**
+		Remove the tile of a game object, splitting its span.
+
+		@param gameObject the game object.
+
+		@return true if the game object was a tile, false otherwise.
+	*/
+	bool remove(GameObject* gameObject);
+
+	/**
+		Get a tile of the grid, in constant time.
+
+		@param x horizontal coordinate of the tile, which is its position divided by the tile size.
+		@param y vertical coordinate of the tile.
+
+		@return the tile, or "nullptr" if it is empty or outside of the grid.
+	*/
+	const Tile* getTile(const s32 x, const s32 y);
+
+	/**
+		Collect the spans intersecting a box, looking up only the tiles covered by it.
+
+		@param box the world box to look around.
+		@param result the vector where spans are appended, row by row from the bottom left.
+	*/
+	void querySpans(const aabbox3df& box, std::vector<const Span*>& result);
+
+	/**
+		Collect the tiles intersecting a box, having at least one of the given flags.
+
+		@param box the world box to look around.
+		@param flags the "TILE_*" flags to look for.
+		@param result the vector where tiles are appended, row by row from the bottom left.
+	*/
+	void queryTiles(const aabbox3df& box, const u8 flags, std::vector<const Tile*>& result);
+
+	// Amount of non-empty tiles
+	u32 getTileCount();
+
+	// Amount of spans in use
+	u32 getSpanCount();
+
+	// Width of the grid, in tiles
+	u32 getWidth();
+
+	// Height of the grid, in tiles
+	u32 getHeight();
+};
+
+#endif // TILEMAP_H
\ No newline at end of file
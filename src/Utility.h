@@ -150,30 +150,25 @@ public:
 		@param T the data structure where to store the data to. It's required to have a constructor which takes two parameters.
 		@param driver the Irrlicht Video Driver obtained from EngineObject class and subclasses.
 
-		@return vector2d<T> filled with the current window size. If implementation is not found, then a 0-vector is returned.
+		@return vector2d<T> filled with the current window size. If implementation is not found, then the driver screen size is returned.
 	*/
 	template <typename T>
 	static const vector2d<T> getWindowSize(IVideoDriver* driver)
 	{
-		// Get exposed video data
-		const SExposedVideoData evd = driver->getExposedVideoData();
-
 		// Get window size
-		#ifdef __linux__
-		return vector2d<T>((T)(1920, 1080));
-		// Not implemented yet
-
-		#elif _WIN32
+		#ifdef _WIN32
+		const SExposedVideoData evd = driver->getExposedVideoData();
 		HWND hwnd = reinterpret_cast<HWND>(evd.OpenGLWin32.HWnd);
 		RECT lpRect;
-		if (GetClientRect(hwnd, &lpRect))
+		if (hwnd != nullptr && GetClientRect(hwnd, &lpRect))
 		{
 			return vector2d<T>((T)(lpRect.right - lpRect.left), (T)(lpRect.bottom - lpRect.top));
 		}
-
 		#endif
 
-		return vector2d<T>();
+		// Fallback to the size known by the driver, like on Linux or on the null driver
+		const dimension2du screenSize = driver->getScreenSize();
+		return vector2d<T>((T)screenSize.Width, (T)screenSize.Height);
 	}
 
 	/**
@@ -0,0 +1,137 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(u32 threadCount)
+{
+	// Initialize variables
+	generation = 0;
+	activeWorkers = 0;
+	stopping = false;
+	job = nullptr;
+	jobCount = 0;
+	batchSize = 1;
+	nextIndex = 0;
+
+	// Compute amount of threads
+	if (threadCount == 0)
+	{
+		const u32 hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	// Start worker threads
+	for (u32 i = 0; i < threadCount; ++i)
+	{
+		workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	// Wake up all the workers and make them exit
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeCondition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void WorkerPool::runJobs()
+{
+	for (;;)
+	{
+		const u32 first = nextIndex.fetch_add(batchSize);
+		if (first >= jobCount)
+		{
+			return;
+		}
+
+		const u32 last = first + batchSize < jobCount ? first + batchSize : jobCount;
+		for (u32 i = first; i < last; ++i)
+		{
+			(*job)(i);
+		}
+	}
+}
+
+void WorkerPool::workerLoop()
+{
+	u32 seenGeneration = 0;
+
+	for (;;)
+	{
+		// Wait for a new job
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeCondition.wait(lock, [this, seenGeneration]() { return stopping || generation != seenGeneration; });
+
+			if (stopping)
+			{
+				return;
+			}
+			seenGeneration = generation;
+		}
+
+		// Do the work
+		runJobs();
+
+		// Notify the main thread when the last worker has finished
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--activeWorkers == 0)
+			{
+				doneCondition.notify_one();
+			}
+		}
+	}
+}
+
+void WorkerPool::parallelFor(u32 count, const std::function<void(u32)>& job, u32 batchSize)
+{
+	// Nothing to do
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Not worth waking up the workers
+	if (workers.size() == 0 || count <= batchSize)
+	{
+		for (u32 i = 0; i < count; ++i)
+		{
+			job(i);
+		}
+		return;
+	}
+
+	// Publish the job
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = &job;
+		this->jobCount = count;
+		this->batchSize = batchSize;
+		this->nextIndex = 0;
+		activeWorkers = (u32)workers.size();
+		++generation;
+	}
+	wakeCondition.notify_all();
+
+	// The calling thread works too
+	runJobs();
+
+	// Wait for all the workers
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		doneCondition.wait(lock, [this]() { return activeWorkers == 0; });
+		this->job = nullptr;
+	}
+}
+
+u32 WorkerPool::getThreadCount()
+{
+	return (u32)workers.size() + 1;
+}
\ No newline at end of file
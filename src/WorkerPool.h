@@ -0,0 +1,66 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <irrlicht.h>
+
+using namespace irr;
+
+class WorkerPool
+{
+protected:
+
+	// Threads waiting for jobs
+	std::vector<std::thread> workers;
+
+	// Synchronization between the main thread and the workers
+	std::mutex mutex;
+	std::condition_variable wakeCondition;
+	std::condition_variable doneCondition;
+	u32 generation;
+	u32 activeWorkers;
+	bool stopping;
+
+	// Current job
+	const std::function<void(u32)>* job;
+	u32 jobCount;
+	u32 batchSize;
+	std::atomic<u32> nextIndex;
+
+	// Consume job indices until there are no more left
+	void runJobs();
+
+	// Routine executed by each worker thread
+	void workerLoop();
+
+public:
+
+	/**
+		Create the pool and start its threads.
+
+		@param threadCount the amount of worker threads. When 0, one less than the hardware threads is used,
+		since the main thread takes part to the work too.
+	*/
+	WorkerPool(u32 threadCount = 0);
+	~WorkerPool();
+
+	/**
+		Call the job for every index in [0, count), spreading the indices across the worker threads
+		and the calling thread. It returns when all of the indices have been processed.
+
+		@param count the amount of indices.
+		@param job the function to call, which must be safe to be called concurrently.
+		@param batchSize the amount of consecutive indices picked by a thread at once.
+	*/
+	void parallelFor(u32 count, const std::function<void(u32)>& job, u32 batchSize = 8);
+
+	// Amount of threads, including the calling one
+	u32 getThreadCount();
+};
+
+#endif // WORKERPOOL_H
\ No newline at end of file